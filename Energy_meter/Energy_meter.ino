@@ -2,6 +2,7 @@
 #include <ZMPT101B.h>
 #include <LiquidCrystal_I2C.h>
 #include <Keypad.h>
+#include <EnergyAccumulator.h>
 
 #include "commands.h"
 
@@ -42,6 +43,10 @@ ACS712 current_sensor_2(ACS712_05B, CURRENT_SENSOR_PIN_2);
 
 ZMPT101B voltageSensor(VOLTAGE_SENSOR_PIN, 50.0);
 
+// Energy totals are checkpointed to EEPROM so they survive power cuts
+EnergyAccumulator energyMeter(0);
+EnergyAccumulator energyMeter2(256);
+
 float balance = 0;
 float energyConsumed = 0;
 float balance2 = 0;
@@ -58,6 +63,11 @@ void setup() {
 
   ESP_SERIAL.begin(9600);
 
+  energyMeter.begin();
+  energyMeter2.begin();
+  energyConsumed = energyMeter.getWattHours();
+  energyConsumed2 = energyMeter2.getWattHours();
+
   lcd.init();
   lcd.backlight();
 
@@ -198,10 +208,12 @@ void loop() {
   float energyThisLoop = realPower * deltaTimeHours;
   float energyThisLoop2 = realPower2 * deltaTimeHours;
 
-  energyConsumed += energyThisLoop;
+  energyMeter.update(realPower);
+  energyConsumed = energyMeter.getWattHours();
   balance -= energyThisLoop;
 
-  energyConsumed2 += energyThisLoop2;
+  energyMeter2.update(realPower2);
+  energyConsumed2 = energyMeter2.getWattHours();
   balance2 -= energyThisLoop2;
 
   if (balance <= 0) {
@@ -265,8 +277,15 @@ void processCommand(String cmd) {
 
     if (key == CMD_BALANCE) balance = value;
     else if (key == CMD_BALANCE_2) balance2 = value;
-    else if (key == CMD_ENERGY) energyConsumed = value;
-    else if (key == CMD_ENERGY_2) energyConsumed2 = value;
+    else if (key == CMD_ENERGY) {
+      energyMeter.setWattHours(value);
+      energyMeter.checkpoint();
+      energyConsumed = energyMeter.getWattHours();
+    } else if (key == CMD_ENERGY_2) {
+      energyMeter2.setWattHours(value);
+      energyMeter2.checkpoint();
+      energyConsumed2 = energyMeter2.getWattHours();
+    }
   } else {
     if (cmd == CMD_BALANCE) sendCommand(CMD_BALANCE, balance);
     else if (cmd == CMD_BALANCE_2) sendCommand(CMD_BALANCE_2, balance2);
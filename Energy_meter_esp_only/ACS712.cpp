@@ -37,6 +37,10 @@ void ACS712::setSensitivity(float sens) {
 	sensitivity = sens;
 }
 
+float ACS712::getCurrentScale() {
+	return VREF / ADC_SCALE / sensitivity;
+}
+
 float ACS712::getCurrentDC() {
 	float I = (zero - analogRead(pin)) / ADC_SCALE * VREF / sensitivity;
 	return I;
@@ -62,3 +66,18 @@ float ACS712::getCurrentAC(uint16_t frequency) {
 	float Irms = sqrt(Isum / measurements_count) / ADC_SCALE * VREF / sensitivity;
 	return Irms;
 }
+
+float ACS712::getCurrentAC(const uint16_t *samples, uint16_t count) {
+	if (count == 0) return 0;
+
+	uint32_t Isum = 0;
+	int32_t Inow;
+
+	for (uint16_t i = 0; i < count; i++) {
+		Inow = zero - samples[i];
+		Isum += Inow*Inow;
+	}
+
+	float Irms = sqrt(Isum / count) / ADC_SCALE * VREF / sensitivity;
+	return Irms;
+}
@@ -20,6 +20,9 @@ public:
 	float getCurrentDC();
 	float getCurrentAC();
 	float getCurrentAC(uint16_t frequency);
+	float getCurrentAC(const uint16_t *samples, uint16_t count);
+	float getCurrentScale();
+	uint8_t getPin() { return pin; }
 
 private:
 	float zero = 512.0;
@@ -3,6 +3,8 @@
 #include <LiquidCrystal_I2C.h>
 #include "ACS712.h"
 #include <ZMPT101B.h>
+#include <MainsSampler.h>
+#include <EnergyAccumulator.h>
 
 #define PIR_PIN 35   // PIR sensor input
 #define TRIG_PIN 19  // Ultrasonic trigger
@@ -27,6 +29,17 @@ LiquidCrystal_I2C lcd(0x27, 20, 4);
 ACS712 current_sensor(ACS712_05B, CURRENT_SENSOR_PIN);
 ZMPT101B voltageSensor(VOLTAGE_SENSOR_PIN, 50.0);
 
+// Samples both sensors in the background so loop() never waits on a mains period
+MainsSampler sampler;
+const uint8_t samplerPins[] = { VOLTAGE_SENSOR_PIN, CURRENT_SENSOR_PIN };
+#define VOLTAGE_CHANNEL 0
+#define CURRENT_CHANNEL 1
+#define SAMPLE_CYCLES 5
+uint16_t sampleWindow[MAINS_SAMPLER_BUFFER_SIZE];
+
+// Energy total is checkpointed to flash so it survives power cuts
+EnergyAccumulator energyMeter;
+
 const byte ROWS = 4;  //four rows
 const byte COLS = 4;  //three columns
 char keys[ROWS][COLS] = {
@@ -85,6 +98,8 @@ void setup() {
   lcd.print(F("System"));
 
   current_sensor.calibrate();
+  // analogRead() can't be used on these pins once the sampler owns the ADC
+  sampler.begin(samplerPins, 2);
 
   float sensitivity = 0.0f;
   float voltageNow;
@@ -167,10 +182,13 @@ void setup() {
   delay(3000);
   lcd.clear();
 
+  energyMeter.begin();
+  energy_consumption = energyMeter.getWattHours();
 }
 
 void loop() {
   ArduinoCloud.update();
+  sampler.update();
   // Your code here
   
   long distance = getDistance();
@@ -258,7 +276,7 @@ void loop() {
   if (lock) return;
 
   float Vrms = 220;
-  // float Vrms = voltageSensor.getRmsVoltage();
+  // float Vrms = voltageSensor.getRmsVoltage(sampleWindow, sampler.read(VOLTAGE_CHANNEL, sampleWindow, SAMPLE_CYCLES * sampler.samplesPerCycle(50)));
   float Irms = readCurrentWithCheck(current_sensor);
   float realPower = Vrms * Irms;
 
@@ -267,7 +285,8 @@ void loop() {
   lastEnergyUpdate = now;
 
   float energyThisLoop = realPower * deltaTimeHours;
-  energy_consumption += energyThisLoop;
+  energyMeter.update(realPower);
+  energy_consumption = energyMeter.getWattHours();
 
   if (balance > 0) {
     balance -= energyThisLoop;
@@ -329,28 +348,19 @@ void onMessageChange() {
 
 
 float readCurrentWithCheck(ACS712 &sensor) {
-  const int NUM_READINGS = 10;
-  float readings[NUM_READINGS];
+  uint16_t count = SAMPLE_CYCLES * sampler.samplesPerCycle(50);
+  if (count > MAINS_SAMPLER_BUFFER_SIZE) count = MAINS_SAMPLER_BUFFER_SIZE;
 
-  // Take 10 readings
-  for (int i = 0; i < NUM_READINGS; i++) {
-    readings[i] = sensor.getCurrentAC();
-    delay(10);  // Small delay between readings
-  }
+  // RMS over the last few periods captured by the sampler
+  count = sampler.read(CURRENT_CHANNEL, sampleWindow, count);
+  float Irms = sensor.getCurrentAC(sampleWindow, count);
 
-  // Check if any reading is close to zero
-  for (int i = 0; i < NUM_READINGS; i++) {
-    if (readings[i] <= 0.15) {
-      return 0;
-    }
+  // Treat readings close to zero as no load
+  if (Irms <= 0.15) {
+    return 0;
   }
 
-  // Calculate average of readings
-  float sum = 0;
-  for (int i = 0; i < NUM_READINGS; i++) {
-    sum += readings[i];
-  }
-  return sum / NUM_READINGS;
+  return Irms;
 }
 
 // --- Function: Ultrasonic distance ---
@@ -1,6 +1,7 @@
 #include <LiquidCrystal_I2C.h>
 #include <ACS712.h>
 #include <HardwareSerial.h>
+#include <EnergyAccumulator.h>
 
 #define RELAY_PIN 25   // Relay control pin (change as needed)
 #define LOCKED_LED 26  // Optional LED to indicate locked state
@@ -17,6 +18,9 @@ HardwareSerial sim800(1);  // Use UART1 on ESP32
 ACS712 mainSensor(SENSOR_MAIN, 5.0, 1023, 185);  // 185 mV/A for 5A module
 ACS712 bypassSensor(SENSOR_BYPASS, 5.0, 1023, 185);
 
+// Energy total, checkpointed to flash so it survives power cuts
+EnergyAccumulator energyMeter;
+
 // LCD setup
 LiquidCrystal_I2C lcd(0x27, 16, 2);
 
@@ -49,6 +53,8 @@ void setup() {
   mainSensor.calibrate();
   bypassSensor.calibrate();
 
+  energyMeter.begin();
+
   lcd.clear();
 }
 
@@ -59,11 +65,14 @@ void loop() {
 
     // Calculate power consumption (Watts)
     float power = mainCurrent * LINE_VOLTAGE;
+    energyMeter.update(power);
 
+    // Power and the energy total, "1100W 1234.56kWh" fits the 16 columns
     lcd.setCursor(0, 0);
-    lcd.print("Power: ");
-    lcd.print(power, 1);
-    lcd.print(" W   ");
+    lcd.print(power, 0);
+    lcd.print("W ");
+    lcd.print(energyMeter.getKilowattHours(), 2);
+    lcd.print("kWh   ");
 
     lcd.setCursor(0, 1);
     lcd.print("Main:");
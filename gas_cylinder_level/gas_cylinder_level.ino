@@ -3,6 +3,7 @@
 #include <SoftwareSerial.h>
 #include <ESPComm.h>
 #include <HX711.h>
+#include <KickSort.h>
 
 SoftwareSerial _serial(4, 3);
 LiquidCrystal_I2C lcd(0x27, 16, 2);
@@ -35,6 +36,9 @@ HX711 scale;
 float reading;
 float lastReading;
 
+// Median of the last readings rejects knocks on the scale
+KickMedianFilter<float, 5> weightFilter;
+
 #define CALIBRATION_FACTOR -18050
 
 // Gas sensor threshold (adjust experimentally)
@@ -101,7 +105,7 @@ void loop() {
 
   // --- Weight Monitoring ---
   if (scale.wait_ready_timeout(200)) {
-    reading = scale.get_units();  // total weight (kg)
+    reading = weightFilter.filter(scale.get_units());  // total weight (kg)
     float gasWeight = reading - cylinderTare;
 
     if (gasWeight < 0) gasWeight = 0;
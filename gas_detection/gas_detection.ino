@@ -1,8 +1,12 @@
 #include <Wire.h>
 #include <LiquidCrystal.h>
 #include <SoftwareSerial.h>
+#include <Sim800AT.h>
+#include <Sim800SMSQueue.h>
 
 SoftwareSerial gsm(9, 10);
+Sim800AT modem(gsm);
+Sim800SMSQueue smsQueue(modem);
 
 #define GAS A0
 #define BUZZER 8
@@ -11,6 +15,7 @@ SoftwareSerial gsm(9, 10);
 #define RED_LED 12
 
 #define NUMBER "+2349022107944"
+#define ALERT_INTERVAL 10000  // ms between alerts while gas is detected
 
 #define GSM_SERIAL gsm
 
@@ -62,18 +67,8 @@ void gsm_init() {
   lcd.clear();
 }
 
-void send_sms(const char *sms_data, const char *number) {
-  GSM_SERIAL.println("AT+CMGF=1");
-  delay(1000);
-  char num_data[26];
-  sprintf(num_data, "AT+CMGS=\"%s\"", number);
-  GSM_SERIAL.println(num_data);
-  delay(1000);
-  GSM_SERIAL.print(sms_data);
-  delay(1000);
-  GSM_SERIAL.write(26);
-  delay(1000);
-}
+unsigned long lastAlert = 0;
+bool alerted = false;
 
 void setup() {
   GSM_SERIAL.begin(9600);
@@ -83,18 +78,24 @@ void setup() {
   pinMode(RED_LED, OUTPUT);
   lcd.begin(16, 2);
   gsm_init();
+  smsQueue.begin(0);  // alerts not sent yet survive a reset
 }
 
 void loop() {
+  smsQueue.loop();  // sends queued alerts in the background
+
   if (digitalRead(GAS)) {
     digitalWrite(GREEN_LED, LOW);
     digitalWrite(RED_LED, HIGH);
     lcd.setCursor(0, 0);
     lcd.print(F("Gas Detected    "));
     digitalWrite(BUZZER, HIGH);
-    send_sms("GAS Detected.", NUMBER);
-    // send_sms("GAS Detected.", NUMBER_2);
-    delay(10000);
+    if (!alerted || millis() - lastAlert >= ALERT_INTERVAL) {
+      smsQueue.send(NUMBER, "GAS Detected.");
+      // smsQueue.send(NUMBER_2, "GAS Detected.");
+      lastAlert = millis();
+      alerted = true;
+    }
   }
   else {
     digitalWrite(GREEN_LED, HIGH);
@@ -102,5 +103,6 @@ void loop() {
     lcd.setCursor(0, 0);
     lcd.print(F("Gas Not Detected"));
     digitalWrite(BUZZER, LOW);
+    alerted = false;
   }
 }
\ No newline at end of file
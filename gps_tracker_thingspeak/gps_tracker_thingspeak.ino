@@ -1,4 +1,5 @@
 #include <TinyGPS++.h>
+#include <GPSTrack.h>
 #include <SoftwareSerial.h>
 #include <LiquidCrystal.h>
 
@@ -15,6 +16,13 @@ SoftwareSerial _serial(RXPin, TXPin);
 
 unsigned long previous_millis = 0;
 
+// Only the points the track needs within 10 m are sent, plus one every
+// 5 minutes while parked. ThingSpeak takes an update every 15 s at most; a
+// point kept before the previous one went out replaces it.
+TrackSimplifier track(10, 300);
+TrackPoint unsent;
+bool hasUnsent = false;
+
 void setup() {
   lcd.begin(16, 2);
 
@@ -35,17 +43,22 @@ void loop() {
     gps.encode(gpsSerial.read());
   }
 
-  if (gps.location.isValid() && millis() - previous_millis > 30000) {
-    double lat = gps.location.lat();
-    double lon = gps.location.lng();
+  bool updated = gps.location.isUpdated();
+  TrackPoint point;
+  if (updated && getTrackPoint(gps, point) && track.add(point)) {
+    unsent = track.point();
+    hasUnsent = true;
+  }
 
-    sendCommand("lon", lon);
+  if (hasUnsent && millis() - previous_millis > 15000) {
+    sendCommand("lon", unsent.lng / 1e7);
     delay(200);
-    sendCommand("lat", lat);
+    sendCommand("lat", unsent.lat / 1e7);
+    hasUnsent = false;
     previous_millis = millis();
   }
 
-  if (gps.location.isUpdated() && gps.location.isValid()) {
+  if (updated && gps.location.isValid()) {
     double lat = gps.location.lat();
     double lon = gps.location.lng();
 
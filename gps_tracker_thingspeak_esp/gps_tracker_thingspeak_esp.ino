@@ -14,6 +14,7 @@ unsigned long myChannelNumber = 1978416;
 const char* myWriteAPIKey = myAPI;
 
 unsigned long prevMillis = 0;
+bool fresh = false;  // a point arrived since the last write
 
 void setup() {
   // put your setup code here, to run once:
@@ -37,8 +38,10 @@ void loop() {
     processCommand(command);
   }
 
-  if (millis() - prevMillis > 30000 && lat != 0.0 && lon != 0.0) {
+  // the tracker only sends points when it moves; ThingSpeak allows a write every 15 s
+  if (fresh && millis() - prevMillis > 15000 && lat != 0.0 && lon != 0.0) {
     ThingSpeak.writeFields(myChannelNumber, myWriteAPIKey);
+    fresh = false;
 
     prevMillis = millis();
   }
@@ -53,6 +56,7 @@ void processCommand(String cmd) {
 
     if (key == "lat") {
       lat = value;
+      fresh = true;  // lat comes after lon
       ThingSpeak.setField(1, static_cast<float>(value));
     } else if (key == "lon") {
       lon = value;
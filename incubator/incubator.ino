@@ -42,6 +42,8 @@ unsigned long lastTurnMillis = 0;
 const unsigned long TURN_INTERVAL = 10000;  // 6 hours
 // const unsigned long TURN_INTERVAL = 6UL * 60UL * 60UL * 1000UL;  // 6 hours
 unsigned long lastDisplay = 0;
+float temp = NAN;
+float hum = NAN;
 
 void setup() {
   Serial.begin(9600);
@@ -66,8 +68,15 @@ void setup() {
 }
 
 void loop() {
-  float temp = dht.readTemperature();
-  float hum = dht.readHumidity();
+  // Read the DHT in the background instead of stopping for 25 ms every loop
+  dht.startRead();
+  uint8_t result = dht.poll();
+  if (result == DHT_READ_OK) {
+    temp = dht.readTemperature();
+    hum = dht.readHumidity();
+  } else if (result != DHT_READ_BUSY && result != DHT_READ_IDLE) {
+    temp = hum = NAN;
+  }
 
   if (millis() - lastDisplay > 2000) {
     lcd.clear();
@@ -37,13 +37,17 @@ void ACS712::setSensitivity(float sens) {
 	sensitivity = sens;
 }
 
+float ACS712::getCurrentScale() {
+	return ACS712_VREF / ACS712_ADC_SCALE / sensitivity;
+}
+
 float ACS712::getCurrentDC() {
-	float I = (zero - analogRead(pin)) / ADC_SCALE * VREF / sensitivity;
+	float I = (zero - analogRead(pin)) / ACS712_ADC_SCALE * ACS712_VREF / sensitivity;
 	return I;
 }
 
 float ACS712::getCurrentAC() {
-	return getCurrentAC(DEFAULT_FREQUENCY);
+	return getCurrentAC(ACS712_DEFAULT_FREQUENCY);
 }
 
 float ACS712::getCurrentAC(uint16_t frequency) {
@@ -59,6 +63,21 @@ float ACS712::getCurrentAC(uint16_t frequency) {
 		measurements_count++;
 	}
 
-	float Irms = sqrt(Isum / measurements_count) / ADC_SCALE * VREF / sensitivity;
+	float Irms = sqrt(Isum / measurements_count) / ACS712_ADC_SCALE * ACS712_VREF / sensitivity;
+	return Irms;
+}
+
+float ACS712::getCurrentAC(const uint16_t *samples, uint16_t count) {
+	if (count == 0) return 0;
+
+	uint32_t Isum = 0;
+	int32_t Inow;
+
+	for (uint16_t i = 0; i < count; i++) {
+		Inow = zero - samples[i];
+		Isum += Inow*Inow;
+	}
+
+	float Irms = sqrt(Isum / count) / ACS712_ADC_SCALE * ACS712_VREF / sensitivity;
 	return Irms;
 }
@@ -3,9 +3,9 @@
 
 #include <Arduino.h>
 
-#define ADC_SCALE 1023.0
-#define VREF 5.0
-#define DEFAULT_FREQUENCY 50
+#define ACS712_ADC_SCALE 1023.0
+#define ACS712_VREF 5.0
+#define ACS712_DEFAULT_FREQUENCY 50
 
 enum ACS712_type {ACS712_05B, ACS712_20A, ACS712_30A};
 
@@ -18,6 +18,9 @@ public:
 	float getCurrentDC();
 	float getCurrentAC();
 	float getCurrentAC(uint16_t frequency);
+	float getCurrentAC(const uint16_t *samples, uint16_t count);
+	float getCurrentScale();
+	uint8_t getPin() { return pin; }
 
 private:
 	float zero = 512.0;
@@ -0,0 +1,11 @@
+// Minimal Arduino stand-in for running Average.h on a desktop machine.
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#endif
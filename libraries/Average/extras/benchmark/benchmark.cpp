@@ -0,0 +1,75 @@
+// Host benchmark comparing Average<T>, RunningAverage<T> and
+// StaticAverage<T, N>. Build and run with ./run.sh.
+//
+// For each window size the memory used by each variant is printed (object
+// plus heap) along with the time per push() followed by one statistic, on a
+// stream of pseudo random int values.
+
+#include <chrono>
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "../../src/Average.h"
+
+#define PUSHES 200000
+
+static int values[PUSHES];
+static volatile float sink;
+
+template <class A> static double timePush(A &a)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int k = 0; k < PUSHES; k++)
+		a.push(values[k]);
+	sink = a.mean();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / PUSHES;
+}
+
+template <class A, class F> static double timeStat(A &a, F stat)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int k = 0; k < PUSHES; k++)
+	{
+		a.push(values[k]);
+		sink = stat(a);
+	}
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / PUSHES;
+}
+
+template <class A> static void row(const char *name, A &a, size_t bytes)
+{
+	double push = timePush(a);
+	double minimum = timeStat(a, [](A &x) { return (float)x.minimum(); });
+	double stddev = timeStat(a, [](A &x) { return x.stddev(); });
+	double trend = timeStat(a, [](A &x) { float m, c, r; x.leastSquares(m, c, r); return m; });
+	printf("  %-20s %6zu bytes  push %6.1f ns  +minimum %7.1f ns  +stddev %7.1f ns  +leastSquares %7.1f ns\n",
+		name, bytes, push, minimum, stddev, trend);
+}
+
+template <uint32_t N> static void run()
+{
+	printf("window %u\n", N);
+
+	Average<int> dynamic(N);
+	row("Average<int>", dynamic, sizeof(dynamic) + N * sizeof(int));
+
+	RunningAverage<int> running(N);
+	row("RunningAverage<int>", running, sizeof(running) + N * (sizeof(int) + 2 * sizeof(uint16_t)));
+
+	static StaticAverage<int, N> fixed;
+	row("StaticAverage<int,N>", fixed, sizeof(fixed));
+}
+
+int main()
+{
+	srand(1);
+	for (int k = 0; k < PUSHES; k++)
+		values[k] = rand() % 1024;
+
+	run<16>();
+	run<64>();
+	run<100>();
+	run<256>();
+
+	return 0;
+}
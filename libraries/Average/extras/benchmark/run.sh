@@ -0,0 +1,7 @@
+#!/bin/sh
+# Builds the Average benchmark and runs it.
+set -e
+cd "$(dirname "$0")"
+g++ -O2 -std=gnu++14 -I. -DARDUINO=100 -o average_benchmark benchmark.cpp
+./average_benchmark
+rm -f average_benchmark
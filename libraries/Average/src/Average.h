@@ -304,4 +304,561 @@ template <class T> Average<T> &Average<T>::operator=(Average<T> &a) {
     return *this;
 }
 
+// RunningAverage<T> keeps the same statistics as Average<T> up to date in
+// push(), so mean(), stddev(), minimum(), maximum() and leastSquares() no
+// longer walk the whole buffer:
+//
+//  - mean and variance use Welford's update, with the oldest value removed
+//    again once the window is full;
+//  - minimum and maximum come from monotonic deques of buffer slots;
+//  - least squares keeps the sum of index * value and shifts it as the
+//    window slides.
+//
+// The running sums are rebuilt from the buffer every time the write
+// position wraps, so float rounding can't build up and push() stays O(1)
+// amortised. It needs two uint16_t slot indexes per entry on top of the
+// values, so the window is limited to 65535 entries.
+//
+// leastSquares() and predict() follow Average<T>: m is the negated slope,
+// c the intercept, so the two classes can be swapped.
+
+template <class T> class RunningAverage {
+    private:
+        T *_store;
+        uint16_t *_minq;                                      // slots of ascending values, oldest first
+        uint16_t *_maxq;                                      // slots of descending values, oldest first
+        T _sum;
+        float _mean;                                          // Welford mean
+        float _m2;                                            // Welford sum of squared differences
+        float _sxy;                                           // sum of index * value
+        uint16_t _minHead, _minCount;
+        uint16_t _maxHead, _maxCount;
+        uint32_t _position;
+        uint32_t _count;
+        uint32_t _size;
+
+        uint32_t slot(uint32_t index);
+        void expire(uint16_t *queue, uint16_t &head, uint16_t &count);
+        void insertMin(uint16_t position);
+        void insertMax(uint16_t position);
+        void resync();
+
+    public:
+        RunningAverage(uint32_t size);
+        ~RunningAverage();
+        float rolling(T entry);
+        void push(T entry);
+        float mean();
+        T mode();
+        T minimum();
+        T minimum(int *);
+        T maximum();
+        T maximum(int *);
+        float stddev();
+        float variance();
+        T get(uint32_t);
+        void leastSquares(float &m, float &b, float &r);
+        int getCount();
+        T predict(int x);
+        T sum();
+        void clear();
+};
+
+template <class T> RunningAverage<T>::RunningAverage(uint32_t size) {
+    if (size > 65535) size = 65535;
+    if (size == 0) size = 1;
+    _size = size;
+    _store = (T *)malloc(sizeof(T) * size);
+    _minq = (uint16_t *)malloc(sizeof(uint16_t) * size);
+    _maxq = (uint16_t *)malloc(sizeof(uint16_t) * size);
+    for (uint32_t i = 0; i < size; i++) {
+        _store[i] = 0;
+    }
+    clear();
+}
+
+template <class T> RunningAverage<T>::~RunningAverage() {
+    free(_store);
+    free(_minq);
+    free(_maxq);
+}
+
+template <class T> void RunningAverage<T>::clear() {
+    _count = 0;
+    _position = 0;
+    _sum = 0;
+    _mean = 0;
+    _m2 = 0;
+    _sxy = 0;
+    _minHead = _minCount = 0;
+    _maxHead = _maxCount = 0;
+}
+
+template <class T> int RunningAverage<T>::getCount() {
+    return _count;
+}
+
+// Buffer slot of the index'th oldest entry.
+template <class T> uint32_t RunningAverage<T>::slot(uint32_t index) {
+    int32_t start = _position - _count;
+    if (start < 0) start += _size;
+    uint32_t cindex = start + index;
+    if (cindex >= _size) cindex -= _size;
+    return cindex;
+}
+
+// Drop the front of a deque if it is the slot about to be overwritten.
+template <class T> void RunningAverage<T>::expire(uint16_t *queue, uint16_t &head, uint16_t &count) {
+    if (count > 0 && queue[head] == _position) {
+        head = (head + 1 < _size) ? head + 1 : 0;
+        count--;
+    }
+}
+
+// Values larger than the new one can never be the minimum again. Equal
+// ones stay, so the front is the oldest occurrence like Average::minimum().
+template <class T> void RunningAverage<T>::insertMin(uint16_t position) {
+    while (_minCount > 0) {
+        uint32_t back = _minHead + _minCount - 1;
+        if (back >= _size) back -= _size;
+        if (_store[_minq[back]] <= _store[position]) break;
+        _minCount--;
+    }
+    uint32_t tail = _minHead + _minCount;
+    if (tail >= _size) tail -= _size;
+    _minq[tail] = position;
+    _minCount++;
+}
+
+template <class T> void RunningAverage<T>::insertMax(uint16_t position) {
+    while (_maxCount > 0) {
+        uint32_t back = _maxHead + _maxCount - 1;
+        if (back >= _size) back -= _size;
+        if (_store[_maxq[back]] >= _store[position]) break;
+        _maxCount--;
+    }
+    uint32_t tail = _maxHead + _maxCount;
+    if (tail >= _size) tail -= _size;
+    _maxq[tail] = position;
+    _maxCount++;
+}
+
+template <class T> void RunningAverage<T>::push(T entry) {
+    float x = entry;
+
+    if (_count < _size) {                                     // window still growing
+        _sxy += (float)_count * x;
+        _count++;
+        _sum += entry;
+        float delta = x - _mean;
+        _mean += delta / (float)_count;
+        _m2 += delta * (x - _mean);
+    } else {                                                  // oldest entry leaves the window
+        T old = _store[_position];
+        float y = old;
+        expire(_minq, _minHead, _minCount);
+        expire(_maxq, _maxHead, _maxCount);
+        // Every remaining entry moves down one index.
+        _sxy = _sxy - ((float)_sum - y) + (float)(_count - 1) * x;
+        _sum = _sum - old + entry;
+        float mean = _mean + (x - y) / (float)_count;
+        _m2 += (x - y) * (x - mean + y - _mean);
+        _mean = mean;
+    }
+
+    _store[_position] = entry;
+    insertMin(_position);
+    insertMax(_position);
+
+    _position += 1;
+    if (_position >= _size) {
+        _position = 0;
+        resync();
+    }
+}
+
+// Recalculate the running sums from the buffer. Called once per _size
+// pushes, so it doesn't change the amortised cost of push().
+template <class T> void RunningAverage<T>::resync() {
+    T sum = 0;
+    float sxy = 0;
+    for (uint32_t i = 0; i < _count; i++) {
+        T value = _store[slot(i)];
+        sum += value;
+        sxy += (float)i * (float)value;
+    }
+    float mean = (float)sum / (float)_count;
+    float m2 = 0;
+    for (uint32_t i = 0; i < _count; i++) {
+        m2 += sqr((float)_store[slot(i)] - mean);
+    }
+    _sum = sum;
+    _mean = mean;
+    _m2 = m2;
+    _sxy = sxy;
+}
+
+template <class T> float RunningAverage<T>::rolling(T entry) {
+    push(entry);
+    return mean();
+}
+
+template <class T> float RunningAverage<T>::mean() {
+    if (_count == 0) {
+        return 0;
+    }
+    return _mean;
+}
+
+template <class T> float RunningAverage<T>::variance() {
+    if (_count == 0 || _m2 <= 0) {
+        return 0;
+    }
+    return _m2 / (float)_count;
+}
+
+template <class T> float RunningAverage<T>::stddev() {
+    return sqrt(variance());
+}
+
+template <class T> T RunningAverage<T>::minimum() {
+    return minimum(NULL);
+}
+
+template <class T> T RunningAverage<T>::minimum(int *index) {
+    if (index != NULL) {
+        *index = 0;
+    }
+    if (_count == 0) {
+        return 0;
+    }
+    uint16_t position = _minq[_minHead];
+    if (index != NULL) {
+        *index = (position + _size - slot(0)) % _size;
+    }
+    return _store[position];
+}
+
+template <class T> T RunningAverage<T>::maximum() {
+    return maximum(NULL);
+}
+
+template <class T> T RunningAverage<T>::maximum(int *index) {
+    if (index != NULL) {
+        *index = 0;
+    }
+    if (_count == 0) {
+        return 0;
+    }
+    uint16_t position = _maxq[_maxHead];
+    if (index != NULL) {
+        *index = (position + _size - slot(0)) % _size;
+    }
+    return _store[position];
+}
+
+template <class T> T RunningAverage<T>::get(uint32_t index) {
+    if (index >= _count) {
+        return -1;
+    }
+    return _store[slot(index)];
+}
+
+// Same algorithm as Average<T>::mode(), O(n^2).
+template <class T> T RunningAverage<T>::mode() {
+    if (_count == 0) {
+        return 0;
+    }
+
+    T most = get(0);
+    uint32_t mostcount = 1;
+    for (uint32_t pos = 0; pos < _count; pos++) {
+        T current = get(pos);
+        uint32_t currentcount = 1;
+        for (uint32_t inner = pos + 1; inner < _count; inner++) {
+            if (get(inner) == current) {
+                currentcount++;
+            }
+        }
+        if (currentcount > mostcount) {
+            most = current;
+            mostcount = currentcount;
+        }
+        if (_count - pos < mostcount) {
+            break;
+        }
+    }
+    return most;
+}
+
+// Fit y = slope * x + c with x = 0 for the oldest entry, m = -slope as in
+// Average<T>. The sums over x have closed forms, the others are kept by push().
+template <class T> void RunningAverage<T>::leastSquares(float &m, float &c, float &r) {
+    if (_count < 2) {
+        m = 0;
+        c = 0;
+        r = 0;
+        return;
+    }
+
+    float n = _count;
+    float sumx = n * (n - 1) / 2;
+    float sxx = n * (n * n - 1) / 12;                         // sum of (x - mean x)^2
+    float sxy = _sxy - sumx * (float)_sum / n;                // sum of (x - mean x)(y - mean y)
+    float slope = sxy / sxx;
+
+    m = -slope;
+    c = ((float)_sum - slope * sumx) / n;
+    r = (_m2 > 0) ? sxy / sqrt(sxx * _m2) : 0;
+}
+
+template <class T> T RunningAverage<T>::predict(int x) {
+    float m, c, r;
+    leastSquares(m, c, r); // y = mx + c;
+
+    T y = m * x + c;
+    return y;
+}
+
+template <class T> T RunningAverage<T>::sum() {
+    return _sum;
+}
+
+// StaticAverage<T, N> is an Average<T> whose N entries are stored inside
+// the object instead of on the heap, so it can be a global, a member or a
+// local without new/malloc and is copied with a plain assignment. When N is
+// a power of two the circular index wraps with a mask. The index type is the
+// smallest one that holds N.
+//
+// With C++14 or later, push(), get() and the statistics are constexpr, so a
+// StaticAverage can be filled and evaluated at compile time. leastSquares()
+// and predict() follow Average<T>: m is the negated slope.
+
+#if __cplusplus >= 201402L
+# define AVERAGE_CONSTEXPR constexpr
+#else
+# define AVERAGE_CONSTEXPR
+#endif
+
+template <uint32_t N, bool Byte = (N < 256), bool Word = (N < 65536)> struct AverageIndex {
+    typedef uint32_t type;
+};
+
+template <uint32_t N> struct AverageIndex<N, false, true> {
+    typedef uint16_t type;
+};
+
+template <uint32_t N> struct AverageIndex<N, true, true> {
+    typedef uint8_t type;
+};
+
+template <class T, uint32_t N> class StaticAverage {
+    static_assert(N > 0, "StaticAverage needs at least one entry");
+
+    private:
+        typedef typename AverageIndex<N>::type index_t;
+
+        T _store[N];
+        T _sum;
+        index_t _position;
+        index_t _count;
+
+        static constexpr bool powerOfTwo() {
+            return (N & (N - 1)) == 0;
+        }
+
+        // i is below 2 * N
+        static constexpr uint32_t wrap(uint32_t i) {
+            return powerOfTwo() ? (i & (N - 1)) : (i >= N ? i - N : i);
+        }
+
+        constexpr uint32_t slot(uint32_t index) const {
+            return powerOfTwo() ? ((uint32_t)_position - _count + index) & (N - 1)
+                                : wrap((uint32_t)_position + N - _count + index);
+        }
+
+    public:
+        constexpr StaticAverage() : _store(), _sum(0), _position(0), _count(0) {}
+
+        AVERAGE_CONSTEXPR void push(T entry);
+        AVERAGE_CONSTEXPR float rolling(T entry);
+        AVERAGE_CONSTEXPR void clear();
+
+        constexpr float mean() const {
+            return _count == 0 ? 0 : (float)_sum / (float)_count;
+        }
+        constexpr T sum() const {
+            return _sum;
+        }
+        constexpr int getCount() const {
+            return _count;
+        }
+        constexpr uint32_t size() const {
+            return N;
+        }
+        constexpr T get(uint32_t index) const {
+            return index >= _count ? (T)-1 : _store[slot(index)];
+        }
+
+        AVERAGE_CONSTEXPR T mode() const;
+        AVERAGE_CONSTEXPR T minimum() const;
+        AVERAGE_CONSTEXPR T minimum(int *) const;
+        AVERAGE_CONSTEXPR T maximum() const;
+        AVERAGE_CONSTEXPR T maximum(int *) const;
+        AVERAGE_CONSTEXPR float variance() const;
+        float stddev() const;
+        void leastSquares(float &m, float &b, float &r) const;
+        T predict(int x) const;
+};
+
+template <class T, uint32_t N> AVERAGE_CONSTEXPR void StaticAverage<T, N>::push(T entry) {
+    if (_count < N) {
+        _count++;
+    } else {
+        _sum = _sum - _store[_position];
+    }
+    _store[_position] = entry;
+    _sum += entry;
+    _position = wrap((uint32_t)_position + 1);
+}
+
+template <class T, uint32_t N> AVERAGE_CONSTEXPR float StaticAverage<T, N>::rolling(T entry) {
+    push(entry);
+    return mean();
+}
+
+template <class T, uint32_t N> AVERAGE_CONSTEXPR void StaticAverage<T, N>::clear() {
+    _count = 0;
+    _sum = 0;
+    _position = 0;
+}
+
+// Same algorithm as Average<T>::mode(), O(n^2).
+template <class T, uint32_t N> AVERAGE_CONSTEXPR T StaticAverage<T, N>::mode() const {
+    if (_count == 0) {
+        return 0;
+    }
+
+    T most = get(0);
+    uint32_t mostcount = 1;
+    for (uint32_t pos = 0; pos < _count; pos++) {
+        T current = get(pos);
+        uint32_t currentcount = 1;
+        for (uint32_t inner = pos + 1; inner < _count; inner++) {
+            if (get(inner) == current) {
+                currentcount++;
+            }
+        }
+        if (currentcount > mostcount) {
+            most = current;
+            mostcount = currentcount;
+        }
+        if (_count - pos < mostcount) {
+            break;
+        }
+    }
+    return most;
+}
+
+template <class T, uint32_t N> AVERAGE_CONSTEXPR T StaticAverage<T, N>::minimum() const {
+    return minimum(NULL);
+}
+
+template <class T, uint32_t N> AVERAGE_CONSTEXPR T StaticAverage<T, N>::minimum(int *index) const {
+    if (index != NULL) {
+        *index = 0;
+    }
+    if (_count == 0) {
+        return 0;
+    }
+
+    T minval = get(0);
+    for (uint32_t i = 1; i < _count; i++) {
+        T value = get(i);
+        if (value < minval) {
+            minval = value;
+            if (index != NULL) {
+                *index = i;
+            }
+        }
+    }
+    return minval;
+}
+
+template <class T, uint32_t N> AVERAGE_CONSTEXPR T StaticAverage<T, N>::maximum() const {
+    return maximum(NULL);
+}
+
+template <class T, uint32_t N> AVERAGE_CONSTEXPR T StaticAverage<T, N>::maximum(int *index) const {
+    if (index != NULL) {
+        *index = 0;
+    }
+    if (_count == 0) {
+        return 0;
+    }
+
+    T maxval = get(0);
+    for (uint32_t i = 1; i < _count; i++) {
+        T value = get(i);
+        if (value > maxval) {
+            maxval = value;
+            if (index != NULL) {
+                *index = i;
+            }
+        }
+    }
+    return maxval;
+}
+
+template <class T, uint32_t N> AVERAGE_CONSTEXPR float StaticAverage<T, N>::variance() const {
+    if (_count == 0) {
+        return 0;
+    }
+
+    float mu = mean();
+    float sum = 0;
+    for (uint32_t i = 0; i < _count; i++) {
+        float theta = mu - (float)get(i);
+        sum += theta * theta;
+    }
+    return sum / (float)_count;
+}
+
+template <class T, uint32_t N> float StaticAverage<T, N>::stddev() const {
+    return sqrt(variance());
+}
+
+template <class T, uint32_t N> void StaticAverage<T, N>::leastSquares(float &m, float &c, float &r) const {
+    if (_count < 2) {
+        m = 0;
+        c = 0;
+        r = 0;
+        return;
+    }
+
+    float sumxy = 0;
+    for (uint32_t i = 0; i < _count; i++) {
+        sumxy += (float)i * (float)get(i);
+    }
+
+    float n = _count;
+    float sumx = n * (n - 1) / 2;
+    float sxx = n * (n * n - 1) / 12;                         // sum of (x - mean x)^2
+    float sxy = sumxy - sumx * (float)_sum / n;               // sum of (x - mean x)(y - mean y)
+    float syy = variance() * n;                               // sum of (y - mean y)^2
+    float slope = sxy / sxx;
+
+    m = -slope;
+    c = ((float)_sum - slope * sumx) / n;
+    r = (syy > 0) ? sxy / sqrt(sxx * syy) : 0;
+}
+
+template <class T, uint32_t N> T StaticAverage<T, N>::predict(int x) const {
+    float m, c, r;
+    leastSquares(m, c, r); // y = mx + c;
+
+    T y = m * x + c;
+    return y;
+}
+
 #endif
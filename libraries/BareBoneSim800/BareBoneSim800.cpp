@@ -40,24 +40,33 @@
  #include "AltSoftSerial.h"
  #include "BareBoneSim800.h"
  
+ AltSoftSerial gsmSerial;
+ 
  // Initialize the constructors
- BareBoneSim800::BareBoneSim800()
+ BareBoneSim800::BareBoneSim800() : _at(gsmSerial)
  {
+	 _smsSentCallback = NULL;
+	 _newSMSCallback = NULL;
+	 _smsReference = -1;
  }
  
- BareBoneSim800::BareBoneSim800(const char* networkAPN){
+ BareBoneSim800::BareBoneSim800(const char* networkAPN) : _at(gsmSerial){
 	 _networkAPN = networkAPN;
 	 _userName = "";
 	 _passWord = "";
+	 _smsSentCallback = NULL;
+	 _newSMSCallback = NULL;
+	 _smsReference = -1;
  }
  
- BareBoneSim800::BareBoneSim800(const char* networkAPN, const char* userName, const char* passWord){
+ BareBoneSim800::BareBoneSim800(const char* networkAPN, const char* userName, const char* passWord) : _at(gsmSerial){
 	 _networkAPN = networkAPN;
 	 _userName = userName;
 	 _passWord = passWord;
+	 _smsSentCallback = NULL;
+	 _newSMSCallback = NULL;
+	 _smsReference = -1;
  }
-
-AltSoftSerial gsmSerial;
  
  
  // 
@@ -558,3 +567,76 @@ void BareBoneSim800::closeHTTP()
 }
 
 	
+
+
+//
+// NON-BLOCKING METHODS
+//
+void BareBoneSim800::loop()
+{
+	_at.loop();
+}
+
+Sim800AT &BareBoneSim800::at()
+{
+	return _at;
+}
+
+void BareBoneSim800::onSMSSent(void (*callback)(bool sent, int reference))
+{
+	_smsSentCallback = callback;
+}
+
+bool BareBoneSim800::sendSMSAsync(const char* number, const char* text)
+{
+	// Same commands as sendSMS(), queued instead of waited for:
+	// AT+CMGF=1, then AT+CMGS="number" with the text after the prompt.
+	// The result goes to the onSMSSent() callback with the +CMGS reference.
+	char command[SIM800_AT_COMMAND_LENGTH];
+	if (strlen(number) + 11 > sizeof(command))
+		return false;
+	if (_at.pending() + 2 > SIM800_AT_QUEUE_SIZE)
+		return false;
+	strcpy_P(command, PSTR("AT+CMGS=\""));
+	strcat(command, number);
+	strcat(command, "\"");
+	_at.send(F("AT+CMGF=1"));
+	return _at.send(command, _onSMSResult, this, 60000, text);
+}
+
+bool BareBoneSim800::onNewSMS(void (*callback)(int index))
+{
+	// AT+CNMI=2,1 makes the module announce every stored sms with
+	// +CMTI: "SM",<index> instead of us polling AT+CMGL
+	bool first = _newSMSCallback == NULL;
+	_newSMSCallback = callback;
+	if (first && !_at.onURC("+CMTI:", _onNewSMSIndication, this))
+		return false;
+	return _at.send(F("AT+CNMI=2,1,0,0,0"));
+}
+
+void BareBoneSim800::_onSMSResult(void *context, uint8_t event, const char *line)
+{
+	BareBoneSim800 *sim = (BareBoneSim800 *)context;
+	if (event == SIM800_AT_LINE)
+	{
+		if (strncmp_P(line, PSTR("+CMGS:"), 6) == 0)
+			sim->_smsReference = atoi(line + 6);
+		return;
+	}
+	int reference = sim->_smsReference;
+	sim->_smsReference = -1;
+	if (sim->_smsSentCallback != NULL)
+		sim->_smsSentCallback(event == SIM800_AT_OK, reference);
+}
+
+void BareBoneSim800::_onNewSMSIndication(void *context, const char *line)
+{
+	BareBoneSim800 *sim = (BareBoneSim800 *)context;
+	const char *index = strrchr(line, ',');
+	if (index == NULL)
+		return;
+	sim->currentMessageIndex = atoi(index + 1);
+	if (sim->_newSMSCallback != NULL)
+		sim->_newSMSCallback(sim->currentMessageIndex);
+}
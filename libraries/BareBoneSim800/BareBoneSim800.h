@@ -50,6 +50,7 @@
  
  #include "AltSoftSerial.h"
  #include "Arduino.h"
+ #include "Sim800AT.h"
  
  #define RX_PIN 8		//not needed since the AltSoftSerial has already define it inside
  #define TX_PIN 9
@@ -106,6 +107,14 @@
 	   void _enableBearerProfile();
 	   void _disableBearerProfile();
 	   
+	   // non-blocking interface
+	   Sim800AT _at;
+	   void (*_smsSentCallback)(bool sent, int reference);
+	   void (*_newSMSCallback)(int index);
+	   int _smsReference;
+	   static void _onSMSResult(void *context, uint8_t event, const char *line);
+	   static void _onNewSMSIndication(void *context, const char *line);
+	   
 
 	 public:
 	 
@@ -146,6 +155,14 @@
 	 String sendHTTPData(char* data);
 	 void closeHTTP();
 	 
+	 // Non-blocking interface, loop() must be called as often as possible.
+	 // Don't mix it with the blocking functions above while at() is busy.
+	 void loop();
+	 Sim800AT &at(); // the AT engine, to queue your own commands
+	 void onSMSSent(void (*callback)(bool sent, int reference));
+	 bool sendSMSAsync(const char* number, const char* text); // text must stay valid until onSMSSent
+	 bool onNewSMS(void (*callback)(int index)); // +CMTI indications
+	 
  };
  
  #endif
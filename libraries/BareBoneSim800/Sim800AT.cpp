@@ -0,0 +1,233 @@
+/*    Non-blocking AT command engine for the SIM800
+ *    See Sim800AT.h for how responses are sorted.
+ */
+
+#include "Arduino.h"
+#include "Sim800AT.h"
+
+ Sim800AT::Sim800AT(Stream &serial)
+ {
+	 _serial = &serial;
+	 _head = 0;
+	 _count = 0;
+	 _state = IDLE;
+	 _sentAt = 0;
+	 _discardFor = 0;
+	 _urcCount = 0;
+	 _lineLength = 0;
+	 _skipLine = false;
+ }
+
+
+ //
+ // PUBLIC METHODS
+ //
+ bool Sim800AT::send(const char *command, Sim800ATCallback callback, void *context,
+					 uint32_t timeout, const char *data)
+ {
+	 if (strlen(command) >= SIM800_AT_COMMAND_LENGTH)
+		 return false;
+	 Command *cmd = _push(callback, context, timeout, data);
+	 if (cmd == NULL)
+		 return false;
+	 strcpy(cmd->text, command);
+	 return true;
+ }
+
+ bool Sim800AT::send(const __FlashStringHelper *command, Sim800ATCallback callback, void *context,
+					 uint32_t timeout, const char *data)
+ {
+	 const char *text = (const char *)command;
+	 if (strlen_P(text) >= SIM800_AT_COMMAND_LENGTH)
+		 return false;
+	 Command *cmd = _push(callback, context, timeout, data);
+	 if (cmd == NULL)
+		 return false;
+	 strcpy_P(cmd->text, text);
+	 return true;
+ }
+
+ bool Sim800AT::onURC(const char *prefix, Sim800URCCallback callback, void *context)
+ {
+	 if (_urcCount == SIM800_AT_MAX_URC)
+		 return false;
+	 _urc[_urcCount].prefix = prefix;
+	 _urc[_urcCount].callback = callback;
+	 _urc[_urcCount].context = context;
+	 _urcCount++;
+	 return true;
+ }
+
+ void Sim800AT::loop()
+ {
+	 // only what has arrived so far, a chatty module cannot keep us here
+	 for (int n = _serial->available(); n > 0; n--)
+	 {
+		 int c = _serial->read();
+		 if (c < 0)
+			 break;
+		 _receive((char)c);
+	 }
+
+	 if ((_state == WAIT_PROMPT || _state == WAIT_RESULT) && millis() - _sentAt >= _queue[_head].timeout)
+		 _abandon(SIM800_AT_TIMEOUT);
+	 else if (_state == DISCARD && millis() - _sentAt >= _discardFor)
+		 _state = IDLE; // the abandoned command never answered
+
+	 if (_state == IDLE && _count > 0)
+		 _transmit();
+ }
+
+ void Sim800AT::clear()
+ {
+	 if (_state == WAIT_PROMPT || _state == WAIT_RESULT)
+		 _abandon(SIM800_AT_CANCELLED);
+	 while (_count > 0)
+		 _finish(SIM800_AT_CANCELLED, "");
+ }
+
+
+ //
+ // PRIVATE METHODS
+ //
+ Sim800AT::Command *Sim800AT::_push(Sim800ATCallback callback, void *context,
+									 uint32_t timeout, const char *data)
+ {
+	 if (_count == SIM800_AT_QUEUE_SIZE)
+		 return NULL;
+	 Command *cmd = &_queue[(_head + _count) % SIM800_AT_QUEUE_SIZE];
+	 cmd->data = data;
+	 cmd->timeout = timeout;
+	 cmd->callback = callback;
+	 cmd->context = context;
+	 _count++;
+	 return cmd;
+ }
+
+ void Sim800AT::_transmit()
+ {
+	 Command &cmd = _queue[_head];
+	 _serial->print(cmd.text);
+	 _serial->print('\r');
+	 _state = cmd.data != NULL ? WAIT_PROMPT : WAIT_RESULT;
+	 _sentAt = millis();
+ }
+
+ void Sim800AT::_receive(char c)
+ {
+	 // lines end with \r\n, the \r is dropped
+	 if (c == '\r')
+		 return;
+	 if (c == '\n')
+	 {
+		 if (_skipLine)
+			 _skipLine = false;
+		 else if (_lineLength > 0)
+			 _dispatchLine();
+		 _lineLength = 0;
+		 return;
+	 }
+	 if (_skipLine)
+		 return;
+
+	 // the "> " prompt has no line end, answer it as soon as it shows up;
+	 // a late prompt of an abandoned command was already answered with ESC
+	 if (c == '>' && _lineLength == 0 && (_state == WAIT_PROMPT || _state == DISCARD))
+	 {
+		 if (_state == WAIT_PROMPT)
+		 {
+			 _serial->print(_queue[_head].data);
+			 _serial->write((uint8_t)26); // Ctrl-Z
+			 _state = WAIT_RESULT;
+		 }
+		 _skipLine = true;
+		 return;
+	 }
+
+	 if (_lineLength < SIM800_AT_LINE_LENGTH - 1)
+		 _line[_lineLength++] = c;
+ }
+
+ void Sim800AT::_dispatchLine()
+ {
+	 _line[_lineLength] = '\0';
+
+	 for (uint8_t i = 0; i < _urcCount; i++)
+	 {
+		 if (strncmp(_line, _urc[i].prefix, strlen(_urc[i].prefix)) == 0)
+		 {
+			 _urc[i].callback(_urc[i].context, _line);
+			 return;
+		 }
+	 }
+
+	 if (_state == IDLE)
+		 return; // nobody asked for it
+
+	 if (_state == DISCARD)
+	 {
+		 // the late answer of an abandoned command, the next one can go
+		 if (_resultOf(_line) != SIM800_AT_LINE)
+			 _state = IDLE;
+		 return;
+	 }
+
+	 Command &cmd = _queue[_head];
+	 if (strcmp(_line, cmd.text) == 0)
+		 return; // echo, ATE1
+
+	 uint8_t event = _resultOf(_line);
+	 if (event != SIM800_AT_LINE)
+	 {
+		 _state = IDLE;
+		 _finish(event, _line);
+	 }
+	 else if (cmd.callback != NULL)
+		 cmd.callback(cmd.context, SIM800_AT_LINE, _line);
+ }
+
+ void Sim800AT::_finish(uint8_t event, const char *line)
+ {
+	 // take the command off the queue first, the callback may queue the next one
+	 Sim800ATCallback callback = _queue[_head].callback;
+	 void *context = _queue[_head].context;
+	 _head = (_head + 1) % SIM800_AT_QUEUE_SIZE;
+	 _count--;
+	 if (callback != NULL)
+		 callback(context, event, line);
+ }
+
+ void Sim800AT::_abandon(uint8_t event)
+ {
+	 // Gives up on the running command. The module may still be waiting
+	 // for the text after the prompt, ESC leaves it without sending
+	 // (after the Ctrl-Z it is ignored). Whatever it still answers is
+	 // dropped: a timed out command gets SIM800_AT_DISCARD_TIME for it,
+	 // a cleared one the rest of its timeout as well.
+	 Command &cmd = _queue[_head];
+	 uint32_t now = millis();
+	 uint32_t wait = SIM800_AT_DISCARD_TIME;
+	 if (event == SIM800_AT_CANCELLED && now - _sentAt < cmd.timeout && cmd.timeout - (now - _sentAt) > wait)
+		 wait = cmd.timeout - (now - _sentAt);
+	 if (cmd.data != NULL)
+		 _serial->write((uint8_t)27); // ESC
+	 _state = DISCARD;
+	 _sentAt = now;
+	 _discardFor = wait;
+	 _skipLine = false;
+	 _finish(event, "");
+ }
+
+ uint8_t Sim800AT::_resultOf(const char *line)
+ {
+	 if (strcmp_P(line, PSTR("OK")) == 0 ||
+		 strcmp_P(line, PSTR("SEND OK")) == 0 ||
+		 strcmp_P(line, PSTR("SHUT OK")) == 0)
+		 return SIM800_AT_OK;
+	 if (strcmp_P(line, PSTR("ERROR")) == 0 ||
+		 strncmp_P(line, PSTR("+CME ERROR"), 10) == 0 ||
+		 strncmp_P(line, PSTR("+CMS ERROR"), 10) == 0 ||
+		 strcmp_P(line, PSTR("SEND FAIL")) == 0)
+		 return SIM800_AT_ERROR;
+	 return SIM800_AT_LINE;
+ }
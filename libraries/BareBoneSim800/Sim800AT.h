@@ -0,0 +1,144 @@
+/*    Non-blocking AT command engine for the SIM800
+ *
+ *    Commands are queued with send() and written to the module one at a
+ *    time. loop() reads whatever the module has sent so far, straight out
+ *    of the serial receive ring buffer, and cuts it into lines in a fixed
+ *    buffer - no String and no delay(). Every line is either
+ *      - the echo of the command, which is dropped
+ *      - a final result (OK, ERROR, +CME ERROR, +CMS ERROR, SEND OK ...)
+ *        that completes the command. CONNECT OK and CONNECT FAIL come
+ *        after the OK of AT+CIPSTART, register them with onURC().
+ *      - an unsolicited result code (URC) such as +CMTI, handed to the
+ *        callback registered with onURC()
+ *      - an information line of the command (+CMGS: 12, +CBC: 0,95,4123 ...)
+ *    Each command has its own timeout, measured from the moment it is sent.
+ *    A command that times out or is cleared after it was sent may still be
+ *    answered: the engine sends ESC to leave the SMS/data text entry, then
+ *    drops that late "> " and result instead of giving them to the next
+ *    command, which goes out once they arrived or SIM800_AT_DISCARD_TIME
+ *    passed.
+ *
+ *    The engine only needs a Stream, so it works with AltSoftSerial,
+ *    HardwareSerial or a scripted fake modem on the PC (see extras/fake_modem).
+ *
+ *    Do not call the blocking BareBoneSim800 functions while commands are
+ *    queued here, both would read the same serial port.
+ */
+
+#ifndef Sim800AT_h
+#define Sim800AT_h
+
+#include "Arduino.h"
+
+// Commands waiting in the queue, the one being executed included
+#ifndef SIM800_AT_QUEUE_SIZE
+#define SIM800_AT_QUEUE_SIZE 4
+#endif
+
+// Longest command, "AT" included
+#ifndef SIM800_AT_COMMAND_LENGTH
+#define SIM800_AT_COMMAND_LENGTH 40
+#endif
+
+// Longest response line kept, longer lines are cut
+#ifndef SIM800_AT_LINE_LENGTH
+#define SIM800_AT_LINE_LENGTH 64
+#endif
+
+// Number of URC callbacks
+#ifndef SIM800_AT_MAX_URC
+#define SIM800_AT_MAX_URC 4
+#endif
+
+#define SIM800_AT_DEFAULT_TIMEOUT 10000 // ms
+
+// How long the late answer of an abandoned command is waited for
+#ifndef SIM800_AT_DISCARD_TIME
+#define SIM800_AT_DISCARD_TIME 1000 // ms
+#endif
+
+// Events passed to a command callback
+#define SIM800_AT_LINE 0      // an information line, the command is still running
+#define SIM800_AT_OK 1        // OK, SEND OK, SHUT OK
+#define SIM800_AT_ERROR 2     // ERROR, +CME ERROR: n, +CMS ERROR: n, SEND FAIL
+#define SIM800_AT_TIMEOUT 3   // no final result within the timeout
+#define SIM800_AT_CANCELLED 4 // removed from the queue by clear()
+
+// line is only valid during the call. It is the information line for
+// SIM800_AT_LINE, the result line for SIM800_AT_OK and SIM800_AT_ERROR
+// (e.g. "+CMS ERROR: 500") and empty otherwise.
+typedef void (*Sim800ATCallback)(void *context, uint8_t event, const char *line);
+typedef void (*Sim800URCCallback)(void *context, const char *line);
+
+class Sim800AT
+{
+	public:
+	Sim800AT(Stream &serial);
+
+	// Queues a command, "\r" is added when it is sent. data, if not NULL,
+	// is written after the "> " prompt and ended with Ctrl-Z (AT+CMGS,
+	// AT+CIPSEND); it must stay valid until the callback reports the result.
+	// Returns false if the queue is full or the command is too long.
+	bool send(const char *command, Sim800ATCallback callback = NULL, void *context = NULL,
+			  uint32_t timeout = SIM800_AT_DEFAULT_TIMEOUT, const char *data = NULL);
+	bool send(const __FlashStringHelper *command, Sim800ATCallback callback = NULL, void *context = NULL,
+			  uint32_t timeout = SIM800_AT_DEFAULT_TIMEOUT, const char *data = NULL);
+
+	// Calls callback for every line starting with prefix, e.g. "+CMTI:" or
+	// "RING". prefix is not copied. Returns false if all slots are used.
+	bool onURC(const char *prefix, Sim800URCCallback callback, void *context = NULL);
+
+	// Reads the module and sends the next command. Call it from loop(),
+	// it never blocks.
+	void loop();
+
+	// Drops every queued command, the running one included, reporting
+	// SIM800_AT_CANCELLED for each. If the running command was sent, the
+	// next one waits for its result, at most until its timeout.
+	void clear();
+
+	bool isIdle() const { return _count == 0; }
+	uint8_t pending() const { return _count; } // queued commands, the running one included
+
+	private:
+	struct Command {
+		char text[SIM800_AT_COMMAND_LENGTH];
+		const char *data;
+		uint32_t timeout;
+		Sim800ATCallback callback;
+		void *context;
+	};
+
+	struct URC {
+		const char *prefix;
+		Sim800URCCallback callback;
+		void *context;
+	};
+
+	enum State { IDLE, WAIT_PROMPT, WAIT_RESULT, DISCARD };
+
+	Stream *_serial;
+	Command _queue[SIM800_AT_QUEUE_SIZE];
+	uint8_t _head;
+	uint8_t _count;
+	uint8_t _state;
+	uint32_t _sentAt;
+	uint32_t _discardFor; // DISCARD ends this long after _sentAt
+
+	URC _urc[SIM800_AT_MAX_URC];
+	uint8_t _urcCount;
+
+	char _line[SIM800_AT_LINE_LENGTH];
+	uint8_t _lineLength;
+	bool _skipLine; // rest of the prompt line, or the data echo after it
+
+	Command *_push(Sim800ATCallback callback, void *context, uint32_t timeout, const char *data);
+	void _transmit();
+	void _receive(char c);
+	void _dispatchLine();
+	void _finish(uint8_t event, const char *line);
+	void _abandon(uint8_t event);
+	static uint8_t _resultOf(const char *line);
+};
+
+#endif
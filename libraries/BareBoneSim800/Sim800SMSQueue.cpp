@@ -0,0 +1,295 @@
+/*    Outbound SMS queue for the SIM800
+ *    See Sim800SMSQueue.h for how messages are sent and retried.
+ */
+
+#include "Arduino.h"
+#include <EEPROM.h>
+#include <stddef.h>
+#include "Sim800SMSQueue.h"
+
+// EEPROM layout: magic, queue size, message size, then the messages
+#define SIM800_SMS_EEPROM_MAGIC 0x5A
+#define SIM800_SMS_EEPROM_HEADER 3
+
+ Sim800SMSQueue::Sim800SMSQueue(Sim800AT &at)
+ {
+	 _at = &at;
+	 _callback = NULL;
+	 begin();
+ }
+
+
+ //
+ // PUBLIC METHODS
+ //
+ void Sim800SMSQueue::begin()
+ {
+	 memset(_messages, 0, sizeof(_messages));
+	 memset(_due, 0, sizeof(_due));
+	 memset(_order, 0, sizeof(_order));
+	 _nextOrder = 0;
+	 _nextId = 1;
+	 _sending = -1;
+	 _sendStart = 0;
+	 _textMode = false;
+	 _eeprom = -1;
+	 resetStats();
+ }
+
+ void Sim800SMSQueue::begin(int eepromAddress)
+ {
+	 begin();
+	 _eeprom = eepromAddress;
+	 if (EEPROM.read(_eeprom) != SIM800_SMS_EEPROM_MAGIC ||
+		 EEPROM.read(_eeprom + 1) != SIM800_SMS_QUEUE_SIZE ||
+		 EEPROM.read(_eeprom + 2) != (uint8_t)sizeof(Message))
+	 {
+		 // nothing of ours there yet
+		 EEPROM.update(_eeprom, SIM800_SMS_EEPROM_MAGIC);
+		 EEPROM.update(_eeprom + 1, SIM800_SMS_QUEUE_SIZE);
+		 EEPROM.update(_eeprom + 2, (uint8_t)sizeof(Message));
+		 for (uint8_t i = 0; i < SIM800_SMS_QUEUE_SIZE; i++)
+			 _save(i);
+		 return;
+	 }
+
+	 // pick up the messages that were still waiting, in slot order
+	 for (uint8_t i = 0; i < SIM800_SMS_QUEUE_SIZE; i++)
+	 {
+		 uint8_t *bytes = (uint8_t *)&_messages[i];
+		 int address = _eeprom + SIM800_SMS_EEPROM_HEADER + i * sizeof(Message);
+		 for (size_t k = 0; k < sizeof(Message); k++)
+			 bytes[k] = EEPROM.read(address + k);
+		 Message &m = _messages[i];
+		 m.number[SIM800_SMS_NUMBER_LENGTH - 1] = '\0';
+		 m.text[SIM800_SMS_TEXT_LENGTH - 1] = '\0';
+		 if (m.state != SIM800_SMS_PENDING || m.attempts >= SIM800_SMS_MAX_ATTEMPTS)
+			 m.state = SIM800_SMS_UNKNOWN;
+		 _due[i] = millis();
+		 _order[i] = _nextOrder++;
+		 if (m.state == SIM800_SMS_PENDING && m.id >= _nextId)
+			 _nextId = m.id + 1;
+	 }
+	 if (_nextId == 0)
+		 _nextId = 1;
+ }
+
+ uint8_t Sim800SMSQueue::send(const char *number, const char *text)
+ {
+	 if (strlen(number) >= SIM800_SMS_NUMBER_LENGTH || strlen(text) >= SIM800_SMS_TEXT_LENGTH)
+	 {
+		 _stats.rejected++;
+		 return 0;
+	 }
+
+	 // the same alert still waiting for this number
+	 for (uint8_t i = 0; i < SIM800_SMS_QUEUE_SIZE; i++)
+	 {
+		 Message &m = _messages[i];
+		 if ((m.state == SIM800_SMS_PENDING || m.state == SIM800_SMS_SENDING) &&
+			 strcmp(m.number, number) == 0 && strcmp(m.text, text) == 0)
+		 {
+			 _stats.duplicates++;
+			 return m.id;
+		 }
+	 }
+
+	 // a free slot, or the one finished first
+	 int8_t slot = -1;
+	 for (uint8_t i = 0; i < SIM800_SMS_QUEUE_SIZE && slot < 0; i++)
+		 if (_messages[i].state == SIM800_SMS_UNKNOWN)
+			 slot = i;
+	 if (slot < 0)
+	 {
+		 for (uint8_t i = 0; i < SIM800_SMS_QUEUE_SIZE; i++)
+		 {
+			 uint8_t state = _messages[i].state;
+			 if ((state == SIM800_SMS_SENT || state == SIM800_SMS_FAILED) &&
+				 (slot < 0 || _order[i] < _order[slot]))
+				 slot = i;
+		 }
+	 }
+	 if (slot < 0)
+	 {
+		 _stats.rejected++;
+		 return 0;
+	 }
+
+	 Message &m = _messages[slot];
+	 m.state = SIM800_SMS_PENDING;
+	 m.id = _nextId++;
+	 if (_nextId == 0)
+		 _nextId = 1;
+	 m.attempts = 0;
+	 strcpy(m.number, number);
+	 strcpy(m.text, text);
+	 _due[slot] = millis();
+	 _order[slot] = _nextOrder++;
+	 _save(slot);
+
+	 _stats.queued++;
+	 uint8_t waiting = pending();
+	 if (waiting > _stats.maxPending)
+		 _stats.maxPending = waiting;
+	 return m.id;
+ }
+
+ void Sim800SMSQueue::loop()
+ {
+	 _at->loop();
+	 // one message at a time, and not in the middle of the sketch's own commands
+	 if (_sending >= 0 || !_at->isIdle())
+		 return;
+	 int8_t slot = _next();
+	 if (slot >= 0)
+		 _start(slot);
+ }
+
+ uint8_t Sim800SMSQueue::status(uint8_t id) const
+ {
+	 if (id == 0)
+		 return SIM800_SMS_UNKNOWN;
+	 for (uint8_t i = 0; i < SIM800_SMS_QUEUE_SIZE; i++)
+		 if (_messages[i].state != SIM800_SMS_UNKNOWN && _messages[i].id == id)
+			 return _messages[i].state;
+	 return SIM800_SMS_UNKNOWN;
+ }
+
+ uint8_t Sim800SMSQueue::pending() const
+ {
+	 uint8_t count = 0;
+	 for (uint8_t i = 0; i < SIM800_SMS_QUEUE_SIZE; i++)
+		 if (_messages[i].state == SIM800_SMS_PENDING || _messages[i].state == SIM800_SMS_SENDING)
+			 count++;
+	 return count;
+ }
+
+ void Sim800SMSQueue::onResult(void (*callback)(uint8_t id, const char *number, bool sent))
+ {
+	 _callback = callback;
+ }
+
+ void Sim800SMSQueue::resetStats()
+ {
+	 memset(&_stats, 0, sizeof(_stats));
+ }
+
+ int Sim800SMSQueue::eepromSize()
+ {
+	 return SIM800_SMS_EEPROM_HEADER + SIM800_SMS_QUEUE_SIZE * sizeof(Message);
+ }
+
+
+ //
+ // PRIVATE METHODS
+ //
+ int8_t Sim800SMSQueue::_next() const
+ {
+	 // the oldest message whose retry time has come
+	 int8_t slot = -1;
+	 uint32_t now = millis();
+	 for (uint8_t i = 0; i < SIM800_SMS_QUEUE_SIZE; i++)
+	 {
+		 if (_messages[i].state != SIM800_SMS_PENDING || (int32_t)(now - _due[i]) < 0)
+			 continue;
+		 if (slot < 0 || _order[i] < _order[slot])
+			 slot = i;
+	 }
+	 return slot;
+ }
+
+ void Sim800SMSQueue::_start(uint8_t slot)
+ {
+	 Message &m = _messages[slot];
+	 char command[SIM800_AT_COMMAND_LENGTH];
+	 if (strlen(m.number) + 11 > sizeof(command))
+		 return; // can't happen with the default lengths
+	 strcpy_P(command, PSTR("AT+CMGS=\""));
+	 strcat(command, m.number);
+	 strcat(command, "\"");
+
+	 if (!_textMode)
+		 _at->send(F("AT+CMGF=1"), _onTextMode, this);
+	 if (!_at->send(command, _onResult, this, SIM800_SMS_SEND_TIMEOUT, m.text))
+		 return;
+
+	 if (m.attempts > 0)
+		 _stats.retries++;
+	 m.attempts++;
+	 m.state = SIM800_SMS_SENDING;
+	 _save(slot); // the attempt counts even if we are reset before the answer
+	 _sending = slot;
+	 _sendStart = millis();
+ }
+
+ void Sim800SMSQueue::_save(uint8_t slot)
+ {
+	 if (_eeprom < 0)
+		 return;
+	 // update() only writes the bytes that changed, the text is written once
+	 const uint8_t *bytes = (const uint8_t *)&_messages[slot];
+	 int address = _eeprom + SIM800_SMS_EEPROM_HEADER + slot * sizeof(Message);
+	 for (size_t k = 0; k < sizeof(Message); k++)
+	 {
+		 uint8_t b = bytes[k];
+		 if (k == offsetof(Message, state) && b == SIM800_SMS_SENDING)
+			 b = SIM800_SMS_PENDING; // sent again after a reset
+		 EEPROM.update(address + k, b);
+	 }
+ }
+
+ void Sim800SMSQueue::_onTextMode(void *context, uint8_t event, const char *line)
+ {
+	 Sim800SMSQueue *queue = (Sim800SMSQueue *)context;
+	 if (event == SIM800_AT_OK)
+		 queue->_textMode = true;
+ }
+
+ void Sim800SMSQueue::_onResult(void *context, uint8_t event, const char *line)
+ {
+	 Sim800SMSQueue *queue = (Sim800SMSQueue *)context;
+	 if (event == SIM800_AT_LINE || queue->_sending < 0)
+		 return;
+	 uint8_t slot = queue->_sending;
+	 Message &m = queue->_messages[slot];
+	 queue->_sending = -1;
+
+	 if (event == SIM800_AT_OK)
+	 {
+		 m.state = SIM800_SMS_SENT;
+		 queue->_stats.sent++;
+		 queue->_stats.sendTime += millis() - queue->_sendStart;
+	 }
+	 else
+	 {
+		 // the module may have been reset, set text mode again
+		 queue->_textMode = false;
+		 if (m.attempts >= SIM800_SMS_MAX_ATTEMPTS)
+		 {
+			 m.state = SIM800_SMS_FAILED;
+			 queue->_stats.failed++;
+		 }
+		 else
+		 {
+			 uint32_t wait = SIM800_SMS_RETRY_DELAY;
+			 for (uint8_t k = 1; k < m.attempts && wait < SIM800_SMS_MAX_RETRY_DELAY; k++)
+				 wait *= 2;
+			 if (wait > SIM800_SMS_MAX_RETRY_DELAY)
+				 wait = SIM800_SMS_MAX_RETRY_DELAY;
+			 m.state = SIM800_SMS_PENDING;
+			 queue->_due[slot] = millis() + wait;
+		 }
+	 }
+	 queue->_save(slot);
+
+	 if (m.state != SIM800_SMS_PENDING && queue->_callback != NULL)
+		 queue->_callback(m.id, m.number, m.state == SIM800_SMS_SENT);
+
+	 // straight on with the next one, the AT engine sends it in this same loop()
+	 if (queue->_sending < 0 && queue->_at->isIdle())
+	 {
+		 int8_t next = queue->_next();
+		 if (next >= 0)
+			 queue->_start(next);
+	 }
+ }
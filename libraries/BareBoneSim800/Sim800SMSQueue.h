@@ -0,0 +1,121 @@
+/*    Outbound SMS queue for the SIM800
+ *
+ *    send() copies the number and text into the queue and returns at once.
+ *    loop() hands the messages to the Sim800AT engine one after the other,
+ *    the next AT+CMGS going out as soon as the previous one is answered.
+ *    A message that fails (ERROR, +CMS ERROR, timeout) is tried again after
+ *    SIM800_SMS_RETRY_DELAY, doubled on every attempt up to
+ *    SIM800_SMS_MAX_RETRY_DELAY, and given up after SIM800_SMS_MAX_ATTEMPTS.
+ *    The same text queued again for a number it is still waiting to go to is
+ *    not queued twice.
+ *
+ *    With begin(eepromAddress) the queue is kept in EEPROM too, so messages
+ *    not sent yet are sent after a reset (a SIM800 drawing 2A while it
+ *    transmits often browns out the Arduino). A message that was being sent
+ *    when the reset came is sent again.
+ */
+
+#ifndef Sim800SMSQueue_h
+#define Sim800SMSQueue_h
+
+#include "Arduino.h"
+#include "Sim800AT.h"
+
+// Messages kept, sent or failed ones are reused first
+#ifndef SIM800_SMS_QUEUE_SIZE
+#define SIM800_SMS_QUEUE_SIZE 4
+#endif
+
+// Longest number and text, the terminating zero included
+#ifndef SIM800_SMS_NUMBER_LENGTH
+#define SIM800_SMS_NUMBER_LENGTH 20
+#endif
+#ifndef SIM800_SMS_TEXT_LENGTH
+#define SIM800_SMS_TEXT_LENGTH 64
+#endif
+
+#ifndef SIM800_SMS_MAX_ATTEMPTS
+#define SIM800_SMS_MAX_ATTEMPTS 5
+#endif
+#ifndef SIM800_SMS_RETRY_DELAY
+#define SIM800_SMS_RETRY_DELAY 5000 // ms before the second attempt
+#endif
+#ifndef SIM800_SMS_MAX_RETRY_DELAY
+#define SIM800_SMS_MAX_RETRY_DELAY 300000
+#endif
+#define SIM800_SMS_SEND_TIMEOUT 60000 // AT+CMGS, the network can be slow
+
+// Status of a message
+#define SIM800_SMS_UNKNOWN 0 // no such id, or its slot was reused
+#define SIM800_SMS_PENDING 1 // waiting for its (next) attempt
+#define SIM800_SMS_SENDING 2
+#define SIM800_SMS_SENT 3
+#define SIM800_SMS_FAILED 4  // SIM800_SMS_MAX_ATTEMPTS used up
+
+struct Sim800SMSStats {
+	uint32_t queued;     // accepted by send()
+	uint32_t duplicates; // send() calls answered with a message already pending
+	uint32_t rejected;   // send() calls refused, queue full or text too long
+	uint32_t sent;
+	uint32_t failed;
+	uint32_t retries;    // attempts after the first one
+	uint32_t sendTime;   // ms from AT+CMGS to OK, summed over sent messages
+	uint8_t maxPending;  // most messages waiting at once
+};
+
+class Sim800SMSQueue
+{
+	public:
+	Sim800SMSQueue(Sim800AT &at);
+
+	void begin();                  // queue in RAM only
+	void begin(int eepromAddress); // queue kept in EEPROM too, see eepromSize()
+
+	// Queues a message, returns its id (never 0) or 0 if the queue is full
+	// or the number or text is too long. A message with the same number and
+	// text still pending or being sent gets its id back instead.
+	uint8_t send(const char *number, const char *text);
+
+	// Sends the next message when it is due. Runs the AT engine too.
+	void loop();
+
+	uint8_t status(uint8_t id) const;
+	uint8_t pending() const; // messages not sent or failed yet
+	void onResult(void (*callback)(uint8_t id, const char *number, bool sent));
+
+	const Sim800SMSStats &stats() const { return _stats; }
+	void resetStats();
+	uint32_t averageSendTime() const { return _stats.sent ? _stats.sendTime / _stats.sent : 0; }
+
+	static int eepromSize();
+
+	private:
+	struct Message {
+		uint8_t state;
+		uint8_t id;
+		uint8_t attempts;
+		char number[SIM800_SMS_NUMBER_LENGTH];
+		char text[SIM800_SMS_TEXT_LENGTH];
+	};
+
+	Sim800AT *_at;
+	Message _messages[SIM800_SMS_QUEUE_SIZE];
+	uint32_t _due[SIM800_SMS_QUEUE_SIZE];   // millis() of the next attempt
+	uint32_t _order[SIM800_SMS_QUEUE_SIZE]; // queued first, sent first
+	uint32_t _nextOrder;
+	uint8_t _nextId;
+	int8_t _sending;   // slot handed to the AT engine, -1 if none
+	uint32_t _sendStart;
+	bool _textMode;    // AT+CMGF=1 done
+	int _eeprom;       // -1 if not kept in EEPROM
+	void (*_callback)(uint8_t, const char *, bool);
+	Sim800SMSStats _stats;
+
+	int8_t _next() const;
+	void _start(uint8_t slot);
+	void _save(uint8_t slot);
+	static void _onTextMode(void *context, uint8_t event, const char *line);
+	static void _onResult(void *context, uint8_t event, const char *line);
+};
+
+#endif
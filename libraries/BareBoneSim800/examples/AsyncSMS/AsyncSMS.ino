@@ -0,0 +1,77 @@
+/*    Sending and receiving SMS without blocking
+ *
+ *    sendSMSAsync() queues the commands and returns at once, the result
+ *    comes to onSMSSent(). onNewSMS() asks the module to announce every new
+ *    SMS (+CMTI) so there is no need to poll checkNewSMS(). sim800.loop()
+ *    does all the work and must be called as often as possible - the LED
+ *    keeps blinking while the SMS goes out.
+ *
+ *    PINOUT: see the other examples, RX 8 and TX 9 on the UNO
+ */
+
+#include <BareBoneSim800.h>
+
+BareBoneSim800 sim800;
+
+const char* number = "+2347038945220";
+const char* message = "Hello, sent without blocking"; // must stay valid until onSMSSent
+
+unsigned long lastBlink = 0;
+
+void smsSent(bool sent, int reference)
+{
+  if (sent)
+  {
+    Serial.print("Message Sent, reference ");
+    Serial.println(reference);
+  }
+  else
+    Serial.println("Not Sent, Something happened");
+}
+
+void newSMS(int index)
+{
+  Serial.print("New SMS at index ");
+  Serial.println(index);
+  // readSMS(index) blocks, queue AT+CMGR with sim800.at().send() instead
+  // if the sketch must keep running while it is read
+}
+
+// Any command can be queued, the callback gets each line of the answer
+void battery(void *context, uint8_t event, const char *line)
+{
+  if (event == SIM800_AT_LINE)
+  {
+    Serial.print("Battery: ");
+    Serial.println(line); // +CBC: 0,95,4123
+  }
+  else if (event != SIM800_AT_OK)
+    Serial.println("Battery read failed");
+}
+
+void setup() {
+  Serial.begin(9600);
+  sim800.begin();
+  while(!Serial);
+  pinMode(LED_BUILTIN, OUTPUT);
+
+  Serial.println("Testing GSM module For Non-Blocking SMS");
+  delay(8000); // this delay is necessary, it helps the device to be ready and connect to a network
+
+  sim800.onSMSSent(smsSent);
+  sim800.onNewSMS(newSMS);
+  sim800.at().send(F("AT+CBC"), battery);
+
+  if (!sim800.sendSMSAsync(number, message))
+    Serial.println("Queue full");
+}
+
+void loop() {
+  sim800.loop();
+
+  if (millis() - lastBlink >= 250)
+  {
+    lastBlink = millis();
+    digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+  }
+}
@@ -0,0 +1,72 @@
+/*    Sending one alert to several numbers in the background
+ *
+ *    Sim800SMSQueue keeps the messages and sends them one after the other
+ *    while the sketch keeps reading its sensor. Failed messages are tried
+ *    again (5s, 10s, 20s ... later), the same alert raised again while it
+ *    is still waiting is not queued twice, and with begin(address) the queue
+ *    is kept in EEPROM so alerts still waiting are sent after a reset.
+ *
+ *    PINOUT: see the other examples, RX 8 and TX 9 on the UNO
+ */
+
+#include <BareBoneSim800.h>
+#include <Sim800SMSQueue.h>
+
+BareBoneSim800 sim800;
+Sim800SMSQueue smsQueue(sim800.at());
+
+const char* numbers[] = { "+2347065109136", "+2349038731345", "+2349018431505" };
+const int SENSOR = A0;
+
+unsigned long lastReport = 0;
+bool alarmOn = false;
+
+void smsResult(uint8_t id, const char *number, bool sent)
+{
+  Serial.print(sent ? "Sent to " : "Gave up on ");
+  Serial.println(number);
+}
+
+void setup() {
+  Serial.begin(9600);
+  sim800.begin();
+  while(!Serial);
+
+  Serial.println("Testing GSM module For Queued SMS");
+  delay(8000); // this delay is necessary, it helps the device to be ready and connect to a network
+
+  smsQueue.begin(0); // EEPROM bytes 0 .. Sim800SMSQueue::eepromSize() - 1
+  smsQueue.onResult(smsResult);
+}
+
+void loop() {
+  smsQueue.loop(); // runs sim800's AT engine too
+
+  // on each new alarm; a sensor flickering around the threshold does not
+  // queue the alert again while it still waits to go out
+  bool alarm = analogRead(SENSOR) > 600;
+  if (alarm && !alarmOn)
+  {
+    for (int i = 0; i < 3; i++)
+      smsQueue.send(numbers[i], "Alert: smoke detected");
+  }
+  alarmOn = alarm;
+
+  if (millis() - lastReport >= 60000)
+  {
+    lastReport = millis();
+    const Sim800SMSStats &stats = smsQueue.stats();
+    Serial.print("pending ");
+    Serial.print(smsQueue.pending());
+    Serial.print(", sent ");
+    Serial.print(stats.sent);
+    Serial.print(", failed ");
+    Serial.print(stats.failed);
+    Serial.print(", retries ");
+    Serial.print(stats.retries);
+    Serial.print(", duplicates ");
+    Serial.print(stats.duplicates);
+    Serial.print(", ms per sms ");
+    Serial.println(smsQueue.averageSendTime());
+  }
+}
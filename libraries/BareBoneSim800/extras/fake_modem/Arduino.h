@@ -0,0 +1,41 @@
+// Minimal Arduino stand-in for running the Sim800AT engine on a desktop
+// machine. millis() is a variable the test moves forward, Stream is the
+// subset the engine uses.
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern uint32_t fakeMillis;
+
+inline uint32_t millis() { return fakeMillis; }
+
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper *)(s))
+#define PSTR(s) (s)
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+
+class Print
+{
+	public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	size_t print(const char *s) { size_t n = 0; while (*s) n += write((uint8_t)*s++); return n; }
+	size_t print(char c) { return write((uint8_t)c); }
+};
+
+class Stream : public Print
+{
+	public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+};
+
+#endif
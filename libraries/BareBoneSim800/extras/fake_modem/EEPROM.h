@@ -0,0 +1,26 @@
+// EEPROM stand-in: 1KB, erased to 0xFF, counting the bytes really written.
+
+#ifndef EEPROM_h
+#define EEPROM_h
+
+#include <stdint.h>
+#include <string.h>
+
+struct EEPROMClass {
+	uint8_t data[1024];
+	uint32_t writes;
+	EEPROMClass() : writes(0) { memset(data, 0xFF, sizeof(data)); }
+	uint8_t read(int address) { return data[address]; }
+	void update(int address, uint8_t value)
+	{
+		if (data[address] != value)
+		{
+			data[address] = value;
+			writes++;
+		}
+	}
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,108 @@
+// A scripted SIM800 for the PC. Each step names what the engine must write
+// (the command without its "\r", the data after a prompt including the
+// Ctrl-Z, or an ESC on its own) and what the modem answers, after a delay
+// in ms. Bytes only become available() once millis() reaches their time.
+
+#ifndef FakeModem_h
+#define FakeModem_h
+
+#include "Arduino.h"
+#include <deque>
+#include <string>
+
+struct FakeModemStep {
+	const char *expect;
+	const char *reply;  // NULL: no answer at all
+	uint32_t delay;
+};
+
+class FakeModem : public Stream
+{
+	public:
+	FakeModem() : unexpected(0), _steps(NULL), _stepCount(0), _next(0), _echo(false), _trickle(false), _last(0) {}
+
+	void script(const FakeModemStep *steps, size_t count) { _steps = steps; _stepCount = count; _next = 0; }
+	bool done() const { return _next == _stepCount; }
+
+	// ATE1: every byte written is sent back at once
+	void echo(bool on) { _echo = on; }
+	// available() reports at most one byte, as if the line was very slow
+	void trickle(bool on) { _trickle = on; }
+
+	// Sends text delay ms from now, after everything queued before it.
+	void push(const char *text, uint32_t delay = 0)
+	{
+		uint32_t due = fakeMillis + delay;
+		if (due < _last)
+			due = _last;
+		_last = due;
+		while (*text)
+			_out.push_back(std::make_pair(due, *text++));
+	}
+
+	int unexpected;         // commands that did not match the script
+	std::string lastWrite;  // the last complete command or data block
+
+	size_t write(uint8_t c)
+	{
+		if (_echo)
+		{
+			char s[2] = { (char)c, 0 };
+			push(s);
+		}
+		if (c == '\r' || c == 26 || c == 27)
+		{
+			if (c != '\r')
+				_in += (char)c;
+			lastWrite = _in;
+			_in.clear();
+			if (_next < _stepCount && lastWrite == _steps[_next].expect)
+			{
+				if (_steps[_next].reply != NULL)
+					push(_steps[_next].reply, _steps[_next].delay);
+				_next++;
+			}
+			else
+				unexpected++;
+			return 1;
+		}
+		_in += (char)c;
+		return 1;
+	}
+
+	int available()
+	{
+		int n = 0;
+		for (size_t i = 0; i < _out.size() && _out[i].first <= fakeMillis; i++)
+			n++;
+		return _trickle && n > 1 ? 1 : n;
+	}
+
+	int read()
+	{
+		if (_out.empty() || _out.front().first > fakeMillis)
+			return -1;
+		char c = _out.front().second;
+		_out.pop_front();
+		return (uint8_t)c;
+	}
+
+	int peek()
+	{
+		if (_out.empty() || _out.front().first > fakeMillis)
+			return -1;
+		return (uint8_t)_out.front().second;
+	}
+
+	private:
+	const FakeModemStep *_steps;
+	size_t _stepCount;
+	size_t _next;
+	bool _echo;
+	bool _trickle;
+	uint32_t _last;
+	std::string _in;
+	std::deque<std::pair<uint32_t, char> > _out;
+};
+
+#endif
@@ -0,0 +1,12 @@
+#!/bin/sh
+# Builds the Sim800AT engine and the SMS queue with the scripted fake modem
+# and runs the checks.
+set -e
+cd "$(dirname "$0")"
+status=0
+g++ -O2 -Wall -I. -o test_at_engine test_at_engine.cpp ../../Sim800AT.cpp
+./test_at_engine || status=$?
+g++ -O2 -Wall -I. -o test_sms_queue test_sms_queue.cpp ../../Sim800AT.cpp ../../Sim800SMSQueue.cpp
+./test_sms_queue || status=$?
+rm -f test_at_engine test_sms_queue
+exit $status
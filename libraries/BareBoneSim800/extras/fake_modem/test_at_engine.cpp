@@ -0,0 +1,295 @@
+// Runs the Sim800AT engine against FakeModem. millis() advances 1ms per
+// loop() call, the way a sketch that does other work would call it.
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "FakeModem.h"
+#include "Check.h"
+#include "../../Sim800AT.h"
+
+uint32_t fakeMillis = 0;
+
+// What a command callback saw
+struct Result {
+	std::vector<std::string> lines;
+	int event;
+	std::string final;
+	uint32_t at;
+	Result() : event(-1), at(0) {}
+};
+
+static void record(void *context, uint8_t event, const char *line)
+{
+	Result *r = (Result *)context;
+	if (event == SIM800_AT_LINE)
+	{
+		r->lines.push_back(line);
+		return;
+	}
+	r->event = event;
+	r->final = line;
+	r->at = fakeMillis;
+}
+
+static std::vector<std::string> urcs;
+
+static void recordURC(void *, const char *line)
+{
+	urcs.push_back(line);
+}
+
+// Runs loop() for ms milliseconds
+static void run(Sim800AT &at, uint32_t ms)
+{
+	for (uint32_t i = 0; i < ms; i++)
+	{
+		at.loop();
+		fakeMillis++;
+	}
+}
+
+static void information(bool trickle)
+{
+	printf("information line and OK%s\n", trickle ? ", one byte per loop()" : "");
+	FakeModem modem;
+	modem.trickle(trickle);
+	const FakeModemStep steps[] = {
+		{ "AT+CBC", "\r\n+CBC: 0,95,4123\r\n\r\nOK\r\n", 30 },
+	};
+	modem.script(steps, 1);
+	Sim800AT at(modem);
+	Result r;
+	uint32_t start = fakeMillis;
+	CHECK(at.send("AT+CBC", record, &r));
+	CHECK(!at.isIdle());
+	run(at, 200);
+	CHECK(modem.done() && modem.unexpected == 0);
+	CHECK(r.event == SIM800_AT_OK);
+	CHECK(r.lines.size() == 1 && r.lines[0] == "+CBC: 0,95,4123");
+	CHECK(r.at - start < 30 + 40); // done as soon as the bytes are in, not after a fixed wait
+	CHECK(at.isIdle());
+}
+
+static void errors()
+{
+	printf("ERROR, +CME ERROR and +CMS ERROR\n");
+	FakeModem modem;
+	const FakeModemStep steps[] = {
+		{ "AT+CPIN?", "\r\n+CME ERROR: 10\r\n", 10 },
+		{ "AT+CMGR=99", "\r\n+CMS ERROR: 321\r\n", 10 },
+		{ "AT+FOO", "\r\nERROR\r\n", 10 },
+	};
+	modem.script(steps, 3);
+	Sim800AT at(modem);
+	Result a, b, c;
+	CHECK(at.send("AT+CPIN?", record, &a));
+	CHECK(at.send("AT+CMGR=99", record, &b));
+	CHECK(at.send(F("AT+FOO"), record, &c));
+	run(at, 200);
+	CHECK(modem.done() && modem.unexpected == 0);
+	CHECK(a.event == SIM800_AT_ERROR && a.final == "+CME ERROR: 10");
+	CHECK(b.event == SIM800_AT_ERROR && b.final == "+CMS ERROR: 321");
+	CHECK(c.event == SIM800_AT_ERROR && c.final == "ERROR");
+}
+
+static void timeouts()
+{
+	printf("timeout of each command\n");
+	FakeModem modem;
+	const FakeModemStep steps[] = {
+		{ "AT+COPS?", NULL, 0 },
+		{ "AT", "\r\nOK\r\n", 5 },
+	};
+	modem.script(steps, 2);
+	Sim800AT at(modem);
+	Result a, b;
+	uint32_t start = fakeMillis;
+	CHECK(at.send("AT+COPS?", record, &a, 500));
+	CHECK(at.send("AT", record, &b, 100));
+	run(at, 499);
+	CHECK(a.event == -1);
+	run(at, 100);
+	CHECK(a.event == SIM800_AT_TIMEOUT && a.final == "");
+	CHECK(a.at - start == 500);
+	CHECK(b.event == -1); // a late answer to AT+COPS? is still waited for
+	run(at, SIM800_AT_DISCARD_TIME);
+	CHECK(b.event == SIM800_AT_OK);
+	CHECK(b.at - start >= 500 + SIM800_AT_DISCARD_TIME);
+	CHECK(modem.done() && modem.unexpected == 0);
+}
+
+static void prompt(bool echo, bool trickle)
+{
+	printf("sms with prompt%s%s\n", echo ? ", echo on" : "", trickle ? ", one byte per loop()" : "");
+	FakeModem modem;
+	modem.echo(echo);
+	modem.trickle(trickle);
+	const FakeModemStep steps[] = {
+		{ "AT+CMGF=1", "\r\nOK\r\n", 10 },
+		{ "AT+CMGS=\"+2348012345678\"", "\r\n> ", 200 },
+		{ "Hello there\x1a", "\r\n+CMGS: 12\r\n\r\nOK\r\n", 3000 },
+	};
+	modem.script(steps, 3);
+	Sim800AT at(modem);
+	Result a, b;
+	CHECK(at.send("AT+CMGF=1", record, &a));
+	CHECK(at.send("AT+CMGS=\"+2348012345678\"", record, &b, 60000, "Hello there"));
+	run(at, 5000);
+	CHECK(modem.done() && modem.unexpected == 0);
+	CHECK(a.event == SIM800_AT_OK && a.lines.empty());
+	CHECK(b.event == SIM800_AT_OK);
+	CHECK(b.lines.size() == 1 && b.lines[0] == "+CMGS: 12");
+}
+
+static void promptTimeout()
+{
+	printf("sms timing out before the prompt\n");
+	FakeModem modem;
+	const FakeModemStep steps[] = {
+		{ "AT+CMGS=\"+2348012345678\"", "\r\n> ", 300 },
+		{ "\x1b", "\r\nOK\r\n", 10 },
+		{ "AT+CSQ", "\r\n+CSQ: 17,0\r\n\r\nERROR\r\n", 10 },
+	};
+	modem.script(steps, 3);
+	Sim800AT at(modem);
+	Result a, b;
+	CHECK(at.send("AT+CMGS=\"+2348012345678\"", record, &a, 100, "Hello there"));
+	CHECK(at.send("AT+CSQ", record, &b));
+	run(at, 200);
+	CHECK(a.event == SIM800_AT_TIMEOUT);
+	CHECK(modem.lastWrite == "\x1b"); // leaves the text entry, no text sent
+	run(at, 500);
+	CHECK(modem.done() && modem.unexpected == 0);
+	// the late prompt and OK were not taken for AT+CSQ
+	CHECK(b.event == SIM800_AT_ERROR);
+	CHECK(b.lines.size() == 1 && b.lines[0] == "+CSQ: 17,0");
+}
+
+static void clearAfterPrompt()
+{
+	printf("sms cleared after the prompt\n");
+	FakeModem modem;
+	const FakeModemStep steps[] = {
+		{ "AT+CMGS=\"+2348012345678\"", "\r\n> ", 20 },
+		{ "Hello there\x1a", "\r\n+CMGS: 12\r\n\r\nOK\r\n", 3000 },
+		{ "\x1b", NULL, 0 },
+		{ "AT", "\r\nERROR\r\n", 10 },
+	};
+	modem.script(steps, 4);
+	Sim800AT at(modem);
+	Result a, b;
+	CHECK(at.send("AT+CMGS=\"+2348012345678\"", record, &a, 60000, "Hello there"));
+	run(at, 100);
+	at.clear();
+	CHECK(a.event == SIM800_AT_CANCELLED);
+	CHECK(at.send("AT", record, &b));
+	run(at, 2000);
+	CHECK(b.event == -1); // held back while the message is still being sent
+	run(at, 1500);
+	CHECK(modem.done() && modem.unexpected == 0);
+	CHECK(b.event == SIM800_AT_ERROR && b.lines.empty());
+}
+
+static void unsolicited()
+{
+	printf("URCs while a command runs and while idle\n");
+	FakeModem modem;
+	const FakeModemStep steps[] = {
+		{ "AT+CSQ", "\r\n+CSQ: 17,0\r\n\r\n+CMTI: \"SM\",3\r\n\r\nOK\r\n", 20 },
+	};
+	modem.script(steps, 1);
+	Sim800AT at(modem);
+	urcs.clear();
+	CHECK(at.onURC("+CMTI:", recordURC));
+	CHECK(at.onURC("RING", recordURC));
+	modem.push("\r\nCall Ready\r\n\r\nRING\r\n", 5);
+	run(at, 50);
+	Result r;
+	CHECK(at.send("AT+CSQ", record, &r));
+	run(at, 100);
+	CHECK(r.event == SIM800_AT_OK);
+	CHECK(r.lines.size() == 1 && r.lines[0] == "+CSQ: 17,0");
+	CHECK(urcs.size() == 2 && urcs[0] == "RING" && urcs[1] == "+CMTI: \"SM\",3");
+}
+
+static void queueLimits()
+{
+	printf("queue limits and long lines\n");
+	FakeModem modem;
+	Sim800AT at(modem);
+	char tooLong[SIM800_AT_COMMAND_LENGTH + 1];
+	memset(tooLong, 'A', sizeof(tooLong) - 1);
+	tooLong[sizeof(tooLong) - 1] = '\0';
+	CHECK(!at.send(tooLong));
+	for (int i = 0; i < SIM800_AT_QUEUE_SIZE; i++)
+		CHECK(at.send("AT"));
+	CHECK(!at.send("AT"));
+	CHECK(at.pending() == SIM800_AT_QUEUE_SIZE);
+
+	Result cancelled;
+	at.clear();
+	CHECK(at.isIdle());
+	CHECK(at.send("AT+X", record, &cancelled));
+	at.clear();
+	CHECK(cancelled.event == SIM800_AT_CANCELLED);
+
+	// a line longer than the buffer is cut, the command still completes
+	std::string reply = "\r\n+LONG: ";
+	reply.append(200, 'x');
+	reply += "\r\nOK\r\n";
+	const FakeModemStep steps[] = { { "AT+LONG", reply.c_str(), 5 } };
+	modem.script(steps, 1);
+	Result r;
+	CHECK(at.send("AT+LONG", record, &r));
+	run(at, 50);
+	CHECK(r.event == SIM800_AT_OK);
+	CHECK(r.lines.size() == 1 && r.lines[0].size() == SIM800_AT_LINE_LENGTH - 1);
+}
+
+// the next command is queued from the callback of the previous one
+static Sim800AT *chainEngine;
+static Result chainSecond;
+
+static void chain(void *, uint8_t event, const char *)
+{
+	if (event == SIM800_AT_OK)
+		chainEngine->send("AT+CSQ", record, &chainSecond);
+}
+
+static void queueFromCallback()
+{
+	printf("command queued from a callback\n");
+	FakeModem modem;
+	const FakeModemStep steps[] = {
+		{ "AT", "\r\nOK\r\n", 5 },
+		{ "AT+CSQ", "\r\n+CSQ: 20,0\r\n\r\nOK\r\n", 5 },
+	};
+	modem.script(steps, 2);
+	Sim800AT at(modem);
+	chainEngine = &at;
+	CHECK(at.send("AT", chain));
+	run(at, 100);
+	CHECK(modem.done() && modem.unexpected == 0);
+	CHECK(chainSecond.event == SIM800_AT_OK && chainSecond.lines.size() == 1);
+}
+
+int main()
+{
+	information(false);
+	information(true);
+	errors();
+	timeouts();
+	prompt(false, false);
+	prompt(true, false);
+	prompt(true, true);
+	promptTimeout();
+	clearAfterPrompt();
+	unsolicited();
+	queueLimits();
+	queueFromCallback();
+	printf("%d checks, %d failed\n", checks, failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+// Runs the Sim800SMSQueue against FakeModem. millis() advances 1ms per
+// loop() call.
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "FakeModem.h"
+#include "Check.h"
+#include "../../Sim800AT.h"
+#include "../../Sim800SMSQueue.h"
+
+uint32_t fakeMillis = 0;
+EEPROMClass EEPROM;
+
+#define CMGF { "AT+CMGF=1", "\r\nOK\r\n", 10 }
+#define PROMPT "\r\n> "
+#define SENT "\r\n+CMGS: 1\r\n\r\nOK\r\n"
+#define REFUSED "\r\n+CMS ERROR: 500\r\n"
+
+struct Report {
+	uint8_t id;
+	std::string number;
+	bool sent;
+	uint32_t at;
+};
+
+static std::vector<Report> reports;
+
+static void record(uint8_t id, const char *number, bool sent)
+{
+	Report r = { id, number, sent, fakeMillis };
+	reports.push_back(r);
+}
+
+static void run(Sim800SMSQueue &queue, uint32_t ms)
+{
+	for (uint32_t i = 0; i < ms; i++)
+	{
+		queue.loop();
+		fakeMillis++;
+	}
+}
+
+static void burst()
+{
+	printf("one alert to three numbers\n");
+	FakeModem modem;
+	const FakeModemStep steps[] = {
+		CMGF,
+		{ "AT+CMGS=\"+2347065109136\"", PROMPT, 100 },
+		{ "Fire Detected\x1a", SENT, 2000 },
+		{ "AT+CMGS=\"+2349038731345\"", PROMPT, 100 },
+		{ "Fire Detected\x1a", SENT, 2000 },
+		{ "AT+CMGS=\"+2349018431505\"", PROMPT, 100 },
+		{ "Fire Detected\x1a", SENT, 2000 },
+	};
+	modem.script(steps, 7);
+	Sim800AT at(modem);
+	Sim800SMSQueue queue(at);
+	queue.onResult(record);
+	reports.clear();
+
+	uint32_t start = fakeMillis;
+	uint8_t a = queue.send("+2347065109136", "Fire Detected");
+	uint8_t b = queue.send("+2349038731345", "Fire Detected");
+	uint8_t c = queue.send("+2349018431505", "Fire Detected");
+	CHECK(a != 0 && b != 0 && c != 0 && a != b && b != c);
+	CHECK(fakeMillis == start); // send() did not wait for anything
+	CHECK(queue.pending() == 3);
+	CHECK(queue.status(a) == SIM800_SMS_PENDING);
+
+	// the same alert again while it is still waiting: not queued twice
+	CHECK(queue.send("+2349018431505", "Fire Detected") == c);
+	CHECK(queue.pending() == 3);
+
+	run(queue, 50);
+	CHECK(queue.status(a) == SIM800_SMS_SENDING);
+	run(queue, 7000);
+	CHECK(modem.done() && modem.unexpected == 0);
+	CHECK(queue.pending() == 0);
+	CHECK(queue.status(a) == SIM800_SMS_SENT && queue.status(c) == SIM800_SMS_SENT);
+	CHECK(reports.size() == 3 && reports[0].id == a && reports[1].id == b && reports[2].id == c);
+	CHECK(reports.size() == 3 && reports[2].sent && reports[2].number == "+2349018431505");
+	// back to back: every message takes its 2.1s, with no gap in between
+	CHECK(reports.size() == 3 && reports[2].at - start < 10 + 3 * 2100 + 30);
+
+	const Sim800SMSStats &stats = queue.stats();
+	CHECK(stats.queued == 3 && stats.duplicates == 1 && stats.sent == 3);
+	CHECK(stats.failed == 0 && stats.retries == 0 && stats.maxPending == 3);
+	CHECK(queue.averageSendTime() >= 2100 && queue.averageSendTime() < 2130);
+	printf("  3 messages in %lu ms, %lu ms each\n", (unsigned long)(reports.back().at - start),
+		   (unsigned long)queue.averageSendTime());
+}
+
+static void retry()
+{
+	printf("retry after an error, with backoff\n");
+	FakeModem modem;
+	const FakeModemStep steps[] = {
+		CMGF,
+		{ "AT+CMGS=\"+2349022107944\"", PROMPT, 100 },
+		{ "GAS Detected.\x1a", REFUSED, 1000 },
+		CMGF, // set again after a failure
+		{ "AT+CMGS=\"+2349022107944\"", REFUSED, 100 },
+		CMGF,
+		{ "AT+CMGS=\"+2349022107944\"", PROMPT, 100 },
+		{ "GAS Detected.\x1a", SENT, 1000 },
+	};
+	modem.script(steps, 8);
+	Sim800AT at(modem);
+	Sim800SMSQueue queue(at);
+	queue.onResult(record);
+	reports.clear();
+
+	uint8_t id = queue.send("+2349022107944", "GAS Detected.");
+	run(queue, 1200); // first attempt refused at ~1110
+	CHECK(queue.status(id) == SIM800_SMS_PENDING);
+	CHECK(modem.lastWrite == "GAS Detected.\x1a");
+	run(queue, SIM800_SMS_RETRY_DELAY - 200);
+	CHECK(modem.lastWrite == "GAS Detected.\x1a"); // not tried again yet
+	run(queue, 400); // second attempt, refused at once
+	CHECK(modem.lastWrite == "AT+CMGS=\"+2349022107944\"");
+	run(queue, 2 * SIM800_SMS_RETRY_DELAY - 200);
+	CHECK(queue.status(id) == SIM800_SMS_PENDING);
+	run(queue, 1500);
+	CHECK(modem.done() && modem.unexpected == 0);
+	CHECK(queue.status(id) == SIM800_SMS_SENT);
+	CHECK(queue.stats().retries == 2 && queue.stats().sent == 1);
+	CHECK(reports.size() == 1 && reports[0].sent);
+}
+
+static void giveUp()
+{
+	printf("give up after SIM800_SMS_MAX_ATTEMPTS, other messages go on\n");
+	FakeModem modem;
+	std::vector<FakeModemStep> steps;
+	for (int i = 0; i < SIM800_SMS_MAX_ATTEMPTS; i++)
+	{
+		FakeModemStep cmgf = CMGF;
+		FakeModemStep refused = { "AT+CMGS=\"+000\"", REFUSED, 50 };
+		if (i != 1) // text mode is still set after the good message
+			steps.push_back(cmgf);
+		steps.push_back(refused);
+		if (i == 0)
+		{
+			// the good message goes out while the bad one waits
+			FakeModemStep good = { "AT+CMGS=\"+2348068111733\"", PROMPT, 50 };
+			FakeModemStep text = { "Speeding\x1a", SENT, 500 };
+			steps.push_back(cmgf);
+			steps.push_back(good);
+			steps.push_back(text);
+		}
+	}
+	modem.script(&steps[0], steps.size());
+	Sim800AT at(modem);
+	Sim800SMSQueue queue(at);
+	queue.onResult(record);
+	reports.clear();
+
+	uint32_t start = fakeMillis;
+	uint8_t bad = queue.send("+000", "Speeding");
+	uint8_t good = queue.send("+2348068111733", "Speeding");
+	run(queue, 2000);
+	CHECK(queue.status(good) == SIM800_SMS_SENT);
+	CHECK(queue.status(bad) == SIM800_SMS_PENDING);
+	run(queue, 5000 + 10000 + 20000 + 40000);
+	CHECK(modem.done() && modem.unexpected == 0);
+	CHECK(queue.status(bad) == SIM800_SMS_FAILED);
+	CHECK(reports.size() == 2 && reports[1].id == bad && !reports[1].sent);
+	// 4 waits, 5s doubled each time
+	CHECK(reports.size() == 2 && reports[1].at - start >= 75000);
+	CHECK(queue.stats().failed == 1 && queue.stats().retries == SIM800_SMS_MAX_ATTEMPTS - 1);
+
+	// a finished message's slot is reused, the failed one first (oldest)
+	for (int i = 0; i < SIM800_SMS_QUEUE_SIZE; i++)
+	{
+		char text[8];
+		sprintf(text, "n%d", i);
+		CHECK(queue.send("+111", text) != 0);
+	}
+	CHECK(queue.send("+111", "one too many") == 0);
+	CHECK(queue.status(bad) == SIM800_SMS_UNKNOWN && queue.status(good) == SIM800_SMS_UNKNOWN);
+	CHECK(queue.stats().rejected == 1);
+	char tooLong[SIM800_SMS_TEXT_LENGTH + 1];
+	memset(tooLong, 'x', SIM800_SMS_TEXT_LENGTH);
+	tooLong[SIM800_SMS_TEXT_LENGTH] = '\0';
+	CHECK(queue.send("+111", tooLong) == 0);
+}
+
+static void persistence()
+{
+	printf("queue kept in EEPROM over a reset\n");
+	const int address = 100;
+	EEPROMClass blank;
+	EEPROM = blank;
+	uint32_t formatted;
+	{
+		FakeModem modem;
+		const FakeModemStep steps[] = {
+			CMGF,
+			{ "AT+CMGS=\"+2349022107944\"", PROMPT, 100 },
+			{ "GAS Detected.\x1a", NULL, 0 }, // reset while it is sent
+		};
+		modem.script(steps, 3);
+		Sim800AT at(modem);
+		Sim800SMSQueue queue(at);
+		queue.begin(address);
+		formatted = EEPROM.writes;
+		CHECK(queue.send("+2349022107944", "GAS Detected.") != 0);
+		CHECK(queue.send("+2348068111733", "GAS Detected.") != 0);
+		run(queue, 1000);
+		CHECK(modem.done());
+		CHECK(EEPROM.read(address - 1) == 0xFF);
+		CHECK(EEPROM.read(address + Sim800SMSQueue::eepromSize()) == 0xFF);
+	}
+
+	uint32_t writes = EEPROM.writes;
+	FakeModem modem;
+	const FakeModemStep steps[] = {
+		CMGF,
+		{ "AT+CMGS=\"+2349022107944\"", PROMPT, 100 },
+		{ "GAS Detected.\x1a", SENT, 1000 },
+		{ "AT+CMGS=\"+2348068111733\"", PROMPT, 100 },
+		{ "GAS Detected.\x1a", SENT, 1000 },
+	};
+	modem.script(steps, 5);
+	Sim800AT at(modem);
+	Sim800SMSQueue queue(at);
+	queue.onResult(record);
+	reports.clear();
+	queue.begin(address);
+	CHECK(queue.pending() == 2);
+	CHECK(EEPROM.writes == writes); // reading back writes nothing
+	// an alert raised again after the reset is the one already waiting
+	CHECK(queue.send("+2349022107944", "GAS Detected.") != 0);
+	CHECK(queue.stats().duplicates == 1);
+	run(queue, 3000);
+	CHECK(modem.done() && modem.unexpected == 0);
+	CHECK(reports.size() == 2 && reports[0].sent && reports[1].sent);
+
+	// nothing left for the next reset
+	FakeModem idle;
+	Sim800AT at2(idle);
+	Sim800SMSQueue again(at2);
+	again.begin(address);
+	CHECK(again.pending() == 0);
+	printf("  EEPROM bytes written: %lu to set it up, %lu for 2 messages over the reset\n",
+		   (unsigned long)formatted, (unsigned long)(EEPROM.writes - formatted));
+}
+
+int main()
+{
+	burst();
+	retry();
+	giveUp();
+	persistence();
+	printf("%d checks, %d failed\n", checks, failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -29,6 +29,19 @@
 #define TIMEOUT                                                                \
   UINT32_MAX /**< Used programmatically for timeout.                           \
                    Not a timeout duration. Type: uint32_t. */
+#define CAPTURE_TIMEOUT 10000 /**< usec allowed for a whole reply */
+#define REPLY_EDGES 84        /**< edges of a reply without glitches */
+
+/* States of a reading started with startRead(). */
+#define STATE_IDLE 0    /**< nothing in progress */
+#define STATE_START 1   /**< start signal is being sent */
+#define STATE_CAPTURE 2 /**< reply is being captured by edgeISR() */
+#define STATE_DONE 3    /**< result waiting to be returned by poll() */
+
+DHT *DHT::_capturing = NULL;
+volatile uint8_t DHT::_edgecount = 0;
+volatile uint16_t DHT::_lastedge = 0;
+uint8_t DHT::_pulses[DHT_MAX_EDGES];
 
 /*!
  *  @brief  Instantiates a new DHT class
@@ -43,6 +56,8 @@ DHT::DHT(uint8_t pin, uint8_t type, uint8_t count) {
   (void)count; // Workaround to avoid compiler warning.
   _pin = pin;
   _type = type;
+  _state = STATE_IDLE;
+  _result = DHT_READ_IDLE;
 #ifdef __AVR
   _bit = digitalPinToBitMask(pin);
   _port = digitalPinToPort(pin);
@@ -229,6 +244,11 @@ float DHT::computeHeatIndex(float temperature, float percentHumidity,
  *	@return float value
  */
 bool DHT::read(bool force) {
+  // Never interfere with a reading started by startRead().
+  if (_state != STATE_IDLE) {
+    return _lastresult;
+  }
+
   // Check if sensor was read less than two seconds ago and return early
   // to use last reading.
   uint32_t currenttime = millis();
@@ -266,6 +286,15 @@ bool DHT::read(bool force) {
     break;
   }
 
+  return receive();
+}
+
+/*!
+ *  @brief  Receive the reply to a start signal by busy waiting with
+ *          interrupts disabled.
+ *	@return true if 40 bits with a valid checksum were received
+ */
+bool DHT::receive() {
   uint32_t cycles[80];
   {
     // End the start signal by setting data line high for 40 microseconds.
@@ -352,6 +381,182 @@ bool DHT::read(bool force) {
   }
 }
 
+/*!
+ *  @brief  Start a reading without waiting for it. The start signal is timed
+ *          by poll() and the reply is captured by a pin change interrupt, so
+ *          the sketch keeps running while the sensor answers. On pins
+ *          without an external interrupt the reply is received with
+ *          interrupts disabled as in read(), which still saves the 20 ms
+ *          start signal of the DHT11.
+ *  @param  force
+ *          true to start even if the last reading is less than two seconds
+ *          old
+ *	@return true if a reading was started, false if one is in progress,
+ *          the last one is too recent or another DHT is being read
+ */
+bool DHT::startRead(bool force) {
+  if (_state != STATE_IDLE || _capturing != NULL) {
+    return false;
+  }
+  uint32_t currenttime = millis();
+  if (!force && ((currenttime - _lastreadtime) < MIN_INTERVAL)) {
+    return false;
+  }
+  _lastreadtime = currenttime;
+  _capturing = this;
+
+  // The line is already pulled up since begin() or the last reply.
+  pinMode(_pin, OUTPUT);
+  digitalWrite(_pin, LOW);
+  _starttime = micros();
+  _state = STATE_START;
+
+  // The short start signal of the DHT21/22 is not worth a trip through
+  // loop(), and it must not be stretched too much.
+  if (_type == DHT22 || _type == DHT21) {
+    delayMicroseconds(1100);
+    beginCapture();
+  }
+  return true;
+}
+
+/*!
+ *  @brief  Advance a reading started with startRead(). Call it from loop()
+ *          until it stops returning DHT_READ_BUSY; readTemperature() and
+ *          readHumidity() then return the new values without reading the
+ *          sensor again.
+ *	@return DHT_READ_BUSY while the reading is in progress, then once
+ *          DHT_READ_OK, DHT_READ_TIMEOUT or DHT_READ_CHECKSUM, and
+ *          DHT_READ_IDLE when no reading was started
+ */
+uint8_t DHT::poll() {
+  switch (_state) {
+  case STATE_START:
+    if (micros() - _starttime < 20000) {
+      return DHT_READ_BUSY;
+    }
+    beginCapture();
+    return poll();
+  case STATE_CAPTURE: {
+    noInterrupts();
+    uint8_t count = _edgecount;
+    uint16_t last = _lastedge;
+    interrupts();
+    // A reply lasts about 5 ms and ends with the line going high, so it is
+    // complete when all edges arrived and the line has been quiet since.
+    if (micros() - _starttime < CAPTURE_TIMEOUT &&
+        (count < REPLY_EDGES || (uint16_t)((uint16_t)micros() - last) < 200)) {
+      return DHT_READ_BUSY;
+    }
+    _result = endCapture();
+    _state = STATE_DONE;
+  }
+    // fall through
+  case STATE_DONE:
+    _state = STATE_IDLE;
+    return _result;
+  default:
+    return DHT_READ_IDLE;
+  }
+}
+
+/*!
+ *  @brief  End the start signal and capture the reply
+ */
+void DHT::beginCapture() {
+#ifdef digitalPinToInterrupt
+  int irq = digitalPinToInterrupt(_pin);
+#else
+  int irq = -1;
+#endif
+
+  if (irq < 0) {
+    _lastresult = receive();
+    _result = _lastresult ? DHT_READ_OK : DHT_READ_TIMEOUT;
+    _capturing = NULL;
+    _state = STATE_DONE;
+    return;
+  }
+
+  // Listen before releasing the line, so no edge of the reply is missed.
+  // The extra edges this catches are skipped by decode().
+  _edgecount = 0;
+  _lastedge = micros();
+  attachInterrupt(irq, edgeISR, CHANGE);
+  pinMode(_pin, INPUT_PULLUP);
+  _starttime = micros();
+  _state = STATE_CAPTURE;
+}
+
+/*!
+ *  @brief  Stop capturing and decode what was captured
+ *	@return DHT_READ_OK, DHT_READ_TIMEOUT or DHT_READ_CHECKSUM
+ */
+uint8_t DHT::endCapture() {
+#ifdef digitalPinToInterrupt
+  detachInterrupt(digitalPinToInterrupt(_pin));
+#endif
+  uint8_t count = _edgecount;
+  _capturing = NULL;
+
+  if (count < REPLY_EDGES - 3 || count >= DHT_MAX_EDGES) {
+    DEBUG_PRINT(F("DHT timeout, edges captured: "));
+    DEBUG_PRINTLN(count);
+    _lastresult = false;
+    return DHT_READ_TIMEOUT;
+  }
+  _lastresult = decode(_pulses, count);
+  return _lastresult ? DHT_READ_OK : DHT_READ_CHECKSUM;
+}
+
+/*!
+ *  @brief  Turn captured pulse widths into data
+ *  @param  pulses
+ *          usec between consecutive edges, the first one of the reply's
+ *          last 81 belonging to the low pulse of the first bit
+ *  @param  count
+ *          number of pulses, at least 81
+ *	@return true if the checksum matches
+ */
+bool DHT::decode(const uint8_t *pulses, uint8_t count) {
+  // Counting from the end skips any edges before the reply: the last pulse
+  // is the low after bit 39 and each bit is a low/high pair before it.
+  const uint8_t *bits = pulses + count - 81;
+  uint8_t received[5] = {0, 0, 0, 0, 0};
+
+  for (uint8_t i = 0; i < 40; ++i) {
+    received[i / 8] <<= 1;
+    // Same rule as receive(): a high longer than the 50 us low is a 1.
+    if (bits[2 * i + 1] > bits[2 * i]) {
+      received[i / 8] |= 1;
+    }
+  }
+
+  if (received[4] != ((received[0] + received[1] + received[2] + received[3]) &
+                      0xFF)) {
+    DEBUG_PRINTLN(F("DHT checksum failure!"));
+    return false;
+  }
+  for (uint8_t i = 0; i < 5; ++i) {
+    data[i] = received[i];
+  }
+  return true;
+}
+
+/*!
+ *  @brief  Record the time since the previous edge of the line being read
+ */
+void DHT_ISR_ATTR DHT::edgeISR() {
+  uint16_t now = micros();
+  uint8_t count = _edgecount;
+  if (count < DHT_MAX_EDGES) {
+    uint16_t width = now - _lastedge;
+    _pulses[count] = width > 255 ? 255 : width;
+    _edgecount = count + 1;
+  }
+  _lastedge = now;
+}
+
 // Expect the signal line to be at the specified level for a period of time and
 // return a count of loop cycles spent at that level (this cycle count can be
 // used to compare the relative time of two pulses).  If more than a millisecond
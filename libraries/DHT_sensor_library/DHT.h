@@ -47,6 +47,26 @@ static const uint8_t DHT21{21};  /**< DHT TYPE 21 */
 static const uint8_t DHT22{22};  /**< DHT TYPE 22 */
 static const uint8_t AM2301{21}; /**< AM2301 */
 
+/* Results of DHT::poll(). */
+static const uint8_t DHT_READ_IDLE{0};     /**< No reading in progress */
+static const uint8_t DHT_READ_BUSY{1};     /**< Reading in progress */
+static const uint8_t DHT_READ_OK{2};       /**< New values available */
+static const uint8_t DHT_READ_TIMEOUT{3};  /**< Sensor did not answer */
+static const uint8_t DHT_READ_CHECKSUM{4}; /**< Corrupted reply */
+
+/*!
+ * Room for the edges of one reply in DHT::startRead(): the sensor's
+ * response, 40 bits of two edges each and the final release, plus a few for
+ * glitches.
+ */
+#define DHT_MAX_EDGES 88
+
+#if defined(ESP8266) || defined(ESP32)
+#define DHT_ISR_ATTR IRAM_ATTR /**< Interrupt handlers must be in IRAM */
+#else
+#define DHT_ISR_ATTR /**< No attribute needed for interrupt handlers */
+#endif
+
 #if defined(TARGET_NAME) && (TARGET_NAME == ARDUINO_NANO33BLE)
 #ifndef microsecondsToClockCycles
 /*!
@@ -72,10 +92,14 @@ public:
                          bool isFahrenheit = true);
   float readHumidity(bool force = false);
   bool read(bool force = false);
+  bool startRead(bool force = false);
+  uint8_t poll();
 
 private:
   uint8_t data[5];
   uint8_t _pin, _type;
+  uint8_t _state, _result;
+  uint32_t _starttime;
 #ifdef __AVR
   // Use direct GPIO access on an 8-bit AVR so keep track of the port and
   // bitmask for the digital pin connected to the DHT.  Other platforms will use
@@ -87,6 +111,18 @@ private:
   uint8_t pullTime; // Time (in usec) to pull up data line before reading
 
   uint32_t expectPulse(bool level);
+  bool receive();
+  void beginCapture();
+  uint8_t endCapture();
+  bool decode(const uint8_t *pulses, uint8_t count);
+
+  // Only one sensor can capture its reply at a time, so the interrupt handler
+  // and its buffer are shared.
+  static DHT *_capturing;
+  static volatile uint8_t _edgecount;
+  static volatile uint16_t _lastedge;
+  static uint8_t _pulses[DHT_MAX_EDGES];
+  static void DHT_ISR_ATTR edgeISR();
 };
 
 /*!
@@ -0,0 +1,55 @@
+// Example of reading a DHT sensor without stopping the sketch
+// Written for the DHT sensor library, public domain
+
+// REQUIRES the following Arduino libraries:
+// - DHT Sensor Library: https://github.com/adafruit/DHT-sensor-library
+// - Adafruit Unified Sensor Lib: https://github.com/adafruit/Adafruit_Sensor
+
+#include "DHT.h"
+
+#define DHTPIN 2     // Digital pin connected to the DHT sensor
+// Use a pin that supports attachInterrupt() (2 or 3 on an Uno), otherwise
+// the reply is still received with interrupts disabled.
+
+// Uncomment whatever type you're using!
+//#define DHTTYPE DHT11   // DHT 11
+#define DHTTYPE DHT22   // DHT 22  (AM2302), AM2321
+//#define DHTTYPE DHT21   // DHT 21 (AM2301)
+
+DHT dht(DHTPIN, DHTTYPE);
+
+unsigned long loops = 0;
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println(F("DHTxx non-blocking test!"));
+
+  dht.begin();
+}
+
+void loop() {
+  // Starts a new reading every 2 seconds, returns false in between.
+  dht.startRead();
+
+  switch (dht.poll()) {
+  case DHT_READ_OK:
+    // These return the values just received without reading the sensor.
+    Serial.print(F("Humidity: "));
+    Serial.print(dht.readHumidity());
+    Serial.print(F("%  Temperature: "));
+    Serial.print(dht.readTemperature());
+    Serial.print(F("°C  loops since last reading: "));
+    Serial.println(loops);
+    loops = 0;
+    break;
+  case DHT_READ_TIMEOUT:
+    Serial.println(F("DHT sensor did not answer!"));
+    break;
+  case DHT_READ_CHECKSUM:
+    Serial.println(F("DHT reading corrupted!"));
+    break;
+  }
+
+  // The rest of the sketch keeps running while the sensor is being read.
+  loops++;
+}
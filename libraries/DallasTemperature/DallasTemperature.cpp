@@ -44,12 +44,14 @@ DallasTemperature::DallasTemperature() {
     _wire = nullptr;
     devices = 0;
     ds18Count = 0;
+    cachedAddresses = 0;
     parasite = false;
     bitResolution = 9;
     waitForConversion = true;
     checkForConversion = true;
     autoSaveScratchPad = true;
     useExternalPullup = false;
+    resetCRCErrorCounts();
 #if REQUIRESALARMS
     setAlarmHandler(NO_ALARM_HANDLER);
     alarmSearchJunction = -1;
@@ -69,6 +71,7 @@ void DallasTemperature::setOneWire(OneWire* _oneWire) {
     _wire = _oneWire;
     devices = 0;
     ds18Count = 0;
+    cachedAddresses = 0;
     parasite = false;
     bitResolution = 9;
     waitForConversion = true;
@@ -90,11 +93,15 @@ void DallasTemperature::begin(void) {
         _wire->reset_search();
         devices = 0;
         ds18Count = 0;
+        cachedAddresses = 0;
         
         delay(INITIALIZATION_DELAY_MS);
         
         while (_wire->search(deviceAddress)) {
             if (validAddress(deviceAddress)) {
+                if (cachedAddresses < MAX_CACHED_ADDRESSES) {
+                    memcpy(addressCache[cachedAddresses++], deviceAddress, sizeof(DeviceAddress));
+                }
                 devices++;
                 
                 if (validFamily(deviceAddress)) {
@@ -114,6 +121,7 @@ void DallasTemperature::begin(void) {
         
         if (devices > 0) break;
     }
+    resetCRCErrorCounts();
 }
 
 void DallasTemperature::activateExternalPullup() {
@@ -142,21 +150,38 @@ bool DallasTemperature::validAddress(const uint8_t* deviceAddress) {
 }
 
 bool DallasTemperature::getAddress(uint8_t* deviceAddress, uint8_t index) {
+    if (index < cachedAddresses) {
+        memcpy(deviceAddress, addressCache[index], sizeof(DeviceAddress));
+        return true;
+    }
+    
+    // past the cache: walk the bus, counting valid addresses like begin()
     if (index < devices) {
         uint8_t depth = 0;
         
         _wire->reset_search();
         
         while (depth <= index && _wire->search(deviceAddress)) {
-            if (depth == index && validAddress(deviceAddress)) {
-                return true;
+            if (validAddress(deviceAddress)) {
+                if (depth == index) {
+                    return true;
+                }
+                depth++;
             }
-            depth++;
         }
     }
     return false;
 }
 
+int8_t DallasTemperature::cacheIndex(const uint8_t* deviceAddress) {
+    for (uint8_t i = 0; i < cachedAddresses; i++) {
+        if (memcmp(addressCache[i], deviceAddress, sizeof(DeviceAddress)) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 uint8_t DallasTemperature::getDeviceCount(void) {
     return devices;
 }
@@ -288,6 +313,10 @@ int32_t DallasTemperature::getTemp(const uint8_t* deviceAddress, byte retryCount
         if (isConnected(deviceAddress, scratchPad)) {
             return calculateTemperature(deviceAddress, scratchPad);
         }
+        int8_t index = cacheIndex(deviceAddress);
+        if (index >= 0 && crcErrors[index] < 0xFFFF) {
+            crcErrors[index]++;
+        }
     }
     
     return DEVICE_DISCONNECTED_RAW;
@@ -317,12 +346,42 @@ float DallasTemperature::getTempFByIndex(uint8_t index) {
     return getTempF((uint8_t*)deviceAddress);
 }
 
+uint8_t DallasTemperature::readAllTemperatures(float* temperatures, uint8_t size) {
+    // one conversion for the whole bus, then the scratchpads one by one
+    request_t req = requestTemperatures();
+    if (!waitForConversion) {
+        blockTillConversionComplete(bitResolution, req);
+    }
+    
+    // never more than the caller's array holds, the bus may have grown
+    uint8_t count = devices < size ? devices : size;
+    uint8_t valid = 0;
+    DeviceAddress deviceAddress;
+    for (uint8_t i = 0; i < count; i++) {
+        temperatures[i] = DEVICE_DISCONNECTED_C;
+        if (getAddress(deviceAddress, i)) {
+            temperatures[i] = getTempC(deviceAddress);
+        }
+        if (temperatures[i] != DEVICE_DISCONNECTED_C) {
+            valid++;
+        }
+    }
+    return valid;
+}
+
+uint16_t DallasTemperature::getCRCErrorCount(uint8_t index) {
+    return index < cachedAddresses ? crcErrors[index] : 0;
+}
+
+void DallasTemperature::resetCRCErrorCounts(void) {
+    memset(crcErrors, 0, sizeof(crcErrors));
+}
+
 void DallasTemperature::setResolution(uint8_t newResolution) {
     bitResolution = constrain(newResolution, 9, 12);
     DeviceAddress deviceAddress;
-    _wire->reset_search();
     for (uint8_t i = 0; i < devices; i++) {
-        if (_wire->search(deviceAddress) && validAddress(deviceAddress)) {
+        if (getAddress(deviceAddress, i)) {
             setResolution(deviceAddress, bitResolution, true);
         }
     }
@@ -359,10 +418,9 @@ bool DallasTemperature::setResolution(const uint8_t* deviceAddress, uint8_t newR
         bitResolution = newResolution;
         if (devices > 1) {
             DeviceAddress deviceAddr;
-            _wire->reset_search();
             for (uint8_t i = 0; i < devices; i++) {
                 if (bitResolution == 12) break;
-                if (_wire->search(deviceAddr) && validAddress(deviceAddr)) {
+                if (getAddress(deviceAddr, i)) {
                     uint8_t b = getResolution(deviceAddr);
                     if (b > bitResolution) bitResolution = b;
                 }
@@ -499,7 +557,11 @@ DallasTemperature::request_t DallasTemperature::requestTemperaturesByAddress(con
 
 DallasTemperature::request_t DallasTemperature::requestTemperaturesByIndex(uint8_t index) {
     DeviceAddress deviceAddress;
-    getAddress(deviceAddress, index);
+    if (!getAddress(deviceAddress, index)) {
+        request_t req = {};
+        req.result = false;
+        return req;
+    }
     return requestTemperaturesByAddress(deviceAddress);
 }
 
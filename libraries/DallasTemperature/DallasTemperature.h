@@ -1,7 +1,7 @@
 #ifndef DallasTemperature_h
 #define DallasTemperature_h
 
-#define DALLASTEMPLIBVERSION "4.0.5"
+#define DALLASTEMPLIBVERSION "4.1.0"
 
 // Configuration
 #ifndef REQUIRESNEW
@@ -51,6 +51,11 @@
 #define MAX_INITIALIZATION_RETRIES 3
 #define INITIALIZATION_DELAY_MS 50
 
+// Addresses kept by begin(), so the ...ByIndex() calls need no bus search
+#ifndef MAX_CACHED_ADDRESSES
+#define MAX_CACHED_ADDRESSES 8
+#endif
+
 typedef uint8_t DeviceAddress[8];
 
 class DallasTemperature {
@@ -108,6 +113,11 @@ public:
     float getTempCByIndex(uint8_t);
     float getTempFByIndex(uint8_t);
 
+    // Bulk Operations
+    uint8_t readAllTemperatures(float*, uint8_t);
+    uint16_t getCRCErrorCount(uint8_t);
+    void resetCRCErrorCounts(void);
+
     // Conversion Status
     bool isParasitePowerMode(void);
     bool isConversionComplete(void);
@@ -175,11 +185,17 @@ private:
     uint8_t ds18Count;
     OneWire* _wire;
 
+    // Address Cache, in bus search order
+    DeviceAddress addressCache[MAX_CACHED_ADDRESSES];
+    uint16_t crcErrors[MAX_CACHED_ADDRESSES];
+    uint8_t cachedAddresses;
+
     // Internal Methods
     int32_t calculateTemperature(const uint8_t*, uint8_t*);
     bool isAllZeros(const uint8_t* const scratchPad, const size_t length = 9);
     void activateExternalPullup(void);
     void deactivateExternalPullup(void);
+    int8_t cacheIndex(const uint8_t*);
 
 #if REQUIRESALARMS
     uint8_t alarmSearchAddress[8];
@@ -0,0 +1,22 @@
+// Just enough of Arduino.h to build DallasTemperature on a PC. delay()
+// advances the fake clock, yield() moves it by 1ms.
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define ARDUINO 100
+typedef uint8_t byte;
+#define OUTPUT 1
+#define LOW 0
+#define HIGH 1
+#define constrain(a, l, h) ((a) < (l) ? (l) : ((a) > (h) ? (h) : (a)))
+
+extern unsigned long fakeMillis;
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline unsigned long millis() { return fakeMillis; }
+inline void delay(unsigned long ms) { fakeMillis += ms; }
+inline void yield() { fakeMillis++; }
@@ -0,0 +1,21 @@
+// CHECK() for the fake bus tests: counts, and prints the failures.
+
+#ifndef Check_h
+#define Check_h
+
+#include <stdio.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void check(bool ok, const char* what, int line) {
+    checks++;
+    if (!ok) {
+        failures++;
+        printf("  FAILED line %d: %s\n", line, what);
+    }
+}
+
+#endif
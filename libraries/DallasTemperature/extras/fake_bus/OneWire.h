@@ -0,0 +1,101 @@
+// A fake 1-Wire bus of DS18B20s, in place of the OneWire library. It answers
+// the ROM search, Skip ROM and Match ROM, Convert T (0x44) and Read
+// Scratchpad (0xBE), and counts the searches and conversions. A device with
+// corrupt > 0 flips one bit of its next scratchpad reads, so the CRC fails.
+
+#pragma once
+#include "Arduino.h"
+#include <vector>
+
+struct FakeDS18B20 {
+    uint8_t rom[8];
+    uint8_t pad[9];
+    int corrupt;
+};
+
+class OneWire {
+public:
+    std::vector<FakeDS18B20> devices;
+    int searches = 0;   // search() calls
+    int conversions = 0; // Convert T sent with Skip ROM
+
+    OneWire(uint8_t) {}
+
+    static uint8_t crc8(const uint8_t* addr, uint8_t len) {
+        uint8_t crc = 0;
+        while (len--) {
+            uint8_t in = *addr++;
+            for (uint8_t i = 8; i; i--) {
+                uint8_t mix = (crc ^ in) & 0x01;
+                crc >>= 1;
+                if (mix) crc ^= 0x8C;
+                in >>= 1;
+            }
+        }
+        return crc;
+    }
+
+    // a DS18B20 with serial number id reading raw (1/16 degree), 12 bits
+    void add(uint8_t id, int16_t raw) {
+        FakeDS18B20 d = {};
+        d.rom[0] = 0x28;
+        d.rom[1] = id;
+        d.rom[7] = crc8(d.rom, 7);
+        d.pad[0] = raw & 0xFF;
+        d.pad[1] = raw >> 8;
+        d.pad[2] = 75;
+        d.pad[3] = 70;
+        d.pad[4] = 0x7F;
+        d.pad[5] = 0xFF;
+        d.pad[7] = 0x10;
+        d.pad[8] = crc8(d.pad, 8);
+        devices.push_back(d);
+    }
+
+    void reset_search() { searchPos = 0; }
+    bool search(uint8_t* addr) {
+        searches++;
+        if (searchPos >= devices.size()) return false;
+        memcpy(addr, devices[searchPos++].rom, 8);
+        return true;
+    }
+
+    uint8_t reset() {
+        selected = -1;
+        skipped = false;
+        command = 0;
+        return devices.empty() ? 0 : 1;
+    }
+    void skip() { skipped = true; }
+    void select(const uint8_t* addr) {
+        for (size_t i = 0; i < devices.size(); i++) {
+            if (memcmp(devices[i].rom, addr, 8) == 0) selected = i;
+        }
+    }
+
+    void write(uint8_t v, uint8_t = 0) {
+        command = v;
+        readPos = 0;
+        if (v == 0x44 && skipped) conversions++;
+    }
+    uint8_t read() {
+        if (command != 0xBE || selected < 0) return 0xFF;
+        FakeDS18B20& d = devices[selected];
+        uint8_t b = readPos < 9 ? d.pad[readPos] : 0xFF;
+        readPos++;
+        if (d.corrupt > 0 && readPos == 3) {
+            d.corrupt--;
+            b ^= 0x01;
+        }
+        return b;
+    }
+    uint8_t read_bit() { return 1; }  // conversion done, not parasite powered
+    void write_bit(uint8_t) {}
+
+private:
+    size_t searchPos = 0;
+    int selected = -1;
+    bool skipped = false;
+    uint8_t command = 0;
+    int readPos = 0;
+};
@@ -0,0 +1,9 @@
+#!/bin/sh
+# Builds DallasTemperature against the fake 1-Wire bus and runs the checks.
+set -e
+cd "$(dirname "$0")"
+status=0
+g++ -O2 -Wall -I. -o test_fake_bus test_fake_bus.cpp ../../DallasTemperature.cpp
+./test_fake_bus || status=$?
+rm -f test_fake_bus
+exit $status
@@ -0,0 +1,103 @@
+// Runs DallasTemperature against a fake bus of ten DS18B20s, sensor i
+// reading 20 + i degrees. More sensors than MAX_CACHED_ADDRESSES, so the
+// last ones are found by a search.
+
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "OneWire.h"
+#include "Check.h"
+#include "../../DallasTemperature.h"
+
+unsigned long fakeMillis = 0;
+
+static void addressCache() {
+    printf("address cache\n");
+    OneWire bus(2);
+    for (int i = 0; i < 10; i++) bus.add(i, (20 + i) * 16);
+    DallasTemperature sensors(&bus);
+    sensors.begin();
+    CHECK(sensors.getDeviceCount() == 10);
+
+    int searches = bus.searches;
+    for (int i = 0; i < MAX_CACHED_ADDRESSES; i++) {
+        CHECK(sensors.getTempCByIndex(i) == 20 + i);
+    }
+    CHECK(bus.searches == searches);  // cached, no search
+    CHECK(sensors.getTempCByIndex(9) == 29);  // beyond the cache
+    printf("  %d searches for %d sensors\n", bus.searches, 10);
+}
+
+static void readAll() {
+    printf("readAllTemperatures(), one conversion for the bus\n");
+    OneWire bus(2);
+    for (int i = 0; i < 10; i++) bus.add(i, (20 + i) * 16);
+    DallasTemperature sensors(&bus);
+    sensors.begin();
+
+    float t[10];
+    bus.devices[3].corrupt = 1;
+    bus.conversions = 0;
+    CHECK(sensors.readAllTemperatures(t, 10) == 9);
+    CHECK(bus.conversions == 1);
+    CHECK(t[0] == 20);
+    CHECK(t[3] == DEVICE_DISCONNECTED_C);
+    CHECK(t[9] == 29);
+    CHECK(sensors.getCRCErrorCount(3) == 1);
+    CHECK(sensors.getCRCErrorCount(2) == 0);
+
+    sensors.setWaitForConversion(false);
+    CHECK(sensors.readAllTemperatures(t, 10) == 10);
+    CHECK(t[3] == 23);
+}
+
+static void readAllBounded() {
+    printf("readAllTemperatures() with an array shorter than the bus\n");
+    OneWire bus(2);
+    for (int i = 0; i < 10; i++) bus.add(i, (20 + i) * 16);
+    DallasTemperature sensors(&bus);
+    sensors.begin();
+
+    float t[10];
+    for (int i = 0; i < 10; i++) t[i] = -1;
+    CHECK(sensors.readAllTemperatures(t, 4) == 4);
+    CHECK(t[0] == 20 && t[3] == 23);
+    for (int i = 4; i < 10; i++) CHECK(t[i] == -1);  // not written
+    CHECK(sensors.readAllTemperatures(t, 0) == 0);
+}
+
+static void crcRetry() {
+    printf("CRC error, read again\n");
+    OneWire bus(2);
+    for (int i = 0; i < 10; i++) bus.add(i, (20 + i) * 16);
+    DallasTemperature sensors(&bus);
+    sensors.begin();
+
+    bus.devices[5].corrupt = 1;
+    CHECK(sensors.getTempC(bus.devices[5].rom, 1) == 25);
+    CHECK(sensors.getCRCErrorCount(5) == 1);
+    sensors.resetCRCErrorCounts();
+    CHECK(sensors.getCRCErrorCount(5) == 0);
+}
+
+static void emptyBus() {
+    printf("empty bus\n");
+    OneWire bus(3);
+    DallasTemperature sensors(&bus);
+    sensors.begin();
+    float t[4];
+    CHECK(sensors.getDeviceCount() == 0);
+    CHECK(sensors.readAllTemperatures(t, 4) == 0);
+    CHECK(sensors.getCRCErrorCount(0) == 0);
+    CHECK(!sensors.requestTemperaturesByIndex(0));
+}
+
+int main() {
+    addressCache();
+    readAll();
+    readAllBounded();
+    crcRetry();
+    emptyBus();
+    printf("%d checks, %d failed\n", checks, failures);
+    return failures ? 1 : 0;
+}
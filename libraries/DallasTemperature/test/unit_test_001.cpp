@@ -73,4 +73,21 @@ unittest(test_temperature_read) {
     assertEqual(DEVICE_DISCONNECTED_C, tempC); // Simulated no device connected
 }
 
+// Bulk read and CRC error counts with no device on the bus
+unittest(test_read_all_temperatures) {
+    OneWire oneWire(ONE_WIRE_BUS);
+    DallasTemperature sensors(&oneWire);
+
+    sensors.begin();
+
+    float temperatures[MAX_CACHED_ADDRESSES];
+    assertEqual(0, sensors.readAllTemperatures(temperatures, MAX_CACHED_ADDRESSES));
+    assertEqual(0, sensors.getCRCErrorCount(0));
+    assertEqual(0, sensors.getCRCErrorCount(MAX_CACHED_ADDRESSES));
+
+    DeviceAddress deviceAddress;
+    assertFalse(sensors.getAddress(deviceAddress, 0));
+    assertFalse(sensors.requestTemperaturesByIndex(0));
+}
+
 unittest_main()
\ No newline at end of file
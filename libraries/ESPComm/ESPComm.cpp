@@ -3,6 +3,12 @@
 ESPComm::ESPComm(Stream &serial) {
   _serial = &serial;
   _callback = nullptr;
+  _fieldCallback = nullptr;
+  _frameCallback = nullptr;
+  _rxState = RX_IDLE;
+  _txLength = 0;
+  _frames = 0;
+  _errors = 0;
 }
 
 void ESPComm::begin(long baud) {
@@ -30,16 +36,154 @@ void ESPComm::begin(long baud) {
 #endif
 }
 
+// Reads what has arrived so far, one byte at a time, and dispatches complete
+// text lines and binary frames. A line starting with ESPCOMM_SYNC is a binary
+// frame; text never starts with that byte.
 void ESPComm::loop() {
-  if (_serial->available()) {
-    String cmd = _serial->readStringUntil('\n');
-    int sepIndex = cmd.indexOf('=');
-
-    if (sepIndex != -1 && _callback) {
-      String key = cmd.substring(0, sepIndex);
-      String value = cmd.substring(sepIndex + 1);
-      _callback(key, value);
+  while (_serial->available()) {
+    int c = _serial->read();
+    if (c < 0) break;
+    receive(c);
+  }
+}
+
+void ESPComm::receive(uint8_t c) {
+  switch (_rxState) {
+    case RX_IDLE:
+      if (c == ESPCOMM_SYNC) {
+        _rxState = RX_LENGTH;
+        break;
+      }
+      _rxState = RX_TEXT;
+      // fall through
+    case RX_TEXT:
+      if (c == '\n') {
+        dispatchLine();
+        _line = "";
+        _rxState = RX_IDLE;
+      } else if (_line.length() < ESPCOMM_MAX_LINE) {
+        _line += (char)c;
+      } else {
+        _errors++;
+        _line = "";
+        _rxState = RX_HUNT;
+      }
+      break;
+
+    case RX_HUNT:
+      // After a bad frame or line: skip to the next frame or line
+      if (c == ESPCOMM_SYNC) {
+        _rxState = RX_LENGTH;
+      } else if (c == '\n') {
+        _rxState = RX_IDLE;
+      }
+      break;
+
+    case RX_LENGTH:
+      if (c > ESPCOMM_MAX_PAYLOAD) {
+        _errors++;
+        _rxState = RX_HUNT;
+        break;
+      }
+      _rxLength = c;
+      _rxCrc = crc16(0xFFFF, c);
+      _rxState = RX_TYPE;
+      break;
+
+    case RX_TYPE:
+      _rxType = c;
+      _rxCrc = crc16(_rxCrc, c);
+      _rxCount = 0;
+      _rxState = _rxLength ? RX_PAYLOAD : RX_CRC_LOW;
+      break;
+
+    case RX_PAYLOAD:
+      _rxBuffer[_rxCount++] = c;
+      _rxCrc = crc16(_rxCrc, c);
+      if (_rxCount == _rxLength) _rxState = RX_CRC_LOW;
+      break;
+
+    case RX_CRC_LOW:
+      _rxCrc ^= c;
+      _rxState = RX_CRC_HIGH;
+      break;
+
+    case RX_CRC_HIGH:
+      _rxCrc ^= (uint16_t)c << 8;
+      if (_rxCrc == 0) {
+        _rxState = RX_IDLE;
+        _frames++;
+        dispatchFrame();
+      } else {
+        _rxState = RX_HUNT;
+        _errors++;
+      }
+      break;
+  }
+}
+
+void ESPComm::dispatchLine() {
+  int sepIndex = _line.indexOf('=');
+
+  if (sepIndex != -1 && _callback) {
+    String key = _line.substring(0, sepIndex);
+    String value = _line.substring(sepIndex + 1);
+    _callback(key, value);
+  }
+}
+
+void ESPComm::dispatchFrame() {
+  if (_rxType != ESPCOMM_FRAME_FIELDS) {
+    if (_frameCallback) _frameCallback(_rxType, _rxBuffer, _rxLength);
+    return;
+  }
+
+  // The fields point into _rxBuffer, nothing is copied
+  uint8_t pos = 0;
+  while (pos < _rxLength) {
+    ESPCommField field;
+    uint8_t size;
+
+    if (_rxLength - pos < 2) {
+      _errors++;
+      return;
+    }
+    field.id = _rxBuffer[pos];
+    field.type = _rxBuffer[pos + 1];
+    pos += 2;
+
+    switch (field.type) {
+      case ESPCOMM_BOOL:
+      case ESPCOMM_INT8:
+      case ESPCOMM_UINT8:
+        size = 1;
+        break;
+      case ESPCOMM_INT16:
+      case ESPCOMM_UINT16:
+        size = 2;
+        break;
+      case ESPCOMM_INT32:
+      case ESPCOMM_UINT32:
+      case ESPCOMM_FLOAT:
+        size = 4;
+        break;
+      case ESPCOMM_STRING:
+        size = pos < _rxLength ? _rxBuffer[pos++] : 0xFF;
+        break;
+      default:
+        _errors++;
+        return;
+    }
+
+    if (size > _rxLength - pos) {
+      _errors++;
+      return;
     }
+    field.data = _rxBuffer + pos;
+    field.length = size;
+    pos += size;
+
+    if (_fieldCallback) _fieldCallback(field);
   }
 }
 
@@ -47,6 +191,14 @@ void ESPComm::onCommand(void (*callback)(String key, String value)) {
   _callback = callback;
 }
 
+void ESPComm::onField(void (*callback)(const ESPCommField &field)) {
+  _fieldCallback = callback;
+}
+
+void ESPComm::onFrame(void (*callback)(uint8_t type, const uint8_t *payload, uint8_t length)) {
+  _frameCallback = callback;
+}
+
 // -------- Sending --------
 void ESPComm::send(String key, int value) {
   _serial->print(key);
@@ -68,3 +220,122 @@ void ESPComm::send(String key, String value) {
   _serial->print(value);
   _serial->print('\n');
 }
+
+// -------- Binary frames --------
+// CRC-16/CCITT, one byte at a time
+uint16_t ESPComm::crc16(uint16_t crc, uint8_t data) {
+  crc ^= (uint16_t)data << 8;
+  for (uint8_t i = 0; i < 8; i++) {
+    crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+bool ESPComm::sendFrame(uint8_t type, const uint8_t *payload, uint8_t length) {
+  if (length > ESPCOMM_MAX_PAYLOAD) return false;
+
+  uint8_t header[3] = {ESPCOMM_SYNC, length, type};
+  uint16_t crc = crc16(crc16(0xFFFF, length), type);
+  for (uint8_t i = 0; i < length; i++) crc = crc16(crc, payload[i]);
+  uint8_t trailer[2] = {(uint8_t)crc, (uint8_t)(crc >> 8)};
+
+  _serial->write(header, sizeof(header));
+  _serial->write(payload, length);
+  _serial->write(trailer, sizeof(trailer));
+  return true;
+}
+
+bool ESPComm::send(uint8_t id, const char *value) {
+  beginFrame();
+  bool fits = add(id, value);
+  return endFrame() && fits;
+}
+
+void ESPComm::beginFrame() {
+  _txLength = 0;
+}
+
+// Strings longer than 255 characters or than what is left of the frame are not added
+bool ESPComm::add(uint8_t id, const char *value) {
+  size_t length = strlen(value);
+  if (length > 255 || _txLength + 3 + length > ESPCOMM_MAX_PAYLOAD) return false;
+
+  _txBuffer[_txLength++] = id;
+  _txBuffer[_txLength++] = ESPCOMM_STRING;
+  _txBuffer[_txLength++] = length;
+  memcpy(_txBuffer + _txLength, value, length);
+  _txLength += length;
+  return true;
+}
+
+bool ESPComm::endFrame() {
+  if (_txLength == 0) return false;
+
+  bool sent = sendFrame(ESPCOMM_FRAME_FIELDS, _txBuffer, _txLength);
+  _txLength = 0;
+  return sent;
+}
+
+// -------- Received fields --------
+static uint32_t readLittleEndian(const uint8_t *data, uint8_t length) {
+  uint32_t value = 0;
+  for (uint8_t i = 0; i < length && i < 4; i++) value |= (uint32_t)data[i] << (8 * i);
+  return value;
+}
+
+long ESPCommField::toInt() const {
+  switch (type) {
+    case ESPCOMM_INT8:
+      return (int8_t)data[0];
+    case ESPCOMM_INT16:
+      return (int16_t)(data[0] | (uint16_t)data[1] << 8);
+    case ESPCOMM_INT32:
+      return (int32_t)readLittleEndian(data, length);
+    case ESPCOMM_FLOAT:
+      return (long)toFloat();
+    case ESPCOMM_STRING:
+      return toString().toInt();
+    default:
+      return (long)readLittleEndian(data, length);
+  }
+}
+
+unsigned long ESPCommField::toUInt() const {
+  if (type == ESPCOMM_FLOAT) return (unsigned long)toFloat();
+  if (type == ESPCOMM_STRING) return (unsigned long)toString().toInt();
+
+  return readLittleEndian(data, length);
+}
+
+float ESPCommField::toFloat() const {
+  if (type == ESPCOMM_STRING) return toString().toFloat();
+  if (type != ESPCOMM_FLOAT) return type == ESPCOMM_UINT32 ? (float)toUInt() : (float)toInt();
+
+  uint32_t bits = readLittleEndian(data, length);
+  float value;
+  memcpy(&value, &bits, 4);
+  return value;
+}
+
+String ESPCommField::toString() const {
+  if (type != ESPCOMM_STRING) {
+    if (type == ESPCOMM_FLOAT) return String(toFloat(), 2);
+    if (type == ESPCOMM_UINT32) return String(toUInt());
+    return String(toInt());
+  }
+
+  String value;
+  value.reserve(length);
+  for (uint8_t i = 0; i < length; i++) value += (char)data[i];
+  return value;
+}
+
+uint8_t ESPCommField::copyString(char *buffer, uint8_t size) const {
+  if (size == 0) return 0;
+
+  uint8_t n = type == ESPCOMM_STRING ? length : 0;
+  if (n > size - 1) n = size - 1;
+  memcpy(buffer, data, n);
+  buffer[n] = '\0';
+  return n;
+}
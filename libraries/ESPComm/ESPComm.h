@@ -3,22 +3,161 @@
 
 #include <Arduino.h>
 
+// Binary frames:
+//   ESPCOMM_SYNC | length | type | payload (length bytes) | CRC-16 (2 bytes)
+// The CRC (CCITT, initial value 0xFFFF) covers length, type and payload;
+// multi-byte values, the CRC included, are little-endian.
+// Frames of type ESPCOMM_FRAME_FIELDS carry one or more fields:
+//   id | value type | value (1, 2 or 4 bytes, or length + characters for strings)
+// Other frame types are free for the sketch, see sendFrame() and onFrame().
+#define ESPCOMM_SYNC 0xA5
+#define ESPCOMM_FRAME_FIELDS 0x00
+
+// Largest payload; the receive and the batch buffers are this size.
+#ifndef ESPCOMM_MAX_PAYLOAD
+#define ESPCOMM_MAX_PAYLOAD 64
+#endif
+
+// Longest text line, longer ones are dropped.
+#ifndef ESPCOMM_MAX_LINE
+#define ESPCOMM_MAX_LINE 256
+#endif
+
+#if ESPCOMM_MAX_PAYLOAD < 8 || ESPCOMM_MAX_PAYLOAD > 255
+#error "ESPCOMM_MAX_PAYLOAD must be between 8 and 255"
+#endif
+
+enum ESPCommType {
+  ESPCOMM_BOOL = 0,
+  ESPCOMM_INT8,
+  ESPCOMM_UINT8,
+  ESPCOMM_INT16,
+  ESPCOMM_UINT16,
+  ESPCOMM_INT32,
+  ESPCOMM_UINT32,
+  ESPCOMM_FLOAT,
+  ESPCOMM_STRING
+};
+
+// One received field. data points into the receive buffer and is only
+// valid during the callback.
+struct ESPCommField {
+  uint8_t id;
+  uint8_t type;          // ESPCommType
+  const uint8_t* data;   // little-endian value, or the characters of a string
+  uint8_t length;        // bytes at data
+
+  long toInt() const;
+  unsigned long toUInt() const;
+  float toFloat() const;
+  String toString() const;
+  uint8_t copyString(char* buffer, uint8_t size) const;  // NUL terminated, returns the length
+};
+
+// Maps the arithmetic types to their ESPCommType, by size so that int and
+// long work the same on AVR and ESP.
+template <typename T> struct ESPCommTypeOf;
+template <> struct ESPCommTypeOf<bool> { enum { type = ESPCOMM_BOOL }; };
+template <> struct ESPCommTypeOf<char> { enum { type = ESPCOMM_INT8 }; };
+template <> struct ESPCommTypeOf<signed char> { enum { type = ESPCOMM_INT8 }; };
+template <> struct ESPCommTypeOf<unsigned char> { enum { type = ESPCOMM_UINT8 }; };
+template <> struct ESPCommTypeOf<short> { enum { type = sizeof(short) == 2 ? ESPCOMM_INT16 : ESPCOMM_INT32 }; };
+template <> struct ESPCommTypeOf<unsigned short> { enum { type = sizeof(short) == 2 ? ESPCOMM_UINT16 : ESPCOMM_UINT32 }; };
+template <> struct ESPCommTypeOf<int> { enum { type = sizeof(int) == 2 ? ESPCOMM_INT16 : ESPCOMM_INT32 }; };
+template <> struct ESPCommTypeOf<unsigned int> { enum { type = sizeof(int) == 2 ? ESPCOMM_UINT16 : ESPCOMM_UINT32 }; };
+template <> struct ESPCommTypeOf<long> { enum { type = ESPCOMM_INT32 }; };
+template <> struct ESPCommTypeOf<unsigned long> { enum { type = ESPCOMM_UINT32 }; };
+template <> struct ESPCommTypeOf<float> { enum { type = ESPCOMM_FLOAT }; };
+template <> struct ESPCommTypeOf<double> { enum { type = ESPCOMM_FLOAT }; };  // sent as float
+
 class ESPComm {
  public:
   ESPComm(Stream& serial);  // constructor with HardwareSerial or SoftwareSerial
 
   void begin(long baud);  // start serial
-  void loop();            // must be called in main loop()
+  void loop();            // must be called in main loop(), never blocks
   void onCommand(void (*callback)(String key, String value));
 
-  // send different datatypes
+  // send different datatypes as key=value text lines
   void send(String key, int value);
   void send(String key, float value, int precision = 2);
   void send(String key, String value);
 
+  // binary frames, received by a peer in either mode
+  void onField(void (*callback)(const ESPCommField& field));
+  void onFrame(void (*callback)(uint8_t type, const uint8_t* payload, uint8_t length));
+
+  // one field in its own frame
+  template <typename T>
+  bool send(uint8_t id, T value) {
+    uint8_t field[6];
+    uint8_t length = encodeField(field, id, (uint8_t)ESPCommTypeOf<T>::type, value);
+    return sendFrame(ESPCOMM_FRAME_FIELDS, field, length);
+  }
+  bool send(uint8_t id, const char* value);
+  bool send(uint8_t id, char* value) { return send(id, (const char*)value); }  // char buffers, not the template
+  bool send(uint8_t id, const String& value) { return send(id, value.c_str()); }
+
+  // several fields in one frame: beginFrame(), add() for each, endFrame()
+  void beginFrame();
+  template <typename T>
+  bool add(uint8_t id, T value) {
+    if (_txLength + 6 > ESPCOMM_MAX_PAYLOAD) return false;
+    _txLength += encodeField(_txBuffer + _txLength, id, (uint8_t)ESPCommTypeOf<T>::type, value);
+    return true;
+  }
+  bool add(uint8_t id, const char* value);
+  bool add(uint8_t id, char* value) { return add(id, (const char*)value); }
+  bool add(uint8_t id, const String& value) { return add(id, value.c_str()); }
+  bool endFrame();  // false if nothing was added
+
+  bool sendFrame(uint8_t type, const uint8_t* payload, uint8_t length);
+
+  unsigned long getFrameCount() const { return _frames; }  // good frames received
+  unsigned long getErrorCount() const { return _errors; }  // CRC, length, field and line errors
+
  private:
+  enum RxState { RX_IDLE, RX_TEXT, RX_LENGTH, RX_TYPE, RX_PAYLOAD, RX_CRC_LOW, RX_CRC_HIGH, RX_HUNT };
+
   Stream* _serial;
   void (*_callback)(String, String);
+  void (*_fieldCallback)(const ESPCommField&);
+  void (*_frameCallback)(uint8_t, const uint8_t*, uint8_t);
+
+  String _line;
+  uint8_t _rxState;
+  uint8_t _rxType;
+  uint8_t _rxLength;
+  uint8_t _rxCount;
+  uint16_t _rxCrc;
+  uint8_t _rxBuffer[ESPCOMM_MAX_PAYLOAD];
+  uint8_t _txBuffer[ESPCOMM_MAX_PAYLOAD];
+  uint8_t _txLength;
+  unsigned long _frames;
+  unsigned long _errors;
+
+  void receive(uint8_t c);
+  void dispatchLine();
+  void dispatchFrame();
+  static uint16_t crc16(uint16_t crc, uint8_t data);
+
+  template <typename T>
+  static uint8_t encodeField(uint8_t* out, uint8_t id, uint8_t type, T value) {
+    uint32_t bits;
+    uint8_t size;
+    if (type == ESPCOMM_FLOAT) {
+      float f = value;
+      memcpy(&bits, &f, 4);
+      size = 4;
+    } else {
+      bits = (uint32_t)(long)value;
+      size = type <= ESPCOMM_UINT8 ? 1 : type <= ESPCOMM_UINT16 ? 2 : 4;
+    }
+    out[0] = id;
+    out[1] = type;
+    for (uint8_t i = 0; i < size; i++) out[2 + i] = bits >> (8 * i);
+    return 2 + size;
+  }
 };
 
 #endif
@@ -0,0 +1,84 @@
+#include <ESPComm.h>
+
+// Binary frames: fields are sent by id instead of by name, several fields
+// can share one frame and every frame is checked with a CRC. The receiving
+// side is the same sketch on the other board (or both, as here).
+ESPComm esp(Serial);
+
+// Field ids, the same on both boards
+enum {
+  ID_LEVEL = 1,
+  ID_GAS,
+  ID_TEMPERATURE,
+  ID_STATUS,
+  ID_UPTIME
+};
+
+void handleField(const ESPCommField& field) {
+  switch (field.id) {
+    case ID_LEVEL:
+      Serial.print("Received level: ");
+      Serial.println(field.toInt());
+      break;
+    case ID_GAS:
+      Serial.print("Received gas: ");
+      Serial.println(field.toInt());
+      break;
+    case ID_TEMPERATURE:
+      Serial.print("Received temperature: ");
+      Serial.println(field.toFloat());
+      break;
+    case ID_STATUS: {
+      char status[16];
+      field.copyString(status, sizeof(status));
+      Serial.print("Received status: ");
+      Serial.println(status);
+      break;
+    }
+    case ID_UPTIME: {
+      char uptime[16];
+      field.copyString(uptime, sizeof(uptime));
+      Serial.print("Received uptime: ");
+      Serial.println(uptime);
+      break;
+    }
+  }
+}
+
+// Text commands still work alongside the frames
+void handleCommand(String key, String value) {
+  Serial.print(key);
+  Serial.print(" -> ");
+  Serial.println(value);
+}
+
+void setup() {
+  Serial.begin(9600);
+  esp.onField(handleField);
+  esp.onCommand(handleCommand);
+}
+
+void loop() {
+  esp.loop();  // never waits for a whole line or frame
+
+  static unsigned long lastSend = 0;
+  if (millis() - lastSend > 2000) {
+    // text built in a char buffer goes as a string too
+    char uptime[16];
+    snprintf(uptime, sizeof(uptime), "%lus", millis() / 1000);
+
+    // all readings in one frame
+    esp.beginFrame();
+    esp.add(ID_LEVEL, (int)random(0, 100));
+    esp.add(ID_GAS, (int)random(0, 100));
+    esp.add(ID_TEMPERATURE, 25.5f);
+    esp.add(ID_STATUS, "OK");
+    esp.add(ID_UPTIME, uptime);
+    esp.endFrame();
+
+    // or one field per frame
+    esp.send(ID_LEVEL, (int)random(0, 100));
+    esp.send(ID_UPTIME, uptime);
+    lastSend = millis();
+  }
+}
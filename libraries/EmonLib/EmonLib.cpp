@@ -28,6 +28,9 @@ void EnergyMonitor::voltage(unsigned int _inPinV, double _VCAL, double _PHASECAL
   VCAL = _VCAL;
   PHASECAL = _PHASECAL;
   offsetV = ADC_COUNTS>>1;
+  #if EMONLIB_FIXED_POINT
+  offsetVQ = (int32_t)(ADC_COUNTS>>1) << 16;
+  #endif
 }
 
 void EnergyMonitor::current(unsigned int _inPinI, double _ICAL)
@@ -35,6 +38,9 @@ void EnergyMonitor::current(unsigned int _inPinI, double _ICAL)
   inPinI = _inPinI;
   ICAL = _ICAL;
   offsetI = ADC_COUNTS>>1;
+  #if EMONLIB_FIXED_POINT
+  offsetIQ = (int32_t)(ADC_COUNTS>>1) << 16;
+  #endif
 }
 
 //--------------------------------------------------------------------------------------
@@ -46,6 +52,9 @@ void EnergyMonitor::voltageTX(double _VCAL, double _PHASECAL)
   VCAL = _VCAL;
   PHASECAL = _PHASECAL;
   offsetV = ADC_COUNTS>>1;
+  #if EMONLIB_FIXED_POINT
+  offsetVQ = (int32_t)(ADC_COUNTS>>1) << 16;
+  #endif
 }
 
 void EnergyMonitor::currentTX(unsigned int _channel, double _ICAL)
@@ -55,6 +64,9 @@ void EnergyMonitor::currentTX(unsigned int _channel, double _ICAL)
   if (_channel == 3) inPinI = 1;
   ICAL = _ICAL;
   offsetI = ADC_COUNTS>>1;
+  #if EMONLIB_FIXED_POINT
+  offsetIQ = (int32_t)(ADC_COUNTS>>1) << 16;
+  #endif
 }
 
 //--------------------------------------------------------------------------------------
@@ -74,6 +86,10 @@ void EnergyMonitor::calcVI(unsigned int crossings, unsigned int timeout)
   unsigned int crossCount = 0;                             //Used to measure number of times threshold is crossed.
   unsigned int numberOfSamples = 0;                        //This is now incremented
 
+  #if EMONLIB_FIXED_POINT
+  int16_t phaseCalQ = PHASECAL * 256 + 0.5;               //Phase calibration with 8 fraction bits
+  #endif
+
   //-------------------------------------------------------------------------------------------------------------------------
   // 1) Waits for the waveform to be close to 'zero' (mid-scale adc) part in sin curve.
   //-------------------------------------------------------------------------------------------------------------------------
@@ -96,7 +112,6 @@ void EnergyMonitor::calcVI(unsigned int crossings, unsigned int timeout)
   while ((crossCount < crossings) && ((millis()-start)<timeout))
   {
     numberOfSamples++;                       //Count number of times looped.
-    lastFilteredV = filteredV;               //Used for delay/phase compensation
 
     //-----------------------------------------------------------------------------
     // A) Read in raw voltage and current samples
@@ -104,6 +119,25 @@ void EnergyMonitor::calcVI(unsigned int crossings, unsigned int timeout)
     sampleV = analogRead(inPinV);                 //Read in raw voltage signal
     sampleI = analogRead(inPinI);                 //Read in raw current signal
 
+  #if EMONLIB_FIXED_POINT
+    //-----------------------------------------------------------------------------
+    // B-F) Same steps as below in integer arithmetic. The offsets carry 16
+    //      fraction bits, filtered samples EMONLIB_FRAC_BITS and PHASECAL 8.
+    //-----------------------------------------------------------------------------
+    lastFilteredVQ = filteredVQ;
+    offsetVQ += (((int32_t)sampleV << 16) - offsetVQ) >> 10;
+    filteredVQ = (((int32_t)sampleV << 16) - offsetVQ) >> (16 - EMONLIB_FRAC_BITS);
+    offsetIQ += (((int32_t)sampleI << 16) - offsetIQ) >> 10;
+    filteredIQ = (((int32_t)sampleI << 16) - offsetIQ) >> (16 - EMONLIB_FRAC_BITS);
+
+    sumVQ += (int32_t)filteredVQ * filteredVQ;
+    sumIQ += (int32_t)filteredIQ * filteredIQ;
+
+    int32_t phaseShiftedVQ = lastFilteredVQ + (((int32_t)phaseCalQ * (filteredVQ - lastFilteredVQ)) >> 8);
+    sumPQ += phaseShiftedVQ * filteredIQ;
+  #else
+    lastFilteredV = filteredV;               //Used for delay/phase compensation
+
     //-----------------------------------------------------------------------------
     // B) Apply digital low pass filters to extract the 2.5 V or 1.65 V dc offset,
     //     then subtract this - signal is now centred on 0 counts.
@@ -135,6 +169,7 @@ void EnergyMonitor::calcVI(unsigned int crossings, unsigned int timeout)
     //-----------------------------------------------------------------------------
     instP = phaseShiftedV * filteredI;          //Instantaneous Power
     sumP +=instP;                               //Sum
+  #endif
 
     //-----------------------------------------------------------------------------
     // G) Find the number of times the voltage has crossed the initial voltage
@@ -155,6 +190,15 @@ void EnergyMonitor::calcVI(unsigned int crossings, unsigned int timeout)
   //Calculation of the root of the mean of the voltage and current squared (rms)
   //Calibration coefficients applied.
 
+  #if EMONLIB_FIXED_POINT
+  sumV = sumVQ / (double)(1L << (2 * EMONLIB_FRAC_BITS));
+  sumI = sumIQ / (double)(1L << (2 * EMONLIB_FRAC_BITS));
+  sumP = sumPQ / (double)(1L << (2 * EMONLIB_FRAC_BITS));
+  sumVQ = 0;
+  sumIQ = 0;
+  sumPQ = 0;
+  #endif
+
   double V_RATIO = VCAL *((SupplyVoltage/1000.0) / (ADC_COUNTS));
   Vrms = V_RATIO * sqrt(sumV / numberOfSamples);
 
@@ -188,6 +232,17 @@ double EnergyMonitor::calcIrms(unsigned int Number_of_Samples)
   {
     sampleI = analogRead(inPinI);
 
+  #if EMONLIB_FIXED_POINT
+    // Integer low pass filter and square, see calcVI()
+    offsetIQ += (((int32_t)sampleI << 16) - offsetIQ) >> 10;
+    filteredIQ = (((int32_t)sampleI << 16) - offsetIQ) >> (16 - EMONLIB_FRAC_BITS);
+    sumIQ += (int32_t)filteredIQ * filteredIQ;
+  }
+
+  sumI = sumIQ / (double)(1L << (2 * EMONLIB_FRAC_BITS));
+  sumIQ = 0;
+  #else
+
     // Digital low pass filter extracts the 2.5 V or 1.65 V dc offset,
     //  then subtract this - signal is now centered on 0 counts.
     offsetI = (offsetI + (sampleI-offsetI)/1024);
@@ -199,6 +254,7 @@ double EnergyMonitor::calcIrms(unsigned int Number_of_Samples)
     // 2) sum
     sumI += sqI;
   }
+  #endif
 
   double I_RATIO = ICAL *((SupplyVoltage/1000.0) / (ADC_COUNTS));
   Irms = I_RATIO * sqrt(sumI / Number_of_Samples);
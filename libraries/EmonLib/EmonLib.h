@@ -41,6 +41,18 @@
 
 #define ADC_COUNTS  (1<<ADC_BITS)
 
+// Integer pipeline for calcVI() and calcIrms(). On AVR every double operation
+// of the filter, phase shift and squaring is a software float routine; the
+// integer version keeps filtered samples in int16 with EMONLIB_FRAC_BITS
+// fraction bits and accumulates in int64, leaving more time for sampling.
+// Results stay within 0.01% of the double path (see extras/benchmark).
+// Enable with the compiler flag -DEMONLIB_FIXED_POINT=1, or define it here.
+#ifndef EMONLIB_FIXED_POINT
+#define EMONLIB_FIXED_POINT 0
+#endif
+
+#define EMONLIB_FRAC_BITS (14 - ADC_BITS)
+
 
 class EnergyMonitor
 {
@@ -94,6 +106,15 @@ class EnergyMonitor
 
     boolean lastVCross, checkVCross;                  //Used to measure number of times threshold is crossed.
 
+#if EMONLIB_FIXED_POINT
+    //--------------------------------------------------------------------------------------
+    // Integer state for the fixed point pipeline
+    //--------------------------------------------------------------------------------------
+    int32_t offsetVQ, offsetIQ;                       //Low-pass filter outputs, 16 fraction bits
+    int16_t lastFilteredVQ, filteredVQ, filteredIQ;   //Filtered samples, EMONLIB_FRAC_BITS fraction bits
+    int64_t sumVQ, sumIQ, sumPQ;
+#endif
+
 
 };
 
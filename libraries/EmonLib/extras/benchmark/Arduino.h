@@ -0,0 +1,27 @@
+// Minimal Arduino stand-in for running EmonLib on a desktop machine.
+// analogRead() returns a simulated 50 Hz voltage and current waveform and
+// every conversion advances the simulated clock by one AVR conversion time.
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define ARDUINO 100
+
+typedef bool boolean;
+
+unsigned long millis();
+int analogRead(unsigned int pin);
+void delay(unsigned long ms);
+
+struct SerialStub
+{
+  template <class T> void print(T value) { (void)value; }
+  template <class T> void println(T value) { (void)value; }
+};
+extern SerialStub Serial;
+
+#endif
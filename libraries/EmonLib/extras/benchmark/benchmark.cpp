@@ -0,0 +1,99 @@
+// Host benchmark for the double and integer (EMONLIB_FIXED_POINT) paths of
+// EnergyMonitor::calcVI() and calcIrms(). Build and run both with ./run.sh.
+
+#include <chrono>
+#include <stdlib.h>
+
+#include "Arduino.h"
+#include "../../EmonLib.h"
+
+#define PIN_V 2
+#define PIN_I 1
+#define CONVERSION_US 104.0        // analogRead() on a 16 MHz AVR
+#define FREQUENCY 50.0
+#define PHASE (M_PI / 6)            // current lags voltage by 30 degrees
+#define AMPLITUDE_V 300.0
+#define AMPLITUDE_I 120.0
+
+#define TABLE_SIZE 65536
+
+static double simulatedTime = 0;   // microseconds
+static unsigned long conversions = 0;
+static int16_t tableV[TABLE_SIZE], tableI[TABLE_SIZE];
+SerialStub Serial;
+
+unsigned long millis() { return simulatedTime / 1000; }
+void delay(unsigned long ms) { simulatedTime += ms * 1000.0; }
+
+// The waveforms are precomputed so the timing measures EmonLib, not sin().
+static void fillTables()
+{
+  srand(1);
+  for (long n = 0; n < TABLE_SIZE; n++)
+  {
+    double w = 2 * M_PI * FREQUENCY * n * CONVERSION_US / 1e6;
+    int noise = (rand() % 3) - 1;    // one count of noise
+    tableV[n] = lround(512 + AMPLITUDE_V * sin(w) + 20 * sin(3 * w) + noise);
+    tableI[n] = lround(512 + AMPLITUDE_I * sin(w - PHASE) + noise);
+  }
+}
+
+int analogRead(unsigned int pin)
+{
+  unsigned long n = conversions++ % TABLE_SIZE;
+  simulatedTime += CONVERSION_US;
+  return pin == PIN_V ? tableV[n] : tableI[n];
+}
+
+int main()
+{
+  const double VCAL = 234.26, ICAL = 111.1;
+  const int RUNS = 2000;
+
+  fillTables();
+
+  // Current is read one conversion after voltage, half a sample period.
+  EnergyMonitor emon;
+  emon.voltage(PIN_V, VCAL, 1.5);
+  emon.current(PIN_I, ICAL);
+
+  // Let the offset filters settle before measuring.
+  for (int i = 0; i < 50; i++)
+    emon.calcVI(20, 2000);
+
+  double sumV = 0, sumI = 0, sumP = 0, sumPF = 0;
+  long samples = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < RUNS; i++)
+  {
+    unsigned long before = conversions;
+    emon.calcVI(20, 2000);
+    samples += (conversions - before) / 2;    // V and I pairs
+    sumV += emon.Vrms;
+    sumI += emon.Irms;
+    sumP += emon.realPower;
+    sumPF += emon.powerFactor;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  const double ratio = 3.3 / 1024;
+  double expectedV = VCAL * ratio * sqrt((AMPLITUDE_V * AMPLITUDE_V + 20 * 20) / 2);
+  double expectedI = ICAL * ratio * AMPLITUDE_I / sqrt(2);
+
+  // Expected values in brackets; the third harmonic adds to Vrms only.
+  printf("%-12s %12.0f samples/s  Vrms %.4f (%.4f)  Irms %.4f (%.4f)  P %.3f  PF %.5f (%.5f)\n",
+         EMONLIB_FIXED_POINT ? "fixed point" : "double",
+         samples / seconds, sumV / RUNS, expectedV, sumI / RUNS, expectedI,
+         sumP / RUNS, sumPF / RUNS, cos(PHASE) * AMPLITUDE_V / sqrt(AMPLITUDE_V * AMPLITUDE_V + 20 * 20));
+
+  start = std::chrono::steady_clock::now();
+  double sumIrms = 0;
+  for (int i = 0; i < RUNS; i++)
+    sumIrms += emon.calcIrms(1480);
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("%-12s %12.0f samples/s  calcIrms %.4f\n",
+         EMONLIB_FIXED_POINT ? "fixed point" : "double", 1480.0 * RUNS / seconds, sumIrms / RUNS);
+  return 0;
+}
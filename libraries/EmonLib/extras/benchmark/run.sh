@@ -0,0 +1,9 @@
+#!/bin/sh
+# Builds the benchmark for both EmonLib paths and runs them one after the other.
+set -e
+cd "$(dirname "$0")"
+for fixed in 0 1; do
+  g++ -O2 -I. -DARDUINO=100 -DEMONLIB_FIXED_POINT=$fixed -o emonlib_benchmark benchmark.cpp ../../EmonLib.cpp
+  ./emonlib_benchmark
+done
+rm -f emonlib_benchmark
@@ -0,0 +1,51 @@
+/**
+ * This program counts the energy drawn by a load measured with a ZMPT101B
+ * and an ACS712, and keeps the total across resets and power cuts.
+*/
+
+#include <EnergyAccumulator.h>
+#include <MainsPowerMeter.h>
+#include <ZMPT101B.h>
+#include <ACS712.h>
+
+#define SENSITIVITY 500.0f
+#define FREQUENCY 50.0f
+
+ZMPT101B voltageSensor(A0, FREQUENCY);
+ACS712 currentSensor(ACS712_05B, A1);
+MainsPowerMeter<ZMPT101B, ACS712> meter(voltageSensor, currentSensor, FREQUENCY);
+
+// Uses EEPROM bytes 0..255 (16 records of 16 bytes)
+EnergyAccumulator energy(0);
+
+void setup() {
+  Serial.begin(115200);
+  voltageSensor.setSensitivity(SENSITIVITY);
+  meter.setPhaseCalibration(1.5f);
+
+  if (energy.begin()) {
+    Serial.print("Restored ");
+  } else {
+    Serial.print("No checkpoint, starting at ");
+  }
+  Serial.print(energy.getKilowattHours(), 3);
+  Serial.println(" kWh");
+
+  // Checkpoint every 5 minutes
+  energy.setCheckpointInterval(300000UL);
+}
+
+void loop() {
+  meter.measure(5);
+
+  if (energy.update(meter.getRealPower())) {
+    Serial.println("Checkpoint written");
+  }
+
+  Serial.print(meter.getRealPower());
+  Serial.print(" W, ");
+  Serial.print(energy.getKilowattHours(), 3);
+  Serial.println(" kWh");
+
+  delay(1000);
+}
@@ -0,0 +1,146 @@
+#include "EnergyAccumulator.h"
+#include <EEPROM.h>
+#include <OneWire.h>
+#include <stddef.h>
+
+#define MILLIWATT_SECONDS_PER_WATT_HOUR 3600000.0f
+
+/// @brief EnergyAccumulator constructor
+/// @param address first EEPROM byte used by the ring
+/// @param slots number of 16 byte records in the ring
+EnergyAccumulator::EnergyAccumulator(uint16_t address, uint8_t slots)
+	: address(address), slots(slots > 0 ? slots : 1)
+{
+}
+
+/// @brief Recover the latest valid total from EEPROM. Call once in setup().
+/// @return true if a checkpoint was found, false if counting starts at zero
+bool EnergyAccumulator::begin()
+{
+#if defined(ESP32) || defined(ESP8266)
+	uint16_t end = address + storageSize();
+	if (EEPROM.length() < end)
+		EEPROM.begin(end);
+#endif
+
+	energy = 0;
+	remainder = 0;
+	sequence = 0;
+	recovered = false;
+
+	for (uint8_t slot = 0; slot < slots; slot++)
+	{
+		Record record;
+		EEPROM.get(address + slot * ENERGY_ACCUMULATOR_RECORD_SIZE, record);
+
+		// Erased cells read as 0xFF (and zero on some ESP32 cores), neither of
+		// which carries a valid CRC and sequence.
+		if (record.sequence == 0 || record.sequence == 0xFFFFFFFF)
+			continue;
+		if (record.crc != recordCrc(record))
+			continue;
+
+		if (!recovered || record.sequence > sequence)
+		{
+			sequence = record.sequence;
+			energy = record.energy;
+			recovered = true;
+		}
+	}
+
+	savedEnergy = energy;
+	lastUpdate = lastCheckpoint = millis();
+	started = true;
+
+	return recovered;
+}
+
+/// @brief Integrate power over a time span
+/// @param watts real power, negative values are ignored
+/// @param milliseconds duration the power was drawn for
+void EnergyAccumulator::add(float watts, uint32_t milliseconds)
+{
+	if (watts <= 0)
+		return;
+
+	// W * ms is mW * s; the fraction is carried over to the next call.
+	float amount = watts * milliseconds + remainder;
+	uint64_t whole = (uint64_t)amount;
+
+	energy += whole;
+	remainder = amount - whole;
+}
+
+/// @brief Integrate power since the previous call and checkpoint when the
+/// interval has elapsed. Call it from loop().
+/// @param watts real power measured now
+/// @return true if a checkpoint was written
+bool EnergyAccumulator::update(float watts)
+{
+	uint32_t now = millis();
+
+	if (!started)
+	{
+		lastUpdate = lastCheckpoint = now;
+		started = true;
+	}
+
+	add(watts, now - lastUpdate);
+	lastUpdate = now;
+
+	if (now - lastCheckpoint < interval)
+		return false;
+
+	lastCheckpoint = now;
+	return checkpoint();
+}
+
+/// @brief Write the total to the next slot of the ring. Nothing is written
+/// if the total did not change since the previous checkpoint.
+/// @return true if a record was written
+bool EnergyAccumulator::checkpoint()
+{
+	if (energy == savedEnergy && recovered)
+		return false;
+
+	Record record;
+	record.energy = energy;
+	record.sequence = sequence + 1;
+	record.reserved = 0;
+	record.crc = recordCrc(record);
+
+	uint8_t slot = record.sequence % slots;
+	EEPROM.put(address + slot * ENERGY_ACCUMULATOR_RECORD_SIZE, record);
+#if defined(ESP32) || defined(ESP8266)
+	if (!EEPROM.commit())
+		return false;
+#endif
+
+	sequence = record.sequence;
+	savedEnergy = energy;
+	recovered = true;
+
+	return true;
+}
+
+/// @brief Replace the total, e.g. with a value restored from the cloud.
+/// Call checkpoint() to store it right away.
+/// @param wattHours new total
+void EnergyAccumulator::setWattHours(float wattHours)
+{
+	energy = wattHours > 0 ? (uint64_t)(wattHours * MILLIWATT_SECONDS_PER_WATT_HOUR) : 0;
+	remainder = 0;
+}
+
+/// @brief Get the total
+/// @return energy in watt-hours
+float EnergyAccumulator::getWattHours() const
+{
+	return energy / MILLIWATT_SECONDS_PER_WATT_HOUR;
+}
+
+uint16_t EnergyAccumulator::recordCrc(const Record &record)
+{
+	// Inverted like the DS2450 CRC, so an all-zero record is never valid.
+	return ~OneWire::crc16((const uint8_t *)&record, offsetof(Record, crc));
+}
@@ -0,0 +1,72 @@
+#ifndef EnergyAccumulator_h
+#define EnergyAccumulator_h
+
+#include <Arduino.h>
+
+// Default number of records in the EEPROM ring.
+#ifndef ENERGY_ACCUMULATOR_SLOTS
+	#define ENERGY_ACCUMULATOR_SLOTS 16
+#endif
+
+#define ENERGY_ACCUMULATOR_DEFAULT_INTERVAL 60000UL
+#define ENERGY_ACCUMULATOR_RECORD_SIZE 16
+
+/// Cumulative energy counter that survives resets and brownouts.
+///
+/// Real power is integrated into a 64-bit count of milliwatt-seconds. The
+/// total is checkpointed to EEPROM (flash emulated EEPROM on ESP32/ESP8266)
+/// as a 16 byte record with a sequence number and a CRC-16. Every
+/// checkpoint goes to the next slot of a fixed ring, so each slot is only
+/// rewritten once per `slots` checkpoints. At boot all slots are read once
+/// and the valid record with the highest sequence number wins, which takes
+/// the same time no matter how many checkpoints were written. A record torn
+/// by a power loss fails its CRC and the previous one is used instead.
+class EnergyAccumulator
+{
+public:
+	EnergyAccumulator(uint16_t address = 0, uint8_t slots = ENERGY_ACCUMULATOR_SLOTS);
+
+	bool     begin();
+	void     add(float watts, uint32_t milliseconds);
+	bool     update(float watts);
+	bool     checkpoint();
+
+	void     setCheckpointInterval(uint32_t milliseconds) { interval = milliseconds; }
+	void     setWattHours(float wattHours);
+
+	float    getWattHours() const;
+	float    getKilowattHours() const { return getWattHours() / 1000.0f; }
+	uint64_t getMilliwattSeconds() const { return energy; }
+	uint32_t getSequence() const { return sequence; }
+	bool     isRecovered() const { return recovered; }
+
+	uint16_t storageSize() const { return (uint16_t)slots * ENERGY_ACCUMULATOR_RECORD_SIZE; }
+
+private:
+	struct Record
+	{
+		uint64_t energy;
+		uint32_t sequence;
+		uint16_t reserved;
+		uint16_t crc;
+	};
+	static_assert(sizeof(Record) == ENERGY_ACCUMULATOR_RECORD_SIZE, "unexpected record padding");
+
+	uint16_t address;
+	uint8_t  slots;
+
+	uint64_t energy = 0;
+	float    remainder = 0;
+	uint64_t savedEnergy = 0;
+	uint32_t sequence = 0;
+	bool     recovered = false;
+
+	uint32_t interval = ENERGY_ACCUMULATOR_DEFAULT_INTERVAL;
+	uint32_t lastUpdate = 0;
+	uint32_t lastCheckpoint = 0;
+	bool     started = false;
+
+	static uint16_t recordCrc(const Record &record);
+};
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * This program keeps only the points a vehicle's track needs (10 m
+ * tolerance), reports entering and leaving a yard and a school zone, and
+ * prints the kept points as base64 batches, one line per batch, for a modem
+ * or an ESP to upload. A parked vehicle sends a heartbeat every 5 minutes.
+*/
+
+#include <TinyGPS++.h>
+#include <GPSTrack.h>
+#include <SoftwareSerial.h>
+
+static const int RXPin = 2, TXPin = 3;
+
+TinyGPSPlus gps;
+SoftwareSerial gpsSerial(RXPin, TXPin);
+
+TrackSimplifier simplifier(10, 300);
+GeofenceSet fences;
+TrackEncoder batch;
+
+// Corners of the yard, in 1e-7 degrees
+static const GeoPoint yard[] = {
+  { 120018000, 85916000 }, { 120018000, 85924000 },
+  { 120026000, 85924000 }, { 120026000, 85916000 },
+};
+
+int8_t yardId, schoolId;
+unsigned long batchStarted = 0;
+
+void setup() {
+  Serial.begin(9600);
+  gpsSerial.begin(9600);
+
+  yardId = fences.addPolygon(yard, 4);
+  schoolId = fences.addCircle(120150000, 86000000, 400);
+  fences.setDebounce(3);
+}
+
+void loop() {
+  char buffer[64];
+  size_t length = gpsSerial.readBytes(buffer, gpsSerial.available() < 64 ? gpsSerial.available() : 64);
+  gps.encode(buffer, length);
+
+  if (!gps.location.isUpdated()) {
+    return;
+  }
+
+  TrackPoint point;
+  if (!getTrackPoint(gps, point)) {
+    return;
+  }
+
+  uint32_t changed = fences.update(point);
+  if (changed & (1UL << yardId)) {
+    Serial.println(fences.isInside(yardId) ? "EVENT yard enter" : "EVENT yard exit");
+  }
+  if (changed & (1UL << schoolId)) {
+    Serial.println(fences.isInside(schoolId) ? "EVENT school enter" : "EVENT school exit");
+  }
+
+  if (simplifier.add(point)) {
+    if (!batch.add(simplifier.point())) {
+      sendBatch();
+      batch.add(simplifier.point());
+    }
+    if (batch.getPoints() == 1) {
+      batchStarted = millis();
+    }
+  }
+
+  // don't hold points for more than 10 minutes
+  if (!batch.isEmpty() && millis() - batchStarted > 600000UL) {
+    sendBatch();
+  }
+}
+
+void sendBatch() {
+  char text[GPSTRACK_BATCH_SIZE * 4 / 3 + 4];
+  if (batch.toBase64(text, sizeof(text)) > 0) {
+    Serial.print("TRACK ");
+    Serial.println(text);
+  }
+  batch.clear();
+}
@@ -0,0 +1,7 @@
+#!/bin/sh
+# Builds the track check and runs it.
+set -e
+cd "$(dirname "$0")"
+g++ -O2 -DARDUINO=100 -I. -I../../../TinyGPSPlus/src -o track_check track_check.cpp ../../src/GPSTrack.cpp ../../../TinyGPSPlus/src/TinyGPS++.cpp
+./track_check
+rm -f track_check
@@ -0,0 +1,277 @@
+// Runs GPSTrack on a generated hour of a car tracker at 1 Hz: parked, a
+// drive through town with turns, a bend and a stop at lights, parked again
+// and the drive back, with 2 m of GPS noise. Checks that every dropped point
+// is within the tolerance of the simplified track, that batches decode to
+// the points kept, and that the geofence index finds what testing every
+// fence finds. Build and run with ./run.sh.
+
+#include <chrono>
+#include <stdlib.h>
+#include <vector>
+
+#include "Arduino.h"
+#include "../../src/GPSTrack.h"
+
+#define ORIGIN_LAT 12.0022
+#define ORIGIN_LNG 8.5920
+#define TOLERANCE 10.0   // meters
+#define NOISE 2.0        // meters, standard deviation
+#define THINGSPEAK_INTERVAL 15
+
+unsigned long millis() { return 0; }
+
+static int checks = 0, failures = 0;
+#define CHECK(c) do { checks++; if (!(c)) { failures++; printf("  FAILED line %d: %s\n", __LINE__, #c); } } while (0)
+
+struct Sample { TrackPoint point; bool moving; };
+
+static double gaussian()
+{
+  double u = (rand() + 1.0) / (RAND_MAX + 2.0), v = (rand() + 1.0) / (RAND_MAX + 2.0);
+  return sqrt(-2 * log(u)) * cos(TWO_PI * v);
+}
+
+static double metersPerLng() { return 0.0111226 * cos(radians(ORIGIN_LAT)); }
+
+static TrackPoint toPoint(double x, double y, uint32_t t)
+{
+  TrackPoint p;
+  p.lat = lround(ORIGIN_LAT * 1e7 + y / 0.0111226);
+  p.lng = lround(ORIGIN_LNG * 1e7 + x / metersPerLng());
+  p.time = t;
+  return p;
+}
+
+static void toMeters(const TrackPoint &p, double &x, double &y)
+{
+  x = (p.lng - ORIGIN_LNG * 1e7) * metersPerLng();
+  y = (p.lat - ORIGIN_LAT * 1e7) * 0.0111226;
+}
+
+// one leg: seconds, speed m/s, heading change per second
+struct Leg { int seconds; double speed; double turn; };
+
+static std::vector<Sample> generate()
+{
+  static const Leg legs[] = {
+    { 600, 0, 0 },                                          // parked
+    { 8, 2, 0 }, { 110, 14, 0 }, { 10, 6, 9 }, { 200, 14, 0 }, // out of the yard, a right turn
+    { 180, 12, 0.5 }, { 30, 10, 0 }, { 40, 0, 0 },           // a long bend, lights
+    { 150, 14, 0 }, { 12, 5, -7.5 }, { 240, 16, 0 }, { 20, 3, 0 },
+    { 600, 0, 0 },                                          // parked
+    { 20, 3, 0 }, { 12, 5, 15 }, { 390, 15, 0 }, { 10, 6, -9 }, { 300, 14, 0 }, { 260, 13, 0.2 },
+  };
+  std::vector<Sample> samples;
+  double x = 0, y = 0, heading = 45;
+  uint32_t t = 1760781600; // 2025-10-18 10:00 UTC
+  srand(7);
+  for (size_t l = 0; l < sizeof(legs) / sizeof(legs[0]); l++)
+    for (int s = 0; s < legs[l].seconds; s++)
+    {
+      heading += legs[l].turn;
+      x += legs[l].speed * sin(radians(heading));
+      y += legs[l].speed * cos(radians(heading));
+      Sample sample;
+      sample.point = toPoint(x + NOISE * gaussian(), y + NOISE * gaussian(), t++);
+      sample.moving = legs[l].speed > 0;
+      samples.push_back(sample);
+    }
+  return samples;
+}
+
+static double segmentDistance(const TrackPoint &a, const TrackPoint &b, const TrackPoint &p)
+{
+  double ax, ay, bx, by, px, py;
+  toMeters(a, ax, ay);
+  toMeters(b, bx, by);
+  toMeters(p, px, py);
+  double dx = bx - ax, dy = by - ay, l2 = dx * dx + dy * dy;
+  double t = l2 > 0 ? ((px - ax) * dx + (py - ay) * dy) / l2 : 0;
+  t = t < 0 ? 0 : t > 1 ? 1 : t;
+  return hypot(px - ax - t * dx, py - ay - t * dy);
+}
+
+static std::vector<TrackPoint> simplify(const std::vector<Sample> &samples)
+{
+  printf("simplification, %.0f m tolerance\n", TOLERANCE);
+  TrackSimplifier simplifier(TOLERANCE, 300);
+  std::vector<TrackPoint> kept;
+  unsigned keptMoving = 0, keptParked = 0, moving = 0;
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    moving += samples[i].moving;
+    if (simplifier.add(samples[i].point))
+    {
+      kept.push_back(simplifier.point());
+      if (samples[i].moving) keptMoving++; else keptParked++;
+    }
+  }
+  if (simplifier.flush())
+    kept.push_back(simplifier.point());
+  CHECK(simplifier.getAdded() == samples.size() && simplifier.getKept() == kept.size());
+
+  // every fix lies within the tolerance of the segment its time falls in
+  double worst = 0;
+  size_t k = 0;
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    const TrackPoint &p = samples[i].point;
+    while (k + 1 < kept.size() && kept[k + 1].time <= p.time)
+      k++;
+    if (k + 1 >= kept.size())
+      break;
+    double d = segmentDistance(kept[k], kept[k + 1], p);
+    if (d > worst)
+      worst = d;
+  }
+  CHECK(worst <= TOLERANCE + 0.15); // offsets are held to the decimeter
+  printf("  %u fixes (%u moving) -> %u points (%u moving, %u parked), largest error %.2f m\n",
+         (unsigned)samples.size(), moving, (unsigned)kept.size(), keptMoving, keptParked, worst);
+  printf("  a point every %d s would be %u points\n", THINGSPEAK_INTERVAL,
+         (unsigned)(samples.size() / THINGSPEAK_INTERVAL));
+  return kept;
+}
+
+static void batches(const std::vector<TrackPoint> &kept)
+{
+  printf("batches of %d bytes\n", GPSTRACK_BATCH_SIZE);
+  TrackEncoder encoder;
+  std::vector<TrackPoint> decoded;
+  size_t bytes = 0, batchCount = 0, text = 0;
+  char base64[200];
+
+  for (size_t i = 0; i <= kept.size(); i++)
+  {
+    bool last = i == kept.size();
+    if (last || !encoder.add(kept[i]))
+    {
+      // send the batch, check it decodes
+      TrackDecoder decoder(encoder.data(), encoder.size());
+      TrackPoint p;
+      while (decoder.next(p))
+        decoded.push_back(p);
+      CHECK(decoder.isValid());
+      size_t length = encoder.toBase64(base64, sizeof(base64));
+      CHECK(length == (encoder.size() + 2) / 3 * 4 && strlen(base64) == length);
+      bytes += encoder.size();
+      text += length;
+      batchCount++;
+      encoder.clear();
+      if (last)
+        break;
+      CHECK(encoder.add(kept[i]));
+    }
+  }
+
+  bool same = decoded.size() == kept.size();
+  for (size_t i = 0; same && i < kept.size(); i++)
+    same = decoded[i].lat == kept[i].lat && decoded[i].lng == kept[i].lng && decoded[i].time == kept[i].time;
+  CHECK(same);
+  printf("  %u points in %u batches: %u bytes, %.1f per point (12 as int32 lat, lng, time)\n",
+         (unsigned)kept.size(), (unsigned)batchCount, (unsigned)bytes, (double)bytes / kept.size());
+  printf("  %u characters of base64, one SMS per batch\n", (unsigned)text);
+
+  // a short batch across the 180 degree meridian, and a damaged one
+  TrackPoint a = { -170000000, 1799990000, 100 }, b = { -170001000, -1799995000, 104 }, c = { -170002000, 1799980000, 90 };
+  encoder.clear();
+  CHECK(encoder.add(a) && encoder.add(b) && encoder.add(c));
+  CHECK(encoder.size() < 1 + 3 * 5 + 2 * 6);
+  TrackDecoder decoder(encoder.data(), encoder.size());
+  TrackPoint p;
+  CHECK(decoder.next(p) && p.lng == a.lng);
+  CHECK(decoder.next(p) && p.lng == b.lng && p.time == b.time);
+  CHECK(decoder.next(p) && p.lng == c.lng && p.time == c.time && p.lat == c.lat);
+  CHECK(!decoder.next(p) && decoder.isValid());
+  TrackDecoder cut(encoder.data(), encoder.size() - 1);
+  CHECK(cut.next(p) && cut.next(p) && !cut.next(p) && !cut.isValid());
+}
+
+static void geofences(const std::vector<Sample> &samples)
+{
+  printf("geofences\n");
+  GeofenceSet fences;
+  // the yard, a school zone and two far away depots
+  static const GeoPoint yard[] = {
+    { 120018000, 85916000 }, { 120018000, 85924000 }, { 120026000, 85924000 }, { 120026000, 85916000 },
+  };
+  // an L shaped market around a corner of the route
+  static const GeoPoint market[] = {
+    { 120060000, 85990000 }, { 120060000, 86060000 }, { 120080000, 86060000 },
+    { 120080000, 86010000 }, { 120120000, 86010000 }, { 120120000, 85990000 },
+  };
+  static const GeoPoint depot[] = {
+    { 125000000, 85000000 }, { 125000000, 85100000 }, { 125100000, 85050000 },
+  };
+  CHECK(fences.addPolygon(yard, 4) == 0);
+  CHECK(fences.addCircle(120150000, 86000000, 400) == 1);
+  CHECK(fences.addPolygon(market, 6) == 2);
+  CHECK(fences.addPolygon(depot, 3) == 3);
+  CHECK(fences.addCircle(115000000, 87000000, 1000) == 4);
+  CHECK(fences.addCircle(120100000, 86300000, 250) == 5);
+  CHECK(fences.addCircle(119900000, 85800000, 600) == 6);
+  CHECK(fences.addPolygon(yard, 2) == -1);
+  CHECK(fences.getCount() == 7);
+
+  // with no debounce the state follows the exact test of every fence
+  unsigned mismatches = 0, events = 0;
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    const TrackPoint &p = samples[i].point;
+    uint32_t changed = fences.update(p);
+    for (uint8_t id = 0; id < 7; id++)
+    {
+      if (fences.isInside(id) != fences.contains(id, p.lat, p.lng))
+        mismatches++;
+      if ((changed >> id) & 1)
+        events++;
+    }
+  }
+  CHECK(mismatches == 0);
+  printf("  %u fixes, 7 fences: %u exact tests instead of %u, %u enter/exit events\n",
+         (unsigned)samples.size(), (unsigned)fences.getExactTests(), (unsigned)samples.size() * 7, events);
+
+  // the noise at the yard's edge while parked flaps without a debounce
+  GeofenceSet debounced;
+  debounced.addPolygon(yard, 4);
+  debounced.setDebounce(3);
+  unsigned debouncedEvents = 0, rawEvents = 0;
+  GeofenceSet raw;
+  raw.addPolygon(yard, 4);
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    if (samples[i].moving)
+      continue;
+    TrackPoint p = samples[i].point;
+    p.lat -= 4000 - 90; // parked 1 m inside the southern edge
+    debouncedEvents += debounced.update(p) != 0;
+    rawEvents += raw.update(p) != 0;
+  }
+  printf("  parked at the edge of the yard: %u events, %u with a 3 fix debounce\n", rawEvents, debouncedEvents);
+  CHECK(debouncedEvents < rawEvents);
+
+  // polygon corners: inside, outside and the notch of the L
+  CHECK(fences.contains(2, 120070000, 86050000));
+  CHECK(fences.contains(2, 120110000, 86000000));
+  CHECK(!fences.contains(2, 120100000, 86050000));
+  CHECK(!fences.contains(2, 120130000, 86000000));
+  CHECK(fences.contains(1, 120150000 + 350 / 0.0111226, 86000000));
+  CHECK(!fences.contains(1, 120150000 + 450 / 0.0111226, 86000000));
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  volatile uint32_t sink = 0;
+  for (int r = 0; r < 100; r++)
+    for (size_t i = 0; i < samples.size(); i++)
+      sink += fences.update(samples[i].point);
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("  update(): %.0f ns per fix on this machine\n", elapsed / (100 * samples.size()) * 1e9);
+}
+
+int main()
+{
+  std::vector<Sample> samples = generate();
+  std::vector<TrackPoint> kept = simplify(samples);
+  batches(kept);
+  geofences(samples);
+  printf("%d checks, %d failed\n", checks, failures);
+  return failures == 0 ? 0 : 1;
+}
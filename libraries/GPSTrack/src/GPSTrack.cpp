@@ -0,0 +1,576 @@
+#include "GPSTrack.h"
+#include <math.h>
+#include <string.h>
+
+// Meters per 1e-7 degree of latitude, on the sphere of TinyGPSPlus
+#define METERS_PER_E7 0.0111226f
+
+/// @brief Days from 1970-01-01 to a date of the Gregorian calendar
+static int32_t daysFromCivil(int16_t year, uint8_t month, uint8_t day)
+{
+	year -= month <= 2;
+	int32_t era = year / 400;
+	uint16_t yearOfEra = year - era * 400;
+	uint16_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	int32_t dayOfEra = yearOfEra * 365L + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+	return era * 146097L + dayOfEra - 719468L;
+}
+
+bool getTrackPoint(TinyGPSPlus &gps, TrackPoint &point)
+{
+	if (!gps.location.isValid())
+		return false;
+
+	point.lat = gps.location.latE7();
+	point.lng = gps.location.lngE7();
+	if (gps.date.isValid() && gps.time.isValid() && gps.date.year() >= 2000)
+		point.time = daysFromCivil(gps.date.year(), gps.date.month(), gps.date.day()) * 86400UL +
+			gps.time.hour() * 3600UL + gps.time.minute() * 60U + gps.time.second();
+	else
+		point.time = millis() / 1000;
+	return true;
+}
+
+int32_t longitudeDelta(int32_t from, int32_t to)
+{
+	// only longitudes of opposite signs can be more than 180 degrees apart
+	if ((from < 0) == (to < 0))
+		return to - from;
+	if (to >= 0)
+	{
+		uint32_t east = (uint32_t)to - (uint32_t)from;
+		return east > 1800000000UL ? -(int32_t)(3600000000UL - east) : (int32_t)east;
+	}
+	uint32_t west = (uint32_t)from - (uint32_t)to;
+	return west > 1800000000UL ? (int32_t)(3600000000UL - west) : -(int32_t)west;
+}
+
+
+/// @brief TrackSimplifier constructor
+/// @param toleranceMeters largest distance of a dropped point from the simplified track
+/// @param maxInterval seconds after which a point is kept even if the track is straight
+TrackSimplifier::TrackSimplifier(float toleranceMeters, uint32_t maxInterval)
+	: tolerance(toleranceMeters * 10), maxInterval(maxInterval)
+{
+}
+
+/// @brief Forget the track, the next point added is kept
+void TrackSimplifier::reset()
+{
+	hullCount = 0;
+	pending = false;
+	started = false;
+}
+
+/// @brief Add the next position of the track
+/// @return true if a point was kept, read it with point(). It is the point
+/// before this one when the track turned, this one on a heartbeat or when
+/// the hull is full.
+bool TrackSimplifier::add(const TrackPoint &p)
+{
+	added++;
+	if (!started)
+	{
+		started = true;
+		keep(p);
+		return true;
+	}
+
+	bool emitted = false;
+	Offset o;
+	bool inRange = offset(p, o);
+	if (pending && (!held || !inRange || !inCorridor(o)))
+	{
+		// the track turned at the previous point
+		keep(previous);
+		emitted = true;
+		inRange = offset(p, o);
+	}
+
+	if (inRange && (emitted || p.time - anchor.time < maxInterval))
+	{
+		// a point within the tolerance of the anchor is within the tolerance
+		// of any segment starting there, it need not be held
+		float d2 = (float)o.x * o.x + (float)o.y * o.y;
+		if (d2 <= tolerance * tolerance || addToHull(o))
+		{
+			previous = p;
+			pending = held = true;
+			return emitted;
+		}
+	}
+
+	// a heartbeat, a full hull, or too far from the anchor to be held
+	if (!emitted)
+	{
+		keep(p);
+		return true;
+	}
+	// only one point per call: this one is kept with the next
+	previous = p;
+	pending = true;
+	held = false;
+	return true;
+}
+
+/// @brief Keep the last point added if it was dropped so far, e.g. when the
+/// engine is switched off
+/// @return true if a point was kept
+bool TrackSimplifier::flush()
+{
+	if (!pending)
+		return false;
+	keep(previous);
+	return true;
+}
+
+void TrackSimplifier::keep(const TrackPoint &p)
+{
+	output = anchor = p;
+	pending = false;
+	hullCount = 0;
+	kept++;
+	decimetersPerLng = 10 * METERS_PER_E7 * cos(p.lat * (float)(M_PI / 180 / 1e7));
+}
+
+/// @brief Offset of a point from the anchor
+/// @return false if it is too far to fit 16 bits
+bool TrackSimplifier::offset(const TrackPoint &p, Offset &o) const
+{
+	float x = longitudeDelta(anchor.lng, p.lng) * decimetersPerLng;
+	float y = (p.lat - anchor.lat) * (10 * METERS_PER_E7);
+	if (x > 32767 || x < -32767 || y > 32767 || y < -32767)
+		return false;
+	o.x = (int16_t)(x < 0 ? x - 0.5f : x + 0.5f);
+	o.y = (int16_t)(y < 0 ? y - 0.5f : y + 0.5f);
+	return true;
+}
+
+/// @brief Is every point held within the tolerance of the segment from the
+/// anchor to end? Only the corners of their hull need to be tested.
+bool TrackSimplifier::inCorridor(const Offset &end) const
+{
+	float bx = end.x, by = end.y;
+	float length2 = bx * bx + by * by;
+	float tolerance2 = tolerance * tolerance;
+
+	for (uint8_t i = 0; i < hullCount; i++)
+	{
+		float px = hull[i].x, py = hull[i].y;
+		float dot = px * bx + py * by;
+		if (dot <= 0)
+		{
+			// behind the anchor
+			if (px * px + py * py > tolerance2)
+				return false;
+		}
+		else if (dot >= length2)
+		{
+			// beyond the end
+			float ex = px - bx, ey = py - by;
+			if (ex * ex + ey * ey > tolerance2)
+				return false;
+		}
+		else
+		{
+			// distance to the line is cross / length, compared squared
+			float cross = px * by - py * bx;
+			if (cross * cross > tolerance2 * length2)
+				return false;
+		}
+	}
+	return true;
+}
+
+// > 0 if c is left of the line from a to b
+static int8_t turn(const int16_t ax, const int16_t ay, const int16_t bx, const int16_t by, const int16_t cx, const int16_t cy)
+{
+	float t = (float)(bx - ax) * (cy - ay) - (float)(by - ay) * (cx - ax);
+	return t > 0 ? 1 : t < 0 ? -1 : 0;
+}
+
+/// @brief Add a point to the convex hull of the points held
+/// @return false if the hull would need more than GPSTRACK_HULL corners
+bool TrackSimplifier::addToHull(const Offset &p)
+{
+	if (hullCount < 2)
+	{
+		if (hullCount == 1 && hull[0].x == p.x && hull[0].y == p.y)
+			return true;
+		hull[hullCount++] = p;
+		return true;
+	}
+
+	if (hullCount == 2)
+	{
+		int8_t t = turn(hull[0].x, hull[0].y, hull[1].x, hull[1].y, p.x, p.y);
+		if (t > 0)
+			hull[hullCount++] = p;
+		else if (t < 0)
+		{
+			// counterclockwise is 0, p, 1
+			if (GPSTRACK_HULL < 3)
+				return false;
+			hull[2] = hull[1];
+			hull[1] = p;
+			hullCount = 3;
+		}
+		else
+		{
+			// on one line: keep the two ends
+			int32_t dx = hull[1].x - hull[0].x, dy = hull[1].y - hull[0].y;
+			int32_t d = (int32_t)(p.x - hull[0].x) * dx + (int32_t)(p.y - hull[0].y) * dy;
+			if (d < 0)
+				hull[0] = p;
+			else if (d > dx * dx + dy * dy)
+				hull[1] = p;
+		}
+		return true;
+	}
+
+	// The edges p sees from outside form one chain, from edge first to
+	// edge last; the corners inside the chain are replaced by p.
+	uint8_t n = hullCount;
+	bool visible[GPSTRACK_HULL];
+	bool any = false;
+	for (uint8_t i = 0; i < n; i++)
+	{
+		const Offset &a = hull[i], &b = hull[i + 1 < n ? i + 1 : 0];
+		visible[i] = turn(a.x, a.y, b.x, b.y, p.x, p.y) < 0;
+		any |= visible[i];
+	}
+	if (!any)
+		return true; // inside
+
+	uint8_t first = 0;
+	while (!(visible[first] && !visible[first > 0 ? first - 1 : n - 1]))
+		first++;
+	uint8_t removed = 0;
+	uint8_t last = first;
+	while (visible[last + 1 < n ? last + 1 : 0])
+	{
+		last = last + 1 < n ? last + 1 : 0;
+		removed++;
+	}
+	if (n - removed + 1 > GPSTRACK_HULL)
+		return false;
+
+	// corners last + 1 ... first are kept in order, then p
+	Offset corners[GPSTRACK_HULL];
+	uint8_t k = 0;
+	uint8_t i = last + 1 < n ? last + 1 : 0;
+	for (uint8_t c = 0; c < n - removed; c++)
+	{
+		corners[k++] = hull[i];
+		i = i + 1 < n ? i + 1 : 0;
+	}
+	corners[k++] = p;
+	memcpy(hull, corners, k * sizeof(Offset));
+	hullCount = k;
+	return true;
+}
+
+
+/// @brief GeofenceSet constructor, no fences
+GeofenceSet::GeofenceSet()
+{
+	clear();
+}
+
+/// @brief Remove all fences
+void GeofenceSet::clear()
+{
+	fenceCount = 0;
+	nextId = 0;
+	minLat = minLng = 2147483647L;
+	maxLat = maxLng = -2147483647L - 1;
+	state = 0;
+	memset(streak, 0, sizeof(streak));
+	debounce = 1;
+	exactTests = 0;
+}
+
+/// @brief Add a circular fence
+/// @param lat latitude of the centre, 1e-7 degrees
+/// @param lng longitude of the centre, 1e-7 degrees
+/// @param radiusMeters radius in meters, up to 100 km
+/// @return the id of the fence (0, 1, ... in the order added), -1 if full
+int8_t GeofenceSet::addCircle(int32_t lat, int32_t lng, uint32_t radiusMeters)
+{
+	Fence fence;
+	int32_t dLat = radiusMeters / METERS_PER_E7 + 1;
+	int32_t dLng = dLat / cos(lat * (float)(M_PI / 180 / 1e7)) + 1;
+	fence.minLat = lat - dLat;
+	fence.maxLat = lat + dLat;
+	fence.minLng = lng - dLng;
+	fence.maxLng = lng + dLng;
+	fence.lat = lat;
+	fence.lng = lng;
+	fence.radius = radiusMeters;
+	fence.vertices = NULL;
+	fence.vertexCount = 0;
+	return insert(fence);
+}
+
+/// @brief Add a polygon fence
+/// @param vertices corners in order, not closed (the last one connects to
+/// the first). The array is used in place and must outlive the set.
+/// @param count number of corners, at least 3
+/// @return the id of the fence, -1 if full or fewer than 3 corners
+int8_t GeofenceSet::addPolygon(const GeoPoint *vertices, uint8_t count)
+{
+	if (count < 3)
+		return -1;
+
+	Fence fence;
+	fence.minLat = fence.maxLat = vertices[0].lat;
+	fence.minLng = fence.maxLng = vertices[0].lng;
+	for (uint8_t i = 1; i < count; i++)
+	{
+		if (vertices[i].lat < fence.minLat) fence.minLat = vertices[i].lat;
+		if (vertices[i].lat > fence.maxLat) fence.maxLat = vertices[i].lat;
+		if (vertices[i].lng < fence.minLng) fence.minLng = vertices[i].lng;
+		if (vertices[i].lng > fence.maxLng) fence.maxLng = vertices[i].lng;
+	}
+	fence.lat = fence.lng = 0;
+	fence.radius = 0;
+	fence.vertices = vertices;
+	fence.vertexCount = count;
+	return insert(fence);
+}
+
+int8_t GeofenceSet::insert(Fence &fence)
+{
+	if (fenceCount >= GEOFENCE_MAX || nextId >= 32)
+		return -1;
+
+	fence.id = nextId++;
+	uint8_t i = fenceCount++;
+	while (i > 0 && fences[i - 1].minLat > fence.minLat)
+	{
+		fences[i] = fences[i - 1];
+		i--;
+	}
+	fences[i] = fence;
+
+	if (fence.minLat < minLat) minLat = fence.minLat;
+	if (fence.maxLat > maxLat) maxLat = fence.maxLat;
+	if (fence.minLng < minLng) minLng = fence.minLng;
+	if (fence.maxLng > maxLng) maxLng = fence.maxLng;
+	return fence.id;
+}
+
+/// @brief Test a position against all fences
+/// @return a bit for every fence entered or left (1 << id), after the
+/// debounce; isInside() tells which
+uint32_t GeofenceSet::update(int32_t lat, int32_t lng)
+{
+	uint32_t now = 0;
+	if (lat >= minLat && lat <= maxLat && lng >= minLng && lng <= maxLng)
+	{
+		for (uint8_t i = 0; i < fenceCount && fences[i].minLat <= lat; i++)
+		{
+			const Fence &fence = fences[i];
+			if (lat > fence.maxLat || lng < fence.minLng || lng > fence.maxLng)
+				continue;
+			exactTests++;
+			if (test(fence, lat, lng))
+				now |= 1UL << fence.id;
+		}
+	}
+
+	uint32_t differs = now ^ state;
+	uint32_t changed = 0;
+	for (uint8_t id = 0; id < nextId; id++)
+	{
+		if (!((differs >> id) & 1))
+		{
+			streak[id] = 0;
+			continue;
+		}
+		if (++streak[id] >= debounce)
+		{
+			streak[id] = 0;
+			changed |= 1UL << id;
+		}
+	}
+	state ^= changed;
+	return changed;
+}
+
+/// @brief Exact test of one fence, without the debounce
+bool GeofenceSet::contains(uint8_t id, int32_t lat, int32_t lng) const
+{
+	for (uint8_t i = 0; i < fenceCount; i++)
+		if (fences[i].id == id)
+			return test(fences[i], lat, lng);
+	return false;
+}
+
+bool GeofenceSet::test(const Fence &fence, int32_t lat, int32_t lng)
+{
+	if (fence.radius > 0)
+		return TinyGPSPlus::distanceBetweenE7(fence.lat, fence.lng, lat, lng) <= fence.radius;
+
+	// Crossing number: count the edges crossing the ray going east from the
+	// position. Coordinates are taken relative to the position.
+	bool inside = false;
+	const GeoPoint *a = &fence.vertices[fence.vertexCount - 1];
+	for (uint8_t i = 0; i < fence.vertexCount; i++)
+	{
+		const GeoPoint *b = &fence.vertices[i];
+		int32_t ay = a->lat - lat, by = b->lat - lat;
+		if ((ay > 0) != (by > 0))
+		{
+			// the edge crosses east of the position if the position lies on
+			// the left of an edge going north, or on the right going south
+			float ax = a->lng - lng, bx = b->lng - lng;
+			float cross = ax * (float)by - bx * (float)ay;
+			if ((cross > 0) == (by > ay))
+				inside = !inside;
+		}
+		a = b;
+	}
+	return inside;
+}
+
+
+/// @brief Start a new batch
+void TrackEncoder::clear()
+{
+	buffer[0] = GPSTRACK_FORMAT;
+	length = 1;
+	points = 0;
+}
+
+/// @brief Append a point to the batch
+/// @return false if it does not fit: send the batch, clear() and add it again
+bool TrackEncoder::add(const TrackPoint &point)
+{
+	uint8_t record[15];
+	uint8_t size = 0;
+	if (points == 0)
+	{
+		size += putVarint(record, point.lat);
+		size += putVarint(record + size, point.lng);
+		size += putVarint(record + size, (int32_t)point.time);
+	}
+	else
+	{
+		size += putVarint(record, point.lat - last.lat);
+		size += putVarint(record + size, longitudeDelta(last.lng, point.lng));
+		size += putVarint(record + size, (int32_t)(point.time - last.time));
+	}
+
+	if (length + size > sizeof(buffer) || points == 255)
+		return false;
+	memcpy(buffer + length, record, size);
+	length += size;
+	points++;
+	last = point;
+	return true;
+}
+
+uint8_t TrackEncoder::putVarint(uint8_t *out, int32_t value)
+{
+	// zigzag: small negative values become small positive ones
+	uint32_t v = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+	uint8_t n = 0;
+	while (v >= 0x80)
+	{
+		out[n++] = (uint8_t)v | 0x80;
+		v >>= 7;
+	}
+	out[n++] = (uint8_t)v;
+	return n;
+}
+
+/// @brief The batch as base64 text, for an SMS or an HTTP field
+/// @param out buffer for the text and its terminating zero
+/// @return length of the text, 0 if out is too small
+size_t TrackEncoder::toBase64(char *out, size_t outSize) const
+{
+	static const char alphabet[] PROGMEM = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	size_t textLength = (length + 2) / 3 * 4;
+	if (outSize < textLength + 1)
+		return 0;
+
+	char *p = out;
+	for (size_t i = 0; i < length; i += 3)
+	{
+		uint32_t group = (uint32_t)buffer[i] << 16;
+		if (i + 1 < length) group |= (uint32_t)buffer[i + 1] << 8;
+		if (i + 2 < length) group |= buffer[i + 2];
+		*p++ = pgm_read_byte(&alphabet[(group >> 18) & 0x3F]);
+		*p++ = pgm_read_byte(&alphabet[(group >> 12) & 0x3F]);
+		*p++ = i + 1 < length ? pgm_read_byte(&alphabet[(group >> 6) & 0x3F]) : '=';
+		*p++ = i + 2 < length ? pgm_read_byte(&alphabet[group & 0x3F]) : '=';
+	}
+	*p = '\0';
+	return textLength;
+}
+
+
+/// @brief TrackDecoder constructor
+/// @param data a batch from TrackEncoder::data()
+/// @param size its size
+TrackDecoder::TrackDecoder(const uint8_t *data, size_t size)
+	: data(data), size(size), position(1), first(true)
+{
+	valid = size > 0 && data[0] == GPSTRACK_FORMAT;
+}
+
+/// @brief Read the next point
+/// @return false at the end of the batch, or if it is damaged (isValid()
+/// turns false)
+bool TrackDecoder::next(TrackPoint &point)
+{
+	if (!valid || position >= size)
+		return false;
+
+	int32_t lat, lng, time;
+	if (!getVarint(lat) || !getVarint(lng) || !getVarint(time))
+	{
+		valid = false;
+		return false;
+	}
+	if (first)
+	{
+		last.lat = lat;
+		last.lng = lng;
+		last.time = (uint32_t)time;
+		first = false;
+	}
+	else
+	{
+		last.lat += lat;
+		int64_t l = (int64_t)last.lng + lng;
+		// back into -180..180 after crossing the 180 degree meridian
+		if (l > 1800000000LL)
+			l -= 3600000000LL;
+		else if (l < -1800000000LL)
+			l += 3600000000LL;
+		last.lng = (int32_t)l;
+		last.time += (uint32_t)time;
+	}
+	point = last;
+	return true;
+}
+
+bool TrackDecoder::getVarint(int32_t &value)
+{
+	uint32_t v = 0;
+	for (uint8_t shift = 0; shift < 35; shift += 7)
+	{
+		if (position >= size)
+			return false;
+		uint8_t b = data[position++];
+		v |= (uint32_t)(b & 0x7F) << shift;
+		if (!(b & 0x80))
+		{
+			value = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+			return true;
+		}
+	}
+	return false;
+}
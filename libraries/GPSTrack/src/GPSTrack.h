@@ -0,0 +1,213 @@
+#ifndef GPSTrack_h
+#define GPSTrack_h
+
+#include <Arduino.h>
+#include <TinyGPS++.h>
+
+// Corners of the convex hull a TrackSimplifier keeps of the points since
+// the last kept one
+#ifndef GPSTRACK_HULL
+	#define GPSTRACK_HULL 24
+#endif
+
+// Bytes of a TrackEncoder batch. 96 bytes are 128 characters in base64,
+// which fits one SMS.
+#ifndef GPSTRACK_BATCH_SIZE
+	#define GPSTRACK_BATCH_SIZE 96
+#endif
+
+// Fences of a GeofenceSet, at most 32
+#ifndef GEOFENCE_MAX
+	#define GEOFENCE_MAX 8
+#endif
+
+#define GPSTRACK_FORMAT 1
+
+/// A position in 1e-7 degrees, as TinyGPSLocation::latE7() returns it
+struct GeoPoint
+{
+	int32_t lat;
+	int32_t lng;
+};
+
+/// A position with its time, in seconds (Unix time when it comes from the
+/// GPS date and time, see getTrackPoint())
+struct TrackPoint
+{
+	int32_t  lat;
+	int32_t  lng;
+	uint32_t time;
+};
+
+/// Builds a TrackPoint from the last fix. The time is Unix time (UTC) when
+/// the GPS date and time are valid, millis() / 1000 otherwise.
+/// @return false if the location is not valid
+bool getTrackPoint(TinyGPSPlus &gps, TrackPoint &point);
+
+/// Difference of two longitudes (1e-7 degrees) taken the short way round
+int32_t longitudeDelta(int32_t from, int32_t to);
+
+/// Dead-band line simplification of a stream of positions.
+///
+/// A point is only kept when the track leaves a corridor of +-tolerance
+/// meters around the straight line from the last kept point: every point
+/// dropped is within the tolerance of the segment between the kept points
+/// before and after it. A car driving straight sends its end points, a
+/// parked one sends nothing but a heartbeat every maxInterval seconds.
+///
+/// The distance to a segment is largest at a corner of the convex hull of
+/// the points, so only the hull of the points since the last kept one is
+/// held, as offsets in decimeters from it. Points within the tolerance of
+/// the last kept point are left out. A point is kept anyway when the hull
+/// would need more than GPSTRACK_HULL corners or the track gets more than
+/// 3.2 km from the last kept point.
+class TrackSimplifier
+{
+public:
+	TrackSimplifier(float toleranceMeters = 10, uint32_t maxInterval = 300);
+
+	void reset();
+	bool add(const TrackPoint &point);
+	bool flush();
+
+	/// The point kept by the last add() or flush() that returned true
+	const TrackPoint &point() const { return output; }
+
+	void setTolerance(float meters) { tolerance = meters * 10; }
+	void setMaxInterval(uint32_t seconds) { maxInterval = seconds; }
+
+	uint32_t getAdded() const { return added; }
+	uint32_t getKept() const { return kept; }
+
+private:
+	struct Offset
+	{
+		int16_t x, y;                // decimeters east and north of the anchor
+	};
+
+	TrackPoint anchor;               // the last point kept
+	TrackPoint previous;             // the last point added
+	bool       pending = false;      // previous was not kept
+	bool       held = false;         // previous is in the hull (or near the anchor)
+	bool       started = false;
+	TrackPoint output;
+	Offset     hull[GPSTRACK_HULL];  // counterclockwise
+	uint8_t    hullCount = 0;
+	float      decimetersPerLng = 0; // at the anchor's latitude, per 1e-7 degree
+	float      tolerance;            // decimeters
+	uint32_t   maxInterval;
+	uint32_t   added = 0;
+	uint32_t   kept = 0;
+
+	void keep(const TrackPoint &point);
+	bool offset(const TrackPoint &point, Offset &o) const;
+	bool inCorridor(const Offset &end) const;
+	bool addToHull(const Offset &o);
+};
+
+/// Circle and polygon geofences with enter and exit detection.
+///
+/// Each fence has a bounding box computed when it is added. The boxes are
+/// kept sorted by their southern edge, so update() stops at the first box
+/// north of the position and only runs the exact circle or polygon test
+/// for the fences whose box contains it. Fences must not cross the 180
+/// degree meridian.
+class GeofenceSet
+{
+public:
+	GeofenceSet();
+
+	int8_t addCircle(int32_t lat, int32_t lng, uint32_t radiusMeters);
+	int8_t addPolygon(const GeoPoint *vertices, uint8_t count);
+	void   clear();
+
+	uint32_t update(int32_t lat, int32_t lng);
+	uint32_t update(const TrackPoint &point) { return update(point.lat, point.lng); }
+	bool     contains(uint8_t id, int32_t lat, int32_t lng) const;
+
+	/// Fixes in a row a change must be seen for before update() reports it,
+	/// so that GPS noise at the edge of a fence does not flap in and out
+	void setDebounce(uint8_t fixes) { debounce = fixes > 0 ? fixes : 1; }
+
+	bool     isInside(uint8_t id) const { return id < GEOFENCE_MAX && (state >> id) & 1; }
+	uint32_t getInside() const { return state; }
+	uint8_t  getCount() const { return fenceCount; }
+	uint32_t getExactTests() const { return exactTests; }
+
+private:
+	struct Fence
+	{
+		int32_t minLat, maxLat, minLng, maxLng;
+		int32_t lat, lng;            // circle centre
+		uint32_t radius;             // meters, 0 for a polygon
+		const GeoPoint *vertices;
+		uint8_t vertexCount;
+		uint8_t id;
+	};
+
+	Fence    fences[GEOFENCE_MAX];   // sorted by minLat
+	uint8_t  fenceCount;
+	uint8_t  nextId;
+	int32_t  minLat, maxLat, minLng, maxLng; // of all fences
+	uint32_t state;
+	uint8_t  streak[GEOFENCE_MAX];
+	uint8_t  debounce;
+	uint32_t exactTests;
+
+	int8_t insert(Fence &fence);
+	static bool test(const Fence &fence, int32_t lat, int32_t lng);
+};
+
+/// Packs track points into a batch of delta encoded records.
+///
+/// The first byte is GPSTRACK_FORMAT. The first point follows as absolute
+/// values, every other point as its difference to the one before. Each
+/// value is a zigzag varint: 7 bits per byte, the high bit set on all but
+/// the last byte. A point a few hundred meters and seconds from the
+/// previous one takes about 7 bytes instead of 12. TrackDecoder reads a
+/// batch back.
+class TrackEncoder
+{
+public:
+	TrackEncoder() { clear(); }
+
+	void clear();
+	bool add(const TrackPoint &point);
+
+	const uint8_t *data() const { return buffer; }
+	size_t   size() const { return length; }
+	uint8_t  getPoints() const { return points; }
+	bool     isEmpty() const { return points == 0; }
+
+	size_t toBase64(char *out, size_t outSize) const;
+
+private:
+	uint8_t    buffer[GPSTRACK_BATCH_SIZE];
+	size_t     length;
+	uint8_t    points;
+	TrackPoint last;
+
+	static uint8_t putVarint(uint8_t *out, int32_t value);
+};
+
+/// Reads the points of a TrackEncoder batch
+class TrackDecoder
+{
+public:
+	TrackDecoder(const uint8_t *data, size_t size);
+
+	bool next(TrackPoint &point);
+	bool isValid() const { return valid; }
+
+private:
+	const uint8_t *data;
+	size_t     size;
+	size_t     position;
+	bool       valid;
+	bool       first;
+	TrackPoint last;
+
+	bool getVarint(int32_t &value);
+};
+
+#endif
@@ -1,13 +1,14 @@
 //
 //    FILE: HX711.cpp
 //  AUTHOR: Rob Tillaart
-// VERSION: 0.6.1
+// VERSION: 0.6.3
 // PURPOSE: Library for load cells for UNO
 //     URL: https://github.com/RobTillaart/HX711_MP
 //     URL: https://github.com/RobTillaart/HX711
 
 
 #include "HX711.h"
+#include "HX711_sort.h"
 
 
 HX711::HX711()
@@ -179,15 +180,16 @@ float HX711::read_median(uint8_t times)
 {
   if (times > 15) times = 15;
   if (times < 3)  times = 3;
-  float samples[15];
+  //  read() returns whole numbers, int32_t compares are faster than float.
+  int32_t samples[15];
   for (uint8_t i = 0; i < times; i++)
   {
-    samples[i] = read();
+    samples[i] = (int32_t) read();
     yield();
   }
-  _insertSort(samples, times);
+  _selectMiddle(samples, times, false);
   if (times & 0x01) return samples[times/2];
-  return (samples[times/2] + samples[times/2 + 1]) / 2;
+  return ((float)samples[times/2 - 1] + samples[times/2]) / 2;
 }
 
 
@@ -195,14 +197,14 @@ float HX711::read_medavg(uint8_t times)
 {
   if (times > 15) times = 15;
   if (times < 3)  times = 3;
-  float samples[15];
+  int32_t samples[15];
   for (uint8_t i = 0; i < times; i++)
   {
-    samples[i] = read();
+    samples[i] = (int32_t) read();
     yield();
   }
-  _insertSort(samples, times);
-  float sum = 0;
+  _selectMiddle(samples, times, true);
+  int32_t sum = 0;
   //  iterate over 1/4 to 3/4 of the array
   uint8_t count = 0;
   uint8_t first = (times + 2) / 4;
@@ -212,7 +214,7 @@ float HX711::read_medavg(uint8_t times)
     sum += samples[i];
     count++;
   }
-  return sum / count;
+  return (float)sum / count;
 }
 
 
@@ -433,22 +435,45 @@ uint32_t HX711::last_read()
 //  PRIVATE
 //
 
-void HX711::_insertSort(float * array, uint8_t size)
+template <uint8_t N>
+static uint8_t _networkTable(bool medavg, const uint8_t * & table)
 {
-  uint8_t t, z;
-  float temp;
-  for (t = 1; t < size; t++)
+  typedef HX711_network<N> network;
+  if (medavg)
   {
-    z = t;
-    temp = array[z];
-    while( (z > 0) && (temp < array[z - 1] ))
-    {
-      array[z] = array[z - 1];
-      z--;
-    }
-    array[z] = temp;
-    yield();
+    table = network::medavg_table();
+    return network::medavg_type::size;
+  }
+  table = network::median_table();
+  return network::median_type::size;
+}
+
+
+//  size = 3..15
+//  median: puts the median (even size: both middle elements) in place.
+//  medavg: puts the elements read_medavg() averages in place, unordered.
+//  Same compare/swaps for every input, see HX711_sort.h.
+void HX711::_selectMiddle(int32_t * array, uint8_t size, bool medavg)
+{
+  const uint8_t * table = NULL;
+  uint8_t length = 0;
+  switch (size)
+  {
+    case 3:  length = _networkTable<3>(medavg, table);  break;
+    case 4:  length = _networkTable<4>(medavg, table);  break;
+    case 5:  length = _networkTable<5>(medavg, table);  break;
+    case 6:  length = _networkTable<6>(medavg, table);  break;
+    case 7:  length = _networkTable<7>(medavg, table);  break;
+    case 8:  length = _networkTable<8>(medavg, table);  break;
+    case 9:  length = _networkTable<9>(medavg, table);  break;
+    case 10: length = _networkTable<10>(medavg, table); break;
+    case 11: length = _networkTable<11>(medavg, table); break;
+    case 12: length = _networkTable<12>(medavg, table); break;
+    case 13: length = _networkTable<13>(medavg, table); break;
+    case 14: length = _networkTable<14>(medavg, table); break;
+    case 15: length = _networkTable<15>(medavg, table); break;
   }
+  HX711_run_network(array, table, length);
 }
 
 
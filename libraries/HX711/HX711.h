@@ -2,7 +2,7 @@
 //
 //    FILE: HX711.h
 //  AUTHOR: Rob Tillaart
-// VERSION: 0.6.1
+// VERSION: 0.6.3
 // PURPOSE: Library for load cells for Arduino
 //     URL: https://github.com/RobTillaart/HX711_MP
 //     URL: https://github.com/RobTillaart/HX711
@@ -15,7 +15,7 @@
 
 #include "Arduino.h"
 
-#define HX711_LIB_VERSION               (F("0.6.1"))
+#define HX711_LIB_VERSION               (F("0.6.3"))
 
 
 const uint8_t HX711_AVERAGE_MODE = 0x00;
@@ -187,7 +187,7 @@ private:
   uint8_t  _mode;
   bool     _fastProcessor;
 
-  void     _insertSort(float * array, uint8_t size);
+  void     _selectMiddle(int32_t * array, uint8_t size, bool medavg);
   uint8_t  _shiftIn();
 };
 
@@ -0,0 +1,365 @@
+//
+//    FILE: HX711_multi.cpp
+//  AUTHOR: yohanna02
+// VERSION: 0.6.2
+// PURPOSE: Read up to 8 HX711 sharing one clock line in a single pass
+//     URL: https://github.com/yohanna02/arduino
+
+
+#include "HX711_multi.h"
+
+
+HX711_multi::HX711_multi()
+{
+  _channels = 0;
+  _gain     = HX711_CHANNEL_A_GAIN_128;
+  _fastProcessor = false;
+  _parallel = false;
+  _lastTimeRead = 0;
+  for (uint8_t i = 0; i < HX711_MULTI_MAX_CHANNELS; i++)
+  {
+    _offset[i] = 0;
+    _scale[i]  = 1;
+  }
+}
+
+
+bool HX711_multi::begin(const uint8_t * dataPins, uint8_t channels, uint8_t clockPin, bool fastProcessor)
+{
+  if ((channels == 0) || (channels > HX711_MULTI_MAX_CHANNELS)) return false;
+
+  _channels = channels;
+  _clockPin = clockPin;
+  _fastProcessor = fastProcessor;
+  _gain = HX711_CHANNEL_A_GAIN_128;
+
+  for (uint8_t i = 0; i < _channels; i++)
+  {
+    _dataPins[i] = dataPins[i];
+    pinMode(_dataPins[i], INPUT_PULLUP);
+  }
+  pinMode(_clockPin, OUTPUT);
+  digitalWrite(_clockPin, LOW);
+
+  //  the single port read needs all data pins on the same port.
+  _parallel = false;
+#if defined(__AVR__)
+  uint8_t port = digitalPinToPort(_dataPins[0]);
+  _parallel = true;
+  _allMask  = 0;
+  for (uint8_t i = 0; i < _channels; i++)
+  {
+    if (digitalPinToPort(_dataPins[i]) != port) _parallel = false;
+    _dataMask[i] = digitalPinToBitMask(_dataPins[i]);
+    _allMask |= _dataMask[i];
+  }
+  _dataPort  = portInputRegister(port);
+  _clockPort = portOutputRegister(digitalPinToPort(_clockPin));
+  _clockMask = digitalPinToBitMask(_clockPin);
+#endif
+
+  power_down();
+  power_up();
+  return true;
+}
+
+
+uint8_t HX711_multi::channels()
+{
+  return _channels;
+}
+
+
+bool HX711_multi::is_parallel()
+{
+  return _parallel;
+}
+
+
+bool HX711_multi::is_ready()
+{
+#if defined(__AVR__)
+  if (_parallel) return (*_dataPort & _allMask) == 0;
+#endif
+  for (uint8_t i = 0; i < _channels; i++)
+  {
+    if (digitalRead(_dataPins[i]) == HIGH) return false;
+  }
+  return true;
+}
+
+
+void HX711_multi::wait_ready(uint32_t ms)
+{
+  while (!is_ready())
+  {
+    delay(ms);
+  }
+}
+
+
+bool HX711_multi::wait_ready_timeout(uint32_t timeout, uint32_t ms)
+{
+  uint32_t start = millis();
+  while (millis() - start < timeout)
+  {
+    if (is_ready()) return true;
+    delay(ms);
+  }
+  return false;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+//  READ
+//
+//  The HX711's run free, so the first read() waits for the slowest one.
+//  After that they start their conversions on the same clock pulse and
+//  stay close together.
+void HX711_multi::read(int32_t * values)
+{
+  //  this BLOCKING wait takes most time...
+  while (!is_ready()) yield();
+
+#if defined(__AVR__)
+  if (_parallel)
+  {
+    _readParallel(values);
+    _lastTimeRead = millis();
+    return;
+  }
+#endif
+  _readSerial(values);
+  _lastTimeRead = millis();
+}
+
+
+void HX711_multi::read_average(float * values, uint8_t times)
+{
+  if (times < 1) times = 1;
+  int32_t raw[HX711_MULTI_MAX_CHANNELS];
+  for (uint8_t i = 0; i < _channels; i++) values[i] = 0;
+  for (uint8_t t = 0; t < times; t++)
+  {
+    read(raw);
+    for (uint8_t i = 0; i < _channels; i++) values[i] += raw[i];
+    yield();
+  }
+  for (uint8_t i = 0; i < _channels; i++) values[i] /= times;
+}
+
+
+void HX711_multi::get_units(float * units, uint8_t times)
+{
+  read_average(units, times);
+  for (uint8_t i = 0; i < _channels; i++)
+  {
+    units[i] = (units[i] - _offset[i]) * _scale[i];
+  }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+//  GAIN
+//
+bool HX711_multi::set_gain(uint8_t gain, bool forced)
+{
+  if ( (not forced) && (_gain == gain)) return true;
+  switch(gain)
+  {
+    case HX711_CHANNEL_B_GAIN_32:
+    case HX711_CHANNEL_A_GAIN_64:
+    case HX711_CHANNEL_A_GAIN_128:
+    {
+      _gain = gain;
+      int32_t dummy[HX711_MULTI_MAX_CHANNELS];
+      read(dummy);  //  next user read() is from right channel / gain
+      return true;
+    }
+  }
+  return false;   //  unchanged, but incorrect value.
+}
+
+
+uint8_t HX711_multi::get_gain()
+{
+  return _gain;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+//  TARE & CALIBRATION
+//
+void HX711_multi::tare(uint8_t times)
+{
+  float average[HX711_MULTI_MAX_CHANNELS];
+  read_average(average, times);
+  for (uint8_t i = 0; i < _channels; i++)
+  {
+    _offset[i] = average[i];
+  }
+}
+
+
+void HX711_multi::set_offset(uint8_t channel, int32_t offset)
+{
+  if (channel < _channels) _offset[channel] = offset;
+}
+
+
+int32_t HX711_multi::get_offset(uint8_t channel)
+{
+  if (channel >= _channels) return 0;
+  return _offset[channel];
+}
+
+
+bool HX711_multi::set_scale(uint8_t channel, float scale)
+{
+  if ((scale == 0) || (channel >= _channels)) return false;
+  _scale[channel] = 1.0 / scale;
+  return true;
+}
+
+
+float HX711_multi::get_scale(uint8_t channel)
+{
+  if (channel >= _channels) return 0;
+  return 1.0 / _scale[channel];
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+//  POWER MANAGEMENT
+//
+//  powers down ALL HX711's, they wake up with channel A gain 128.
+void HX711_multi::power_down()
+{
+  //  at least 60 us HIGH
+  digitalWrite(_clockPin, HIGH);
+  delayMicroseconds(64);
+}
+
+
+void HX711_multi::power_up()
+{
+  digitalWrite(_clockPin, LOW);
+  _gain = HX711_CHANNEL_A_GAIN_128;
+}
+
+
+uint32_t HX711_multi::last_time_read()
+{
+  return _lastTimeRead;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+//  PRIVATE
+//
+
+//  TABLE 3 page 4 datasheet, see HX711::read()
+uint8_t HX711_multi::_gainPulses()
+{
+  if (_gain == HX711_CHANNEL_A_GAIN_64) return 3;
+  if (_gain == HX711_CHANNEL_B_GAIN_32) return 2;
+  return 1;
+}
+
+
+#if defined(__AVR__)
+//  Only the clock pulses and one port read per bit are done with interrupts
+//  disabled, the bits are sorted out per channel afterwards.
+//  At 16 MHz a clock cycle takes under 1 us, far below the 50 us that would
+//  power down the HX711's.
+void HX711_multi::_readParallel(int32_t * values)
+{
+  volatile uint8_t * clockPort = _clockPort;
+  volatile uint8_t * dataPort  = _dataPort;
+  uint8_t clockMask = _clockMask;
+  uint8_t samples[24];
+
+  noInterrupts();
+  for (uint8_t b = 0; b < 24; b++)
+  {
+    *clockPort |= clockMask;
+    //  T1 DOUT valid >= 0.1 us after rising edge
+    __asm__ __volatile__ ("nop\n\tnop\n\t");
+    samples[b] = *dataPort;
+    *clockPort &= ~clockMask;
+  }
+  for (uint8_t m = _gainPulses(); m > 0; m--)
+  {
+    *clockPort |= clockMask;
+    __asm__ __volatile__ ("nop\n\tnop\n\tnop\n\t");
+    *clockPort &= ~clockMask;
+  }
+  interrupts();
+
+  for (uint8_t i = 0; i < _channels; i++)
+  {
+    uint8_t mask = _dataMask[i];
+    uint32_t value = 0;
+    for (uint8_t b = 0; b < 24; b++)
+    {
+      value <<= 1;
+      if (samples[b] & mask) value |= 1;
+    }
+    //  SIGN extend
+    if (value & 0x800000) value |= 0xFF000000;
+    values[i] = (int32_t) value;
+  }
+}
+#else
+void HX711_multi::_readParallel(int32_t * values)
+{
+  _readSerial(values);
+}
+#endif
+
+
+//  One clock pulse per bit for all channels, data pins read one by one.
+void HX711_multi::_readSerial(int32_t * values)
+{
+  uint32_t value[HX711_MULTI_MAX_CHANNELS];
+  for (uint8_t i = 0; i < _channels; i++) value[i] = 0;
+
+  noInterrupts();
+  for (uint8_t b = 0; b < 24; b++)
+  {
+    digitalWrite(_clockPin, HIGH);
+    //  T2  >= 0.2 us
+    if (_fastProcessor) delayMicroseconds(1);
+    for (uint8_t i = 0; i < _channels; i++)
+    {
+      value[i] <<= 1;
+      if (digitalRead(_dataPins[i]) == HIGH) value[i] |= 1;
+    }
+    digitalWrite(_clockPin, LOW);
+    //  keep duty cycle ~50%
+    if (_fastProcessor) delayMicroseconds(1);
+  }
+  for (uint8_t m = _gainPulses(); m > 0; m--)
+  {
+    digitalWrite(_clockPin, HIGH);
+    if (_fastProcessor) delayMicroseconds(1);
+    digitalWrite(_clockPin, LOW);
+    if (_fastProcessor) delayMicroseconds(1);
+  }
+  interrupts();
+
+  for (uint8_t i = 0; i < _channels; i++)
+  {
+    //  SIGN extend
+    if (value[i] & 0x800000) value[i] |= 0xFF000000;
+    values[i] = (int32_t) value[i];
+  }
+}
+
+
+//  -- END OF FILE --
@@ -0,0 +1,101 @@
+#pragma once
+//
+//    FILE: HX711_multi.h
+//  AUTHOR: yohanna02
+// VERSION: 0.6.2
+// PURPOSE: Read up to 8 HX711 sharing one clock line in a single pass
+//     URL: https://github.com/yohanna02/arduino
+//
+//  NOTES
+//  All HX711's get the same clock pulses, so they share gain and channel.
+//  If all data pins are on one AVR port, every bit of all channels is
+//  sampled with a single port read.
+
+
+#include "HX711.h"
+
+
+#define HX711_MULTI_MAX_CHANNELS        8
+
+
+class HX711_multi
+{
+public:
+  HX711_multi();
+
+  //  returns false if channels is 0 or more than HX711_MULTI_MAX_CHANNELS.
+  bool     begin(const uint8_t * dataPins, uint8_t channels, uint8_t clockPin, bool fastProcessor = false);
+  uint8_t  channels();
+  //  true if all data pins are sampled with one port read.
+  bool     is_parallel();
+
+  //  true if ALL HX711's have a sample ready.
+  bool     is_ready();
+  void     wait_ready(uint32_t ms = 0);
+  bool     wait_ready_timeout(uint32_t timeout = 1000, uint32_t ms = 0);
+
+
+  ///////////////////////////////////////////////////////////////
+  //
+  //  READ
+  //
+  //  raw read of all channels, values must hold channels() elements.
+  void     read(int32_t * values);
+  //  average of times raw reads per channel.
+  void     read_average(float * values, uint8_t times = 10);
+  //  corrected for offset and scale, per channel.
+  void     get_units(float * units, uint8_t times = 1);
+
+
+  ///////////////////////////////////////////////////////////////
+  //
+  //  GAIN, TARE, CALIBRATION
+  //
+  //  gain applies to all channels as they share the clock.
+  bool     set_gain(uint8_t gain = HX711_CHANNEL_A_GAIN_128, bool forced = false);
+  uint8_t  get_gain();
+
+  void     tare(uint8_t times = 10);
+  void     set_offset(uint8_t channel, int32_t offset = 0);
+  int32_t  get_offset(uint8_t channel);
+  //  returns false if scale == 0 or channel out of range.
+  bool     set_scale(uint8_t channel, float scale = 1.0);
+  float    get_scale(uint8_t channel);
+
+
+  ///////////////////////////////////////////////////////////////
+  //
+  //  POWER MANAGEMENT
+  //
+  void     power_down();
+  void     power_up();
+
+  uint32_t last_time_read();
+
+
+private:
+  uint8_t  _dataPins[HX711_MULTI_MAX_CHANNELS];
+  int32_t  _offset[HX711_MULTI_MAX_CHANNELS];
+  float    _scale[HX711_MULTI_MAX_CHANNELS];
+  uint8_t  _channels;
+  uint8_t  _clockPin;
+  uint8_t  _gain;
+  bool     _fastProcessor;
+  bool     _parallel;
+  uint32_t _lastTimeRead;
+
+#if defined(__AVR__)
+  volatile uint8_t * _dataPort;
+  volatile uint8_t * _clockPort;
+  uint8_t  _dataMask[HX711_MULTI_MAX_CHANNELS];
+  uint8_t  _allMask;
+  uint8_t  _clockMask;
+#endif
+
+  void     _readParallel(int32_t * values);
+  void     _readSerial(int32_t * values);
+  uint8_t  _gainPulses();
+};
+
+
+//  -- END OF FILE --
@@ -0,0 +1,227 @@
+#pragma once
+//
+//    FILE: HX711_sort.h
+//  AUTHOR: yohanna02
+// VERSION: 0.6.3
+// PURPOSE: Compile time selection networks for read_median() and read_medavg()
+//     URL: https://github.com/yohanna02/arduino
+//
+//  NOTES
+//  A network is Batcher's odd-even merge sort for 16 elements, with the
+//  comparators that touch an element >= N removed (those act as +infinity).
+//  Working backwards from the outputs that are needed (the median, or the
+//  middle half for medavg) every comparator that cannot influence them is
+//  removed too. What is left always does the same compare/swaps, whatever
+//  the data, and needs fewer comparisons than the insertion sort it replaces.
+//
+//  Every comparator is one byte, (i << 4) | j with i < j.
+//  The networks are C++11 types, so the same list can be used
+//  - unrolled, for a fixed size:        HX711_network<7>::median(array);
+//  - as a PROGMEM table for any size:   HX711::read_median(times);
+
+
+#include "Arduino.h"
+
+
+//  list of comparators
+template <uint8_t... C>
+struct HX711_comparators
+{
+  enum { size = sizeof...(C) };
+};
+
+
+namespace HX711_detail
+{
+
+template <class A, class B>
+struct concat;
+
+template <uint8_t... A, uint8_t... B>
+struct concat<HX711_comparators<A...>, HX711_comparators<B...> >
+{
+  typedef HX711_comparators<A..., B...> type;
+};
+
+
+//  single comparator, dropped if it touches an element >= N
+template <uint8_t I, uint8_t J, uint8_t N, bool KEEP = (J < N)>
+struct comparator
+{
+  typedef HX711_comparators<(I << 4) | J> type;
+};
+
+template <uint8_t I, uint8_t J, uint8_t N>
+struct comparator<I, J, N, false>
+{
+  typedef HX711_comparators<> type;
+};
+
+
+//  compare(i, i + R) for i = I, I + 2R, ... while i + R < END
+template <uint8_t I, uint8_t END, uint8_t R, uint8_t N, bool MORE = (I + R < END)>
+struct merge_step
+{
+  typedef typename concat<
+    typename comparator<I, I + R, N>::type,
+    typename merge_step<I + 2 * R, END, R, N>::type >::type type;
+};
+
+template <uint8_t I, uint8_t END, uint8_t R, uint8_t N>
+struct merge_step<I, END, R, N, false>
+{
+  typedef HX711_comparators<> type;
+};
+
+
+//  odd-even merge of LO .. LO + LEN - 1 with stride R
+template <uint8_t LO, uint8_t LEN, uint8_t R, uint8_t N, bool SPLIT = (2 * R < LEN)>
+struct merge
+{
+  typedef typename concat<
+    typename concat<
+      typename merge<LO, LEN, 2 * R, N>::type,
+      typename merge<LO + R, LEN, 2 * R, N>::type >::type,
+    typename merge_step<LO + R, LO + LEN, R, N>::type >::type type;
+};
+
+template <uint8_t LO, uint8_t LEN, uint8_t R, uint8_t N>
+struct merge<LO, LEN, R, N, false>
+{
+  typedef typename comparator<LO, LO + R, N>::type type;
+};
+
+
+//  odd-even merge sort of LO .. LO + LEN - 1
+template <uint8_t LO, uint8_t LEN, uint8_t N, bool SPLIT = (LEN > 1)>
+struct sort
+{
+  typedef typename concat<
+    typename concat<
+      typename sort<LO, LEN / 2, N>::type,
+      typename sort<LO + LEN / 2, LEN / 2, N>::type >::type,
+    typename merge<LO, LEN, 1, N>::type >::type type;
+};
+
+template <uint8_t LO, uint8_t LEN, uint8_t N>
+struct sort<LO, LEN, N, false>
+{
+  typedef HX711_comparators<> type;
+};
+
+
+//  remove comparators that cannot change the outputs in MASK.
+//  The list is walked from the back; mask holds the elements still needed.
+template <uint16_t MASK, class L>
+struct prune;
+
+template <uint16_t MASK>
+struct prune<MASK, HX711_comparators<> >
+{
+  typedef HX711_comparators<> type;
+  static const uint16_t mask = MASK;
+};
+
+template <uint16_t MASK, uint8_t C, uint8_t... REST>
+struct prune<MASK, HX711_comparators<C, REST...> >
+{
+  typedef prune<MASK, HX711_comparators<REST...> > tail;
+  static const uint16_t pair = (1U << (C >> 4)) | (1U << (C & 0x0F));
+  static const bool needed = (tail::mask & pair) != 0;
+  static const uint16_t mask = needed ? (tail::mask | pair) : tail::mask;
+  typedef typename concat<
+    typename comparator<(C >> 4), (C & 0x0F), (needed ? 16 : 0)>::type,
+    typename tail::type >::type type;
+};
+
+
+//  bits FIRST .. LAST
+template <uint8_t FIRST, uint8_t LAST>
+struct range_mask
+{
+  static const uint16_t value = (uint16_t)(((1UL << (LAST + 1)) - 1) & ~((1UL << FIRST) - 1));
+};
+
+
+//  written as min / max so it compiles without branches where the
+//  processor has conditional moves.
+inline void compare_swap(int32_t & a, int32_t & b)
+{
+  int32_t lo = (b < a) ? b : a;
+  int32_t hi = (b < a) ? a : b;
+  a = lo;
+  b = hi;
+}
+
+
+template <class L>
+struct apply;
+
+template <uint8_t... C>
+struct apply<HX711_comparators<C...> >
+{
+  static void run(int32_t * array)
+  {
+    //  a braced list is evaluated left to right
+    int order[] = { 0, (compare_swap(array[C >> 4], array[C & 0x0F]), 0)... };
+    (void) order;
+  }
+};
+
+
+template <class L>
+struct table;
+
+template <uint8_t... C>
+struct table<HX711_comparators<C...> >
+{
+  static const uint8_t data[sizeof...(C)];
+};
+
+template <uint8_t... C>
+const uint8_t table<HX711_comparators<C...> >::data[sizeof...(C)] PROGMEM = { C... };
+
+}  //  namespace HX711_detail
+
+
+//  networks for N = 3..15 elements
+template <uint8_t N>
+struct HX711_network
+{
+  static_assert(N >= 3 && N <= 15, "HX711_network supports 3..15 elements");
+
+  //  full sort
+  typedef typename HX711_detail::sort<0, 16, N>::type sort_type;
+
+  //  median, for even N the two middle elements
+  typedef typename HX711_detail::prune<
+    HX711_detail::range_mask<(N - 1) / 2, N / 2>::value, sort_type>::type median_type;
+
+  //  the elements read_medavg() averages, without ordering them
+  enum { first = (N + 2) / 4, last = N - first - 1 };
+  typedef typename HX711_detail::prune<
+    HX711_detail::range_mask<first, last>::value, sort_type>::type medavg_type;
+
+  static void sort(int32_t * array)   { HX711_detail::apply<sort_type>::run(array); }
+  static void median(int32_t * array) { HX711_detail::apply<median_type>::run(array); }
+  static void medavg(int32_t * array) { HX711_detail::apply<medavg_type>::run(array); }
+
+  //  PROGMEM tables
+  static const uint8_t * median_table()  { return HX711_detail::table<median_type>::data; }
+  static const uint8_t * medavg_table()  { return HX711_detail::table<medavg_type>::data; }
+};
+
+
+//  run a PROGMEM network from HX711_network<N>::median_table() or medavg_table()
+inline void HX711_run_network(int32_t * array, const uint8_t * table, uint8_t size)
+{
+  for (uint8_t k = 0; k < size; k++)
+  {
+    uint8_t c = pgm_read_byte(table + k);
+    HX711_detail::compare_swap(array[c >> 4], array[c & 0x0F]);
+  }
+}
+
+
+//  -- END OF FILE --
+
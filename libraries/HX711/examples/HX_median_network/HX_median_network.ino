@@ -0,0 +1,122 @@
+//
+//    FILE: HX_median_network.ino
+//  AUTHOR: Rob Tillaart
+// PURPOSE: measure the selection networks used by read_median() on the board
+//     URL: https://github.com/RobTillaart/HX711
+//
+//  No HX711 needed, the samples are made up.
+//  Compares the insertion sort read_median() used before 0.6.3
+//  with the PROGMEM network it uses now and the unrolled network.
+//  Prints the clock cycles per call, for N = 3 .. 15.
+
+
+#include "HX711.h"
+#include "HX711_sort.h"
+
+
+const uint16_t ROUNDS = 200;
+
+uint32_t start, stop;
+volatile int32_t sink;
+
+
+//  read_median() before 0.6.3
+void insertSort(float * array, uint8_t size)
+{
+  uint8_t t, z;
+  float temp;
+  for (t = 1; t < size; t++)
+  {
+    z = t;
+    temp = array[z];
+    while( (z > 0) && (temp < array[z - 1] ))
+    {
+      array[z] = array[z - 1];
+      z--;
+    }
+    array[z] = temp;
+  }
+}
+
+
+void fill(int32_t * array, uint8_t size)
+{
+  for (uint8_t i = 0; i < size; i++)
+  {
+    array[i] = 200000 + random(-2000, 2001);
+  }
+}
+
+
+float cyclesPerCall(uint32_t us)
+{
+  return (float)us * (F_CPU / 1000000UL) / ROUNDS;
+}
+
+
+template <uint8_t N>
+void measure()
+{
+  typedef HX711_network<N> network;
+  int32_t samples[15];
+  float   f[15];
+  uint32_t tInsert = 0, tTable = 0, tUnrolled = 0;
+
+  for (uint16_t r = 0; r < ROUNDS; r++)
+  {
+    fill(samples, N);
+    for (uint8_t i = 0; i < N; i++) f[i] = samples[i];
+    start = micros();
+    insertSort(f, N);
+    stop = micros();
+    tInsert += stop - start;
+    sink = f[N / 2];
+
+    fill(samples, N);
+    start = micros();
+    HX711_run_network(samples, network::median_table(), network::median_type::size);
+    stop = micros();
+    tTable += stop - start;
+    sink = samples[N / 2];
+
+    fill(samples, N);
+    start = micros();
+    network::median(samples);
+    stop = micros();
+    tUnrolled += stop - start;
+    sink = samples[N / 2];
+  }
+
+  Serial.print(N);
+  Serial.print("\t");
+  Serial.print(cyclesPerCall(tInsert), 0);
+  Serial.print("\t");
+  Serial.print(cyclesPerCall(tTable), 0);
+  Serial.print("\t");
+  Serial.println(cyclesPerCall(tUnrolled), 0);
+}
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println(__FILE__);
+  Serial.print("HX711_LIB_VERSION: ");
+  Serial.println(HX711_LIB_VERSION);
+  Serial.println();
+
+  Serial.println("cycles per call (micros() resolution, includes timer overhead)");
+  Serial.println("N\tinsert\ttable\tunrolled");
+  measure<3>();  measure<5>();  measure<7>();  measure<9>();
+  measure<11>(); measure<13>(); measure<15>();
+  Serial.println("\ndone...");
+}
+
+
+void loop()
+{
+}
+
+
+//  -- END OF FILE --
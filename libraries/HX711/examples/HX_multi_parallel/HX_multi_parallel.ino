@@ -0,0 +1,92 @@
+//
+//    FILE: HX_multi_parallel.ino
+//  AUTHOR: Rob Tillaart
+// PURPOSE: HX711_multi demo, compares parallel read with one HX711 per cell
+//     URL: https://github.com/RobTillaart/HX711
+//
+//  four load cells sharing one clock line.
+//  data pins 3..6 are all on PORTD of an UNO, so one port read per bit.
+
+
+#include "HX711.h"
+#include "HX711_multi.h"
+
+HX711_multi scales;
+
+HX711 scale[4];
+
+//  adjust pins if needed
+const uint8_t dataPin[4] = { 3, 4, 5, 6 };
+const uint8_t clockPin = 7;
+
+//  TODO you need to adjust to your calibrated scale values
+float calib[4] = { 420.0983, 421.365, 419.200, 410.236 };
+
+uint32_t start, stop;
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println(__FILE__);
+  Serial.print("HX711_LIB_VERSION: ");
+  Serial.println(HX711_LIB_VERSION);
+  Serial.println();
+
+  //  one HX711 object per cell, for comparison.
+  for (int i = 0; i < 4; i++)
+  {
+    scale[i].begin(dataPin[i], clockPin);
+  }
+
+  scales.begin(dataPin, 4, clockPin);
+  Serial.print("PARALLEL:\t");
+  Serial.println(scales.is_parallel());
+
+  //  time only the clocking, not the wait for the next sample.
+  int32_t values[4];
+  scales.wait_ready();
+  start = micros();
+  scales.read(values);
+  stop = micros();
+  Serial.print("HX711_multi read 4x:\t");
+  Serial.println(stop - start);
+
+  uint32_t total = 0;
+  for (int i = 0; i < 4; i++)
+  {
+    scale[i].wait_ready();
+    start = micros();
+    scale[i].read();
+    stop = micros();
+    total += stop - start;
+  }
+  Serial.print("HX711 read 4x:\t\t");
+  Serial.println(total);
+  Serial.println();
+
+  for (int i = 0; i < 4; i++)
+  {
+    scales.set_scale(i, calib[i]);
+  }
+  //  reset the scales to zero = 0
+  scales.tare();
+}
+
+
+void loop()
+{
+  float units[4];
+  scales.get_units(units, 5);
+  for (int i = 0; i < 4; i++)
+  {
+    Serial.print(units[i]);
+    Serial.print("\t");
+  }
+  Serial.println();
+  delay(250);
+}
+
+
+//  -- END OF FILE --
@@ -0,0 +1,15 @@
+//  Minimal Arduino stand-in for running HX711_sort.h on a desktop machine.
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROGMEM
+#define pgm_read_byte(p)      (*(const uint8_t *)(p))
+
+inline void yield() {}
+
+#endif
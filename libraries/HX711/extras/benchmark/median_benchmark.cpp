@@ -0,0 +1,142 @@
+//
+//    FILE: median_benchmark.cpp
+//  AUTHOR: Rob Tillaart
+// PURPOSE: host benchmark of the read_median() / read_medavg() selection
+//          networks against the insertion sort they replace.
+//     URL: https://github.com/RobTillaart/HX711
+//
+//  Build and run with ./run.sh
+//
+//  For every size 3..15 the same random 24 bit samples go through
+//  - the old insertion sort on float (comparisons counted: min / avg / max)
+//  - the PROGMEM table network on int32_t, as used by HX711::read_median()
+//  - the unrolled HX711_network<N>::median()
+//  Every result is checked against std::sort.
+//  Times are cycles per call (x86 time stamp counter), best of 5 runs.
+
+
+#include <algorithm>
+#include <stdio.h>
+#include <x86intrin.h>
+
+#include "Arduino.h"
+#include "../../HX711_sort.h"
+
+
+#define ROUNDS    20000
+
+static uint32_t comparisons;
+
+//  copy of the old HX711::_insertSort(), with counted compares
+static void insertSort(float * array, uint8_t size)
+{
+  uint8_t t, z;
+  float temp;
+  for (t = 1; t < size; t++)
+  {
+    z = t;
+    temp = array[z];
+    while( (z > 0) && (comparisons++, temp < array[z - 1] ))
+    {
+      array[z] = array[z - 1];
+      z--;
+    }
+    array[z] = temp;
+    yield();
+  }
+}
+
+
+static int32_t  samples[ROUNDS][15];
+static volatile int32_t sink;
+
+
+template <uint8_t N>
+static void run()
+{
+  typedef HX711_network<N> network;
+
+  //  comparisons of the insertion sort depend on the data
+  uint32_t minCmp = 0xFFFFFFFF, maxCmp = 0, sumCmp = 0;
+  for (uint32_t r = 0; r < ROUNDS; r++)
+  {
+    float f[15];
+    int32_t a[15], b[15], ref[15];
+    for (uint8_t i = 0; i < N; i++) f[i] = a[i] = b[i] = ref[i] = samples[r][i];
+    comparisons = 0;
+    insertSort(f, N);
+    if (comparisons < minCmp) minCmp = comparisons;
+    if (comparisons > maxCmp) maxCmp = comparisons;
+    sumCmp += comparisons;
+
+    std::sort(ref, ref + N);
+    HX711_run_network(a, network::median_table(), network::median_type::size);
+    network::median(b);
+    for (uint8_t i = (N - 1) / 2; i <= N / 2; i++)
+    {
+      if (a[i] != ref[i] || b[i] != ref[i] || f[i] != ref[i])
+      {
+        printf("MISMATCH N=%d\n", N);
+        exit(1);
+      }
+    }
+  }
+
+  uint64_t best[3] = { ~0ULL, ~0ULL, ~0ULL };
+  for (int run = 0; run < 5; run++)
+  {
+    for (int method = 0; method < 3; method++)
+    {
+      uint64_t start = __rdtsc();
+      for (uint32_t r = 0; r < ROUNDS; r++)
+      {
+        if (method == 0)
+        {
+          float f[15];
+          for (uint8_t i = 0; i < N; i++) f[i] = samples[r][i];
+          insertSort(f, N);
+          sink = f[N / 2];
+        }
+        else
+        {
+          int32_t a[15];
+          for (uint8_t i = 0; i < N; i++) a[i] = samples[r][i];
+          if (method == 1) HX711_run_network(a, network::median_table(), network::median_type::size);
+          else network::median(a);
+          sink = a[N / 2];
+        }
+      }
+      uint64_t cycles = __rdtsc() - start;
+      if (cycles < best[method]) best[method] = cycles;
+    }
+  }
+
+  printf("%4d  %6u %6.1f %6u   %6d %6d  %9.1f %9.1f %9.1f\n", N,
+    minCmp, (double)sumCmp / ROUNDS, maxCmp,
+    network::median_type::size, network::medavg_type::size,
+    (double)best[0] / ROUNDS, (double)best[1] / ROUNDS, (double)best[2] / ROUNDS);
+}
+
+
+int main()
+{
+  srand(711);
+  for (uint32_t r = 0; r < ROUNDS; r++)
+  {
+    for (uint8_t i = 0; i < 15; i++)
+    {
+      //  load cell around 200000 with +-2000 counts of noise
+      samples[r][i] = 200000 + rand() % 4001 - 2000;
+    }
+  }
+
+  printf("        insertion sort           network       cycles per call\n");
+  printf("   N     min    avg    max   median medavg     insert     table  unrolled\n");
+  run<3>();  run<4>();  run<5>();  run<6>();  run<7>();
+  run<8>();  run<9>();  run<10>(); run<11>(); run<12>();
+  run<13>(); run<14>(); run<15>();
+  return 0;
+}
+
+
+//  -- END OF FILE --
@@ -0,0 +1,7 @@
+#!/bin/sh
+# Builds the HX711 median benchmark and runs it (x86 hosts).
+set -e
+cd "$(dirname "$0")"
+g++ -O2 -I. -o median_benchmark median_benchmark.cpp
+./median_benchmark
+rm -f median_benchmark
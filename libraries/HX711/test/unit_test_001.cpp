@@ -26,6 +26,8 @@
 
 #include "Arduino.h"
 #include "HX711.h"
+#include "HX711_multi.h"
+#include "HX711_sort.h"
 
 
 uint8_t dataPin = 6;
@@ -186,6 +188,51 @@ unittest(test_operational_mode)
 }
 
 
+unittest(test_multi)
+{
+  HX711_multi scales;
+  uint8_t dataPins[9] = { 2, 3, 4, 5, 6, 8, 9, 10, 11 };
+
+  assertFalse(scales.begin(dataPins, 0, clockPin));
+  assertFalse(scales.begin(dataPins, 9, clockPin));
+  assertTrue(scales.begin(dataPins, 4, clockPin));
+  assertEqual(4, scales.channels());
+  assertEqual(128, scales.get_gain());
+
+  //  pins are default LOW apparently.
+  assertTrue(scales.is_ready());
+
+  assertTrue(scales.set_scale(2, 420.0));
+  assertEqualFloat(420.0, scales.get_scale(2), 0.01);
+  assertFalse(scales.set_scale(2, 0));
+  assertFalse(scales.set_scale(4, 1.0));
+
+  scales.set_offset(1, -1234);
+  assertEqual(-1234, scales.get_offset(1));
+  assertEqual(0, scales.get_offset(0));
+}
+
+
+unittest(test_network)
+{
+  assertEqual(19, HX711_network<7>::median_type::size);
+  assertEqual(49, HX711_network<15>::median_type::size);
+  assertEqual(59, HX711_network<15>::sort_type::size);
+
+  int32_t a[7] = { 50, -3, 700, 12, 12, -800, 4 };
+  HX711_network<7>::median(a);
+  assertEqual(12, a[3]);
+
+  int32_t b[7] = { 50, -3, 700, 12, 12, -800, 4 };
+  HX711_run_network(b, HX711_network<7>::median_table(), HX711_network<7>::median_type::size);
+  assertEqual(12, b[3]);
+
+  int32_t c[8] = { 8, 7, 6, 5, 4, 3, 2, 1 };
+  HX711_network<8>::sort(c);
+  for (int i = 0; i < 8; i++) assertEqual(i + 1, c[i]);
+}
+
+
 unittest_main()
 
 
@@ -0,0 +1,82 @@
+/*
+   -------------------------------------------------------------------------------------
+   HX711_ADC
+   Arduino library for HX711 24-Bit Analog-to-Digital Converter for Weight Scales
+   Olav Kallhovd sept2017
+   -------------------------------------------------------------------------------------
+*/
+/*
+   Settling time (number of samples) and data filtering can be adjusted in the config.h file
+   For calibration and storing the calibration value in eeprom, see example file "Calibration.ino"
+
+   This example shows how to use interrupt mode: every conversion is read out from an interrupt on the dout pin
+   as soon as it is ready and put in a queue. update() then adds all queued conversions to the dataset,
+   so the filter gets every conversion even if the loop() is blocked for a while, i.e. by a slow display refresh.
+   The delay() in the loop() simulates such time consuming code.
+   The queue size can be set in the config.h file (RAW_QUEUE_SIZE).
+   The pin used for dout must be external interrupt capable.
+*/
+
+#include <HX711_ADC.h>
+
+const int HX711_dout = 3; //mcu > HX711 dout pin, must be external interrupt capable!
+const int HX711_sck = 5; //mcu > HX711 sck pin
+
+//HX711 constructor:
+HX711_ADC LoadCell(HX711_dout, HX711_sck);
+
+unsigned long t = 0;
+
+void setup() {
+  Serial.begin(57600); delay(10);
+  Serial.println();
+  Serial.println("Starting...");
+
+  float calibrationValue; // calibration value
+  calibrationValue = 696.0; // set this to the value found with the Calibration.ino example
+
+  LoadCell.begin();
+  unsigned long stabilizingtime = 2000; // tare preciscion can be improved by adding a few seconds of stabilizing time
+  boolean _tare = true; //set this to false if you don't want tare to be performed in the next step
+  LoadCell.start(stabilizingtime, _tare);
+  if (LoadCell.getTareTimeoutFlag()) {
+    Serial.println("Timeout, check MCU>HX711 wiring and pin designations");
+    while (1);
+  }
+  LoadCell.setCalFactor(calibrationValue); // set calibration value (float)
+
+  if (!LoadCell.beginInterrupt()) {
+    Serial.println("HX711 dout pin is not external interrupt capable");
+    while (1);
+  }
+  Serial.println("Startup is complete");
+}
+
+void loop() {
+  const int serialPrintInterval = 500; //increase value to slow down serial print activity
+
+  // add all queued conversions to the dataset:
+  if (LoadCell.update()) {
+    if (millis() > t + serialPrintInterval) {
+      Serial.print("Load_cell output val: ");
+      Serial.print(LoadCell.getData());
+      Serial.print("  dropped conversions: ");
+      Serial.println(LoadCell.getOverrunCount());
+      t = millis();
+    }
+  }
+
+  delay(50); // time consuming code, conversions keep coming in from the interrupt meanwhile
+
+  // receive command from serial terminal, send 't' to initiate tare operation:
+  if (Serial.available() > 0) {
+    char inByte = Serial.read();
+    if (inByte == 't') LoadCell.tareNoDelay();
+  }
+
+  //check if last tare operation is complete
+  if (LoadCell.getTareStatus() == true) {
+    Serial.println("Tare complete");
+  }
+
+}
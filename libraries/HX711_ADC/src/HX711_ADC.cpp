@@ -9,6 +9,7 @@
 #include <Arduino.h>
 #include <HX711_ADC.h>
 
+HX711_ADC * volatile HX711_ADC::isrInstance[INTERRUPT_INSTANCES];
 
 HX711_ADC::HX711_ADC(uint8_t dout, uint8_t sck) //constructor
 { 	
@@ -235,6 +236,19 @@ float HX711_ADC::getCalFactor()
 //else returns 0
 uint8_t HX711_ADC::update() 
 {
+	if (interruptMode)
+	{
+		if (processQueue())
+		{
+			lastDoutLowTime = millis();
+			signalTimeoutFlag = 0;
+		}
+		else if (millis() - lastDoutLowTime > SIGNAL_TIMEOUT)
+		{
+			signalTimeoutFlag = 1;
+		}
+		return convRslt;
+	}
 	byte dout = digitalRead(doutPin); //check if conversion is ready
 	if (!dout) 
 	{
@@ -259,6 +273,21 @@ uint8_t HX711_ADC::update()
 // returns 1 if data available , else 0
 bool HX711_ADC::dataWaitingAsync() 
 {
+	if (interruptMode)
+	{
+		if (queueTail != queueHead) 
+		{
+			lastDoutLowTime = millis();
+			signalTimeoutFlag = 0;
+			return 1;
+		}
+		if (millis() - lastDoutLowTime > SIGNAL_TIMEOUT)
+		{
+			signalTimeoutFlag = 1;
+		}
+		convRslt = 0;
+		return 0;
+	}
 	if (dataWaiting) { lastDoutLowTime = millis(); return 1; }
 	byte dout = digitalRead(doutPin); //check if conversion is ready
 	if (!dout) 
@@ -284,6 +313,7 @@ bool HX711_ADC::dataWaitingAsync()
 // call getData() to get latest value
 bool HX711_ADC::updateAsync() 
 {
+	if (interruptMode) return processQueue() > 0;
 	if (dataWaiting) { 
 		conversion24bit();
 		dataWaiting = false;
@@ -330,12 +360,19 @@ long HX711_ADC::smoothedData()
 
 void HX711_ADC::conversion24bit()  //read 24 bit data, store in dataset and start the next conversion
 {
-	conversionTime = micros() - conversionStartTime;
-	conversionStartTime = micros();
+	addSample(readRaw(false));
+}
+
+//clock out the 24 bit data + gain pulses, this also starts the next conversion
+//called from loop() in polled mode and from the dout interrupt in interrupt mode
+unsigned long HX711_ADC_ISR_ATTR HX711_ADC::readRaw(bool isr)
+{
+	unsigned long now = micros();
+	conversionTime = now - conversionStartTime;
+	conversionStartTime = now;
 	unsigned long data = 0;
 	uint8_t dout;
-	convRslt = 0;
-	if(SCK_DISABLE_INTERRUPTS) noInterrupts();
+	if(SCK_DISABLE_INTERRUPTS && !isr) noInterrupts();
 
 	for (uint8_t i = 0; i < (24 + GAIN); i++) 
 	{ 	//read 24 bit data + set gain and start next conversion
@@ -350,23 +387,35 @@ void HX711_ADC::conversion24bit()  //read 24 bit data, store in dataset and star
 			if(SCK_DELAY) delayMicroseconds(1); // could be required for faster mcu's, set value in config.h
 		}
 	}
-	if(SCK_DISABLE_INTERRUPTS) interrupts();
-	
-	/*
-	The HX711 output range is min. 0x800000 and max. 0x7FFFFF (the value rolls over).
-	In order to convert the range to min. 0x000000 and max. 0xFFFFFF,
-	the 24th bit must be changed from 0 to 1 or from 1 to 0.
-	*/
-	data = data ^ 0x800000; // flip the 24th bit 
-	
-	if (data > 0xFFFFFF) 
+	if(SCK_DISABLE_INTERRUPTS && !isr) interrupts();
+	return data;
+}
+
+/*
+The HX711 output range is min. 0x800000 and max. 0x7FFFFF (the value rolls over).
+In order to convert the range to min. 0x000000 and max. 0xFFFFFF,
+the 24th bit must be changed from 0 to 1 or from 1 to 0.
+Has no hardware access, so it can be tested on a PC.
+*/
+long HX711_ADC::decodeRaw(unsigned long raw, bool reverse)
+{
+	unsigned long data = (raw ^ 0x800000) & 0xFFFFFF; // flip the 24th bit 
+	if (reverse) {
+		data = 0xFFFFFF - data;
+	}
+	return (long)data;
+}
+
+//store a raw conversion in the dataset, complete the tare operation if one is running
+void HX711_ADC::addSample(unsigned long raw)
+{
+	convRslt = 0;
+	if (raw > 0xFFFFFF) 
 	{
 		dataOutOfRange = 1;
 		//Serial.println("dataOutOfRange");
 	}
-	if (reverseVal) {
-		data = 0xFFFFFF - data;
-	}
+	long data = decodeRaw(raw, reverseVal);
 	if (readIndex == samplesInUse + IGN_HIGH_SAMPLE + IGN_LOW_SAMPLE - 1) 
 	{
 		readIndex = 0;
@@ -378,7 +427,7 @@ void HX711_ADC::conversion24bit()  //read 24 bit data, store in dataset and star
 	if(data > 0)  
 	{
 		convRslt++;
-		dataSampleSet[readIndex] = (long)data;
+		dataSampleSet[readIndex] = data;
 		if(doTare) 
 		{
 			if (tareTimes < DATA_SET) 
@@ -397,6 +446,49 @@ void HX711_ADC::conversion24bit()  //read 24 bit data, store in dataset and star
 	}
 }
 
+//interrupt mode: add every queued conversion to the dataset, oldest first
+//returns the number of conversions taken from the queue, convRslt is set to 2 if a tare operation completed on any of them
+uint8_t HX711_ADC::processQueue()
+{
+	uint8_t count = 0;
+	uint8_t rslt = 0;
+	uint8_t tail = queueTail;
+	while (tail != queueHead) 
+	{
+		addSample(rawQueue[tail]);
+		tail = (tail + 1) & (RAW_QUEUE_SIZE - 1);
+		queueTail = tail; // hand the slot back to the interrupt after it has been read
+		if (convRslt > rslt) rslt = convRslt;
+		count++;
+	}
+	convRslt = rslt;
+	return count;
+}
+
+//dout interrupt (falling edge): read out the conversion and put it in the queue
+void HX711_ADC_ISR_ATTR HX711_ADC::dataReadyISR()
+{
+	//dout also toggles while the data is clocked out, those edges can trigger the interrupt again.
+	//A new conversion is only ready while dout is low.
+	if (digitalRead(doutPin)) return;
+	unsigned long raw = readRaw(true); // the HX711 must be read out to start the next conversion, even if the queue is full
+	uint8_t head = queueHead;
+	uint8_t next = (head + 1) & (RAW_QUEUE_SIZE - 1);
+	if (next == queueTail) 
+	{
+		overrunCount++;
+		return;
+	}
+	rawQueue[head] = raw;
+	queueHead = next;
+}
+
+template <uint8_t slot> void HX711_ADC_ISR_ATTR HX711_ADC::isrSlot()
+{
+	HX711_ADC *adc = isrInstance[slot];
+	if (adc) adc->dataReadyISR();
+}
+
 //power down the HX711
 void HX711_ADC::powerDown() 
 {
@@ -433,7 +525,10 @@ int HX711_ADC::getReadIndex()
 //returns latest conversion time in millis
 float HX711_ADC::getConversionTime()
 {
-	return conversionTime/1000.0;
+	noInterrupts(); // updated by the dout interrupt in interrupt mode
+	unsigned long t = conversionTime;
+	interrupts();
+	return t/1000.0;
 }
 
 //for testing and debugging:
@@ -441,7 +536,10 @@ float HX711_ADC::getConversionTime()
 //The HX711 can be set to 10SPS or 80SPS. For general use the recommended setting is 10SPS.
 float HX711_ADC::getSPS()
 {
-	float sps = 1000000.0/conversionTime;
+	noInterrupts(); // updated by the dout interrupt in interrupt mode
+	unsigned long t = conversionTime;
+	interrupts();
+	float sps = 1000000.0/t;
 	return sps;
 }
 
@@ -512,6 +610,13 @@ bool HX711_ADC::refreshDataSet()
 {
 	int s = getSamplesInUse() + IGN_HIGH_SAMPLE + IGN_LOW_SAMPLE; // get number of samples in dataset
 	resetSamplesIndex();
+	if (interruptMode) {
+		while ( s > 0 ) {
+			s -= processQueue();
+			yield();
+		}
+		return true;
+	}
 	while ( s > 0 ) {
 		update();
 		yield();
@@ -556,3 +661,90 @@ bool HX711_ADC::getSignalTimeoutFlag()
 void HX711_ADC::setReverseOutput() {
 	reverseVal = true;
 }
+
+//interrupt mode: attach a falling edge interrupt on the dout pin.
+//Each conversion is then read out in the interrupt routine as soon as it is ready and put in a queue (size RAW_QUEUE_SIZE in config.h),
+//update(), dataWaitingAsync()/updateAsync() and refreshDataSet() take all queued conversions into the dataset, so no conversion is lost while loop() is busy.
+//The dout pin must be external interrupt capable. Returns 'false' if it is not, or if INTERRUPT_INSTANCES objects are already in interrupt mode.
+bool HX711_ADC::beginInterrupt()
+{
+	if (interruptMode) return true;
+#ifdef digitalPinToInterrupt
+	int irq = digitalPinToInterrupt(doutPin);
+#else
+	int irq = -1;
+#endif
+	if (irq < 0) return false;
+
+	uint8_t slot = 0;
+	while (slot < INTERRUPT_INSTANCES && isrInstance[slot]) slot++;
+	if (slot == INTERRUPT_INSTANCES) return false;
+
+	void (*isr)() = isrSlot<0>;
+	#if INTERRUPT_INSTANCES > 1
+	if (slot == 1) isr = isrSlot<1>;
+	#endif
+	#if INTERRUPT_INSTANCES > 2
+	if (slot == 2) isr = isrSlot<2>;
+	#endif
+	#if INTERRUPT_INSTANCES > 3
+	if (slot == 3) isr = isrSlot<3>;
+	#endif
+
+	queueHead = 0;
+	queueTail = 0;
+	dataWaiting = false;
+	isrIndex = slot;
+	isrInstance[slot] = this;
+	interruptMode = 1;
+	lastDoutLowTime = millis();
+	attachInterrupt(irq, isr, FALLING);
+
+	//if a conversion is already waiting dout is low and there will be no falling edge
+	noInterrupts();
+	dataReadyISR();
+	interrupts();
+	return true;
+}
+
+//detach the dout interrupt and return to polling the dout pin, queued conversions are added to the dataset
+void HX711_ADC::endInterrupt()
+{
+	if (!interruptMode) return;
+#ifdef digitalPinToInterrupt
+	detachInterrupt(digitalPinToInterrupt(doutPin));
+#endif
+	isrInstance[isrIndex] = NULL;
+	processQueue();
+	interruptMode = 0;
+}
+
+//returns 'true' while conversions are read out by the dout interrupt
+bool HX711_ADC::getInterruptMode()
+{
+	return interruptMode;
+}
+
+//returns the number of conversions waiting in the queue (interrupt mode)
+uint8_t HX711_ADC::getQueueCount()
+{
+	return (queueHead - queueTail) & (RAW_QUEUE_SIZE - 1);
+}
+
+//returns the number of conversions dropped because the queue was full (interrupt mode)
+//if this increases, call update() more often or increase RAW_QUEUE_SIZE in config.h
+unsigned long HX711_ADC::getOverrunCount()
+{
+	noInterrupts();
+	unsigned long n = overrunCount;
+	interrupts();
+	return n;
+}
+
+//reset the overrun counter
+void HX711_ADC::resetOverrunCount()
+{
+	noInterrupts();
+	overrunCount = 0;
+	interrupts();
+}
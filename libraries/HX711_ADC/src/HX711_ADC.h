@@ -44,6 +44,20 @@ Note: HX711_ADC configuration values has been moved to file config.h
 #define 	DIVB 7
 #endif
 
+#if (RAW_QUEUE_SIZE != 2) & (RAW_QUEUE_SIZE != 4) & (RAW_QUEUE_SIZE != 8) & (RAW_QUEUE_SIZE != 16) & (RAW_QUEUE_SIZE != 32) & (RAW_QUEUE_SIZE != 64)
+	#error "RAW_QUEUE_SIZE not valid!"
+#endif
+
+#if (INTERRUPT_INSTANCES < 1) | (INTERRUPT_INSTANCES > 4)
+	#error "number of INTERRUPT_INSTANCES not valid!"
+#endif
+
+#if defined(ESP8266) || defined(ESP32)
+#define HX711_ADC_ISR_ATTR IRAM_ATTR	// interrupt handlers must be in IRAM
+#else
+#define HX711_ADC_ISR_ATTR
+#endif
+
 #define SIGNAL_TIMEOUT	100
 
 class HX711_ADC
@@ -86,9 +100,22 @@ class HX711_ADC
 		float getNewCalibration(float known_mass);	//returns and sets a new calibration value (calFactor) based on a known mass input
 		bool getSignalTimeoutFlag();				//returns 'true' if it takes longer time then 'SIGNAL_TIMEOUT' for the dout pin to go low after a new conversion is started
 		void setReverseOutput();					//reverse the output value
+		bool beginInterrupt();						//read out conversions from a falling edge interrupt on the dout pin and queue them for update(), returns 'false' if the pin has no interrupt or all INTERRUPT_INSTANCES are in use
+		void endInterrupt();						//detach the dout interrupt and return to polling the dout pin
+		bool getInterruptMode();					//returns 'true' while conversions are read out by the dout interrupt
+		uint8_t getQueueCount();					//returns the number of conversions waiting in the queue (interrupt mode)
+		unsigned long getOverrunCount();			//returns the number of conversions dropped because the queue was full (interrupt mode)
+		void resetOverrunCount();					//reset the overrun counter
+		static long decodeRaw(unsigned long raw, bool reverse);	//convert the 24 bit HX711 output (two's complement) to a dataset value 0x000000...0xFFFFFF
 
 	protected:
 		void conversion24bit(); 					//if conversion is ready: returns 24 bit data and starts the next conversion
+		unsigned long readRaw(bool isr);			//clock out the 24 bit data + gain pulses, starts the next conversion
+		void addSample(unsigned long raw);			//decode a raw conversion and add it to the dataset
+		uint8_t processQueue();						//add all queued conversions to the dataset (interrupt mode)
+		void dataReadyISR();						//dout interrupt: read out the conversion and queue it
+		template <uint8_t slot> static void HX711_ADC_ISR_ATTR isrSlot();
+		static HX711_ADC * volatile isrInstance[INTERRUPT_INSTANCES];
 		long smoothedData();						//returns the smoothed data value calculated from the dataset
 		uint8_t sckPin; 							//HX711 pd_sck pin
 		uint8_t doutPin; 							//HX711 dout pin
@@ -120,6 +147,12 @@ class HX711_ADC
 		bool signalTimeoutFlag = 0;
 		bool reverseVal = 0;
 		bool dataWaiting = 0;
+		bool interruptMode = 0;
+		uint8_t isrIndex = 0;
+		volatile unsigned long rawQueue[RAW_QUEUE_SIZE];	// single producer (dout interrupt), single consumer (update)
+		volatile uint8_t queueHead = 0;				// written by the interrupt only
+		volatile uint8_t queueTail = 0;				// written by update() only
+		volatile unsigned long overrunCount = 0;
 };	
 
 #endif
@@ -42,4 +42,11 @@ Note that you can also overide (reducing) the number of samples in use at any ti
 //if required you can change the value to '1' to disable interrupts when writing to the sck pin.
 #define SCK_DISABLE_INTERRUPTS		0		//default value: 0
 
+//size of the queue the dout interrupt fills in interrupt mode (see beginInterrupt()), value must be 2, 4, 8, 16, 32 or 64.
+//The queue holds RAW_QUEUE_SIZE - 1 conversions, with the default value update() can be blocked for ~85ms at 80SPS or ~700ms at 10SPS without losing conversions.
+#define RAW_QUEUE_SIZE				8		//default value: 8
+
+//number of HX711_ADC objects that can run in interrupt mode at the same time, value must be 1, 2, 3 or 4.
+#define INTERRUPT_INSTANCES			2		//default value: 2
+
 #endif
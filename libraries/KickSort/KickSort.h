@@ -2,12 +2,15 @@
  FILENAME:      KickSort.h
  AUTHOR:        Orlando S. Hoilett
  EMAIL:     	orlandohoilett@gmail.com
- VERSION:		1.1.0
+ VERSION:		1.3.0
  
  
  DESCRIPTION
  A library for different sorting algorithms including quicksort, bubble sort,
- insertion sort, shell sort, and comb sort.
+ insertion sort, shell sort, comb sort, introsort and radix sort.
+ 
+ KickMedianFilter keeps the median (or any percentile) of the last samples of
+ a sensor up to date in O(log n) per sample.
  
  The class is templated allowing for ease of use across different data types.
  This is a static class. Function calls must be preceded with the class name and
@@ -26,6 +29,10 @@
  Version 1.1.0
  2020/08/26:2335> (UTC-5)
  			- Updated comments.
+ Version 1.2.0
+ 			- Added KickMedianFilter, a sliding window median/percentile filter.
+ Version 1.3.0
+ 			- Added introSort and radixSort.
  
  
  DISCLAIMER
@@ -72,6 +79,45 @@ enum class KickSort_Dir
 };
 
 
+//KickSort_Radix<Type>
+//Maps an integral Type to an unsigned Key with the same ordering, for
+//radixSort(). Only integral types have one, so radixSort() on anything else
+//fails to compile. Other types can be sorted by radix by specializing it.
+template<typename Type> struct KickSort_Radix;
+
+#define KICKSORT_RADIX_UNSIGNED(T) \
+	template<> struct KickSort_Radix<T> \
+	{ \
+		typedef T Key; \
+		static Key key(T value) { return value; } \
+	};
+
+//flipping the sign bit puts negative values below positive ones
+#define KICKSORT_RADIX_SIGNED(T, U) \
+	template<> struct KickSort_Radix<T> \
+	{ \
+		typedef U Key; \
+		static Key key(T value) { return (U)value ^ ((U)1 << (8 * sizeof(U) - 1)); } \
+	};
+
+KICKSORT_RADIX_UNSIGNED(unsigned char)
+KICKSORT_RADIX_UNSIGNED(unsigned short)
+KICKSORT_RADIX_UNSIGNED(unsigned int)
+KICKSORT_RADIX_UNSIGNED(unsigned long)
+KICKSORT_RADIX_UNSIGNED(unsigned long long)
+KICKSORT_RADIX_SIGNED(signed char, unsigned char)
+KICKSORT_RADIX_SIGNED(short, unsigned short)
+KICKSORT_RADIX_SIGNED(int, unsigned int)
+KICKSORT_RADIX_SIGNED(long, unsigned long)
+KICKSORT_RADIX_SIGNED(long long, unsigned long long)
+
+template<> struct KickSort_Radix<char>
+{
+	typedef unsigned char Key;
+	static Key key(char value) { return (char)-1 < 0 ? (Key)value ^ 0x80 : (Key)value; }
+};
+
+
 template<typename Type>
 
 class KickSort
@@ -98,6 +144,21 @@ public:
 	//From: https://forum.arduino.cc/index.php?topic=280486.0
 	static void shellSort(Type input[], const uint16_t samples);
 	static void shellSort(Type input[], const uint16_t samples, KickSort_Dir d);
+	
+	static void introSort(Type input[], const uint16_t samples);
+	static void introSort(Type input[], const uint16_t samples, KickSort_Dir d);
+	
+	static void radixSort(Type input[], const uint16_t samples, Type buffer[]);
+	static void radixSort(Type input[], const uint16_t samples, Type buffer[], KickSort_Dir d);
+	
+	
+private:
+	
+	template<bool Descending> static bool before(const Type &a, const Type &b);
+	template<bool Descending> static void introSortLoop(Type input[], uint16_t samples, uint8_t depth);
+	template<bool Descending> static void heapSort(Type input[], const uint16_t samples);
+	template<bool Descending> static void siftDown(Type input[], uint16_t root, const uint16_t samples);
+	template<bool Descending> static void insertionPass(Type input[], const uint16_t samples);
 
 };
 
@@ -494,4 +555,514 @@ void KickSort<Type>::shellSort(Type input[], const uint16_t samples, KickSort_Di
 
 
 
+//void KickSort<Type>::introSort(Type input[], const uint16_t samples)
+//input			input array to be sorted. array is passed by reference so, the
+//					original array is modified
+//samples		number of samples in the array
+//
+//This orders the array in ascending order. Introsort is a quicksort with a
+//median-of-three pivot that switches to heapsort when the recursion gets
+//deeper than 2 * log2(samples), so it never degrades to O(n^2) whatever the
+//input, and leaves partitions of 16 samples or less to a final insertion
+//sort pass. Recursion only goes into the smaller partition, so the stack
+//stays below log2(samples) frames.
+template<typename Type>
+void KickSort<Type>::introSort(Type input[], const uint16_t samples)
+{
+	introSort(input, samples, KickSort_Dir::ASCENDING);
+}
+
+
+//void KickSort<Type>::introSort(Type input[], const uint16_t samples, KickSort_Dir d)
+//input			input array to be sorted. array is passed by reference so, the
+//					original array is modified
+//samples		number of samples in the array
+//d				KickSort_Dir::ASCENDING or KickSort_Dir::DESCENDING
+//
+//This orders the array in ascending or descending order based on the
+//KickSort_Dir parameter. See introSort(Type input[], const uint16_t samples).
+template<typename Type>
+void KickSort<Type>::introSort(Type input[], const uint16_t samples, KickSort_Dir d)
+{
+	if (samples < 2) return;
+	
+	uint8_t depth = 0;
+	for (uint16_t n = samples; n > 1; n >>= 1) depth += 2;
+	
+	if (d == KickSort_Dir::ASCENDING)
+	{
+		introSortLoop<false>(input, samples, depth);
+		insertionPass<false>(input, samples);
+	}
+	else
+	{
+		introSortLoop<true>(input, samples, depth);
+		insertionPass<true>(input, samples);
+	}
+}
+
+
+//void KickSort<Type>::radixSort(Type input[], const uint16_t samples, Type buffer[])
+//input			input array to be sorted. array is passed by reference so, the
+//					original array is modified
+//samples		number of samples in the array
+//buffer		scratch array of at least samples elements
+//
+//This orders the array in ascending order. LSD radix sort, one byte of the
+//value per pass, for integral types only (see KickSort_Radix). It makes no
+//comparisons and takes the same time for any input; passes where every
+//value has the same byte are skipped. Needs the scratch buffer and 512 bytes
+//of stack for the byte counts.
+template<typename Type>
+void KickSort<Type>::radixSort(Type input[], const uint16_t samples, Type buffer[])
+{
+	radixSort(input, samples, buffer, KickSort_Dir::ASCENDING);
+}
+
+
+//void KickSort<Type>::radixSort(Type input[], const uint16_t samples, Type buffer[], KickSort_Dir d)
+//input			input array to be sorted. array is passed by reference so, the
+//					original array is modified
+//samples		number of samples in the array
+//buffer		scratch array of at least samples elements
+//d				KickSort_Dir::ASCENDING or KickSort_Dir::DESCENDING
+//
+//This orders the array in ascending or descending order based on the
+//KickSort_Dir parameter. The sort is stable.
+template<typename Type>
+void KickSort<Type>::radixSort(Type input[], const uint16_t samples, Type buffer[], KickSort_Dir d)
+{
+	if (samples < 2) return;
+	
+	typedef typename KickSort_Radix<Type>::Key Key;
+	
+	uint16_t counts[256];
+	Type *from = input;
+	Type *to = buffer;
+	
+	for (uint8_t shift = 0; shift < 8 * sizeof(Key); shift += 8)
+	{
+		memset(counts, 0, sizeof(counts));
+		for (uint16_t i = 0; i < samples; i++)
+			counts[(uint8_t)(KickSort_Radix<Type>::key(from[i]) >> shift)]++;
+		
+		//all values share this byte, nothing to reorder
+		if (counts[(uint8_t)(KickSort_Radix<Type>::key(from[0]) >> shift)] == samples) continue;
+		
+		//turn the counts into start positions
+		uint16_t start = 0;
+		for (uint16_t b = 0; b < 256; b++)
+		{
+			uint8_t digit = (d == KickSort_Dir::ASCENDING) ? b : 255 - b;
+			uint16_t count = counts[digit];
+			counts[digit] = start;
+			start += count;
+		}
+		
+		for (uint16_t i = 0; i < samples; i++)
+			to[counts[(uint8_t)(KickSort_Radix<Type>::key(from[i]) >> shift)]++] = from[i];
+		
+		Type *t = from;
+		from = to;
+		to = t;
+	}
+	
+	if (from != input)
+	{
+		for (uint16_t i = 0; i < samples; i++) input[i] = from[i];
+	}
+}
+
+
+template<typename Type>
+template<bool Descending>
+bool KickSort<Type>::before(const Type &a, const Type &b)
+{
+	return Descending ? (b < a) : (a < b);
+}
+
+
+template<typename Type>
+template<bool Descending>
+void KickSort<Type>::introSortLoop(Type input[], uint16_t samples, uint8_t depth)
+{
+	while (samples > 16)
+	{
+		if (depth == 0)
+		{
+			heapSort<Descending>(input, samples);
+			return;
+		}
+		depth--;
+		
+		//median of first, middle and last as the pivot
+		Type a = input[0];
+		Type b = input[samples / 2];
+		Type c = input[samples - 1];
+		Type p;
+		if (before<Descending>(a, b))
+			p = before<Descending>(b, c) ? b : (before<Descending>(a, c) ? c : a);
+		else
+			p = before<Descending>(a, c) ? a : (before<Descending>(b, c) ? c : b);
+		
+		//same partition as quickSort(), values equal to the pivot are
+		//spread over both sides
+		Type *l = input; //left index
+		Type *r = input + samples - 1; //right index
+		
+		while (l <= r)
+		{
+			if (before<Descending>(*l, p)) l++;
+			else if (before<Descending>(p, *r)) r--;
+			else
+			{
+				Type t = *l;
+				*l = *r;
+				*r = t;
+				l++;
+				r--;
+			}
+		}
+		
+		uint16_t left = r - input + 1;
+		uint16_t right = input + samples - l;
+		
+		//recurse into the smaller side, loop on the larger one
+		if (left < right)
+		{
+			introSortLoop<Descending>(input, left, depth);
+			input = l;
+			samples = right;
+		}
+		else
+		{
+			introSortLoop<Descending>(l, right, depth);
+			samples = left;
+		}
+	}
+}
+
+
+template<typename Type>
+template<bool Descending>
+void KickSort<Type>::heapSort(Type input[], const uint16_t samples)
+{
+	if (samples < 2) return;
+	
+	for (uint16_t i = samples / 2; i > 0; i--)
+		siftDown<Descending>(input, i - 1, samples);
+	
+	for (uint16_t end = samples - 1; end > 0; end--)
+	{
+		Type t = input[0];
+		input[0] = input[end];
+		input[end] = t;
+		siftDown<Descending>(input, 0, end);
+	}
+}
+
+
+template<typename Type>
+template<bool Descending>
+void KickSort<Type>::siftDown(Type input[], uint16_t root, const uint16_t samples)
+{
+	Type value = input[root];
+	
+	while (true)
+	{
+		uint32_t child = 2 * (uint32_t)root + 1;
+		if (child >= samples) break;
+		if (child + 1 < samples && before<Descending>(input[child], input[child + 1])) child++;
+		if (!before<Descending>(value, input[child])) break;
+		input[root] = input[child];
+		root = child;
+	}
+	input[root] = value;
+}
+
+
+//Insertion sort that shifts instead of swapping. Only used on arrays where
+//every sample is at most 16 places from where it belongs.
+template<typename Type>
+template<bool Descending>
+void KickSort<Type>::insertionPass(Type input[], const uint16_t samples)
+{
+	for (uint16_t t = 1; t < samples; t++)
+	{
+		Type value = input[t];
+		uint16_t z = t;
+		while (z > 0 && before<Descending>(value, input[z - 1]))
+		{
+			input[z] = input[z - 1];
+			z--;
+		}
+		input[z] = value;
+	}
+}
+
+
+//KickMedianFilter<Type, Window>
+//A sliding window median or percentile filter. Every push() replaces the
+//oldest of the last Window samples and the selected percentile of the window
+//is available right away, without copying and sorting the window.
+//
+//The window is split in two heaps of buffer indices: a max-heap holding the
+//samples at or below the selected rank and a min-heap holding the rest, so
+//the result is always on top of the first heap. Replacing a sample only
+//sifts it within its heap and at most swaps the two tops, which takes
+//O(log Window) comparisons. Both heaps share one index array; the second
+//one grows down from the end.
+//
+//Window can be 1 to 255. Memory use is Window samples plus 2 * Window bytes.
+template<typename Type, uint8_t Window>
+
+class KickMedianFilter
+{
+
+public:
+	
+	KickMedianFilter(uint8_t percentile = 50, KickSort_Dir d = KickSort_Dir::ASCENDING);
+	
+	Type filter(Type sample);
+	void push(Type sample);
+	Type get() const;
+	uint8_t getCount() const;
+	void clear();
+	
+	
+private:
+	
+	Type _data[Window];
+	uint8_t _heap[Window];
+	uint8_t _pos[Window];
+	uint8_t _percentile;
+	uint8_t _head;
+	uint8_t _count;
+	uint8_t _low;
+	uint8_t _high;
+	
+	uint8_t rank() const;
+	uint8_t index(bool low, uint8_t j) const;
+	bool above(bool low, uint8_t a, uint8_t b) const;
+	void place(bool low, uint8_t j, uint8_t slot);
+	void siftUp(bool low, uint8_t j);
+	void siftDown(bool low, uint8_t j);
+	void insert(bool low, uint8_t slot);
+	uint8_t pop(bool low);
+
+};
+
+
+//KickMedianFilter<Type, Window>::KickMedianFilter(uint8_t percentile, KickSort_Dir d)
+//percentile	0 to 100, which sample of the sorted window to return. 50 is
+//					the median
+//d				KickSort_Dir::ASCENDING counts the percentile from the smallest
+//					sample, KickSort_Dir::DESCENDING from the largest
+template<typename Type, uint8_t Window>
+KickMedianFilter<Type, Window>::KickMedianFilter(uint8_t percentile, KickSort_Dir d)
+{
+	if (percentile > 100) percentile = 100;
+	_percentile = (d == KickSort_Dir::ASCENDING) ? percentile : 100 - percentile;
+	clear();
+}
+
+
+//void KickMedianFilter<Type, Window>::clear()
+//
+//Empties the window.
+template<typename Type, uint8_t Window>
+void KickMedianFilter<Type, Window>::clear()
+{
+	_head = 0;
+	_count = 0;
+	_low = 0;
+	_high = 0;
+}
+
+
+//Type KickMedianFilter<Type, Window>::filter(Type sample)
+//sample		new sample
+//
+//Adds the sample to the window and returns the selected percentile.
+template<typename Type, uint8_t Window>
+Type KickMedianFilter<Type, Window>::filter(Type sample)
+{
+	push(sample);
+	return get();
+}
+
+
+//Type KickMedianFilter<Type, Window>::get()
+//
+//Returns the selected percentile of the samples in the window, the same
+//value as input[rank] after sorting them, or 0 if the window is empty.
+template<typename Type, uint8_t Window>
+Type KickMedianFilter<Type, Window>::get() const
+{
+	if (_low == 0) return 0;
+	return _data[_heap[0]];
+}
+
+
+//uint8_t KickMedianFilter<Type, Window>::getCount()
+//
+//Returns the number of samples in the window.
+template<typename Type, uint8_t Window>
+uint8_t KickMedianFilter<Type, Window>::getCount() const
+{
+	return _count;
+}
+
+
+//void KickMedianFilter<Type, Window>::push(Type sample)
+//sample		new sample
+//
+//Adds the sample to the window, replacing the oldest one once the window is
+//full.
+template<typename Type, uint8_t Window>
+void KickMedianFilter<Type, Window>::push(Type sample)
+{
+	uint8_t slot = _head;
+	_head = (_head + 1 < Window) ? _head + 1 : 0;
+	
+	if (_count == Window)
+	{
+		//replace the oldest sample and restore its heap
+		_data[slot] = sample;
+		bool low = _pos[slot] < _low;
+		uint8_t j = low ? _pos[slot] : Window - 1 - _pos[slot];
+		siftUp(low, j);
+		siftDown(low, low ? _pos[slot] : Window - 1 - _pos[slot]);
+	}
+	else
+	{
+		_data[slot] = sample;
+		_count++;
+		
+		bool low = (_low == 0) || !(sample > _data[_heap[0]]);
+		insert(low, slot);
+		
+		//the rank moves up as the window fills
+		while (_low > rank() + 1) insert(false, pop(true));
+		while (_low < rank() + 1) insert(true, pop(false));
+	}
+	
+	//only the two tops can be out of order
+	if (_low > 0 && _high > 0 && _data[_heap[0]] > _data[_heap[Window - 1]])
+	{
+		uint8_t a = _heap[0];
+		uint8_t b = _heap[Window - 1];
+		place(true, 0, b);
+		place(false, 0, a);
+		siftDown(true, 0);
+		siftDown(false, 0);
+	}
+}
+
+
+//Index in the sorted window of the selected percentile, rounded to nearest.
+//For the median this is samples / 2, as in input[samples / 2].
+template<typename Type, uint8_t Window>
+uint8_t KickMedianFilter<Type, Window>::rank() const
+{
+	return ((uint16_t)(_count - 1) * _percentile + 50) / 100;
+}
+
+
+//Position in _heap of element j of the low (max) or high (min) heap.
+template<typename Type, uint8_t Window>
+uint8_t KickMedianFilter<Type, Window>::index(bool low, uint8_t j) const
+{
+	return low ? j : Window - 1 - j;
+}
+
+
+//True if sample slot a belongs above sample slot b in the given heap.
+template<typename Type, uint8_t Window>
+bool KickMedianFilter<Type, Window>::above(bool low, uint8_t a, uint8_t b) const
+{
+	return low ? (_data[a] > _data[b]) : (_data[a] < _data[b]);
+}
+
+
+template<typename Type, uint8_t Window>
+void KickMedianFilter<Type, Window>::place(bool low, uint8_t j, uint8_t slot)
+{
+	uint8_t i = index(low, j);
+	_heap[i] = slot;
+	_pos[slot] = i;
+}
+
+
+template<typename Type, uint8_t Window>
+void KickMedianFilter<Type, Window>::siftUp(bool low, uint8_t j)
+{
+	uint8_t slot = _heap[index(low, j)];
+	
+	while (j > 0)
+	{
+		uint8_t parent = (j - 1) / 2;
+		uint8_t p = _heap[index(low, parent)];
+		if (!above(low, slot, p)) break;
+		place(low, j, p);
+		j = parent;
+	}
+	place(low, j, slot);
+}
+
+
+template<typename Type, uint8_t Window>
+void KickMedianFilter<Type, Window>::siftDown(bool low, uint8_t j)
+{
+	uint8_t n = low ? _low : _high;
+	uint8_t slot = _heap[index(low, j)];
+	
+	while (true)
+	{
+		uint16_t child = 2 * (uint16_t)j + 1;
+		if (child >= n) break;
+		uint8_t c = _heap[index(low, child)];
+		if (child + 1 < n)
+		{
+			uint8_t c2 = _heap[index(low, child + 1)];
+			if (above(low, c2, c))
+			{
+				child++;
+				c = c2;
+			}
+		}
+		if (!above(low, c, slot)) break;
+		place(low, j, c);
+		j = child;
+	}
+	place(low, j, slot);
+}
+
+
+template<typename Type, uint8_t Window>
+void KickMedianFilter<Type, Window>::insert(bool low, uint8_t slot)
+{
+	uint8_t j = low ? _low++ : _high++;
+	place(low, j, slot);
+	siftUp(low, j);
+}
+
+
+template<typename Type, uint8_t Window>
+uint8_t KickMedianFilter<Type, Window>::pop(bool low)
+{
+	uint8_t top = _heap[index(low, 0)];
+	uint8_t last = low ? --_low : --_high;
+	
+	if (last > 0)
+	{
+		place(low, 0, _heap[index(low, last)]);
+		siftDown(low, 0);
+	}
+	return top;
+}
+
+
+
+
 #endif /* KickSort_h */
@@ -0,0 +1,93 @@
+/*
+ * FILENAME: EXAMPLE06_MedianFilter.ino
+ * AUTHOR:   Orlando S. Hoilett
+ * CONTACT:  orlandohoilett@gmail.com
+ * VERSION:  1.2.0
+ * 
+ * 
+ * AFFILIATIONS
+ * Linnes Lab, Weldon School of Biomedical Engineering,
+ * Purdue University, West Lafayette, IN 47907
+ * 
+ * 
+ * DESCRIPTION
+ * Sliding window median of a noisy analog input with KickMedianFilter,
+ * next to the 90th percentile of the same readings.
+ * 
+ * This library is built from aggregating and modifying different sorting
+ * implementations from various other GitHub users including: robtillaart
+ * (especially), emilv, luisllamasbinaburo, and dndubins. Thanks!
+ * 
+ * 
+ * UPDATES
+ * Version 1.0.0
+ * 2020/08/22:2000> (UTC-5)
+ *            - Initiated.
+ * Version 1.1.0
+ * 2020/08/26:2335> (UTC-5)
+ *            - Updated comments.
+ * Version 1.2.0
+ *            - Added KickMedianFilter example.
+ * 
+ * 
+ * DISCLAIMER
+ * Linnes Lab code, firmware, and software is released under the
+ * MIT License (http://opensource.org/licenses/MIT).
+ * 
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2020 Linnes Lab, Purdue University
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+
+#include "KickSort.h"
+
+#if defined(ARDUINO_ARCH_SAMD)
+  #define SerialDebugger SerialUSB
+#else
+  #define SerialDebugger Serial
+#endif
+
+
+//median and 90th percentile of the last 15 readings
+KickMedianFilter<uint16_t, 15> median;
+KickMedianFilter<uint16_t, 15> upper(90);
+
+
+void setup()
+{
+  SerialDebugger.begin(9600);
+  while(!SerialDebugger); //holds the program until Serial Monitor is opened
+}
+
+void loop()
+{
+  uint16_t reading = analogRead(A0);
+  
+  SerialDebugger.print(reading);
+  SerialDebugger.print(" median: ");
+  SerialDebugger.print(median.filter(reading));
+  SerialDebugger.print(" 90%: ");
+  SerialDebugger.println(upper.filter(reading));
+  
+  delay(100);
+}
@@ -0,0 +1,10 @@
+// Minimal Arduino stand-in for running KickSort.h on a desktop machine.
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#endif
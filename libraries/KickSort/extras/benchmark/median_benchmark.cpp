@@ -0,0 +1,98 @@
+// Host benchmark of KickMedianFilter against copying the window and
+// re-sorting it with each KickSort algorithm for every new sample, on
+// windows of 5 to 255 samples. Build and run with ./run.sh.
+//
+// The input is a slowly rising 10 bit ADC reading with noise and the odd
+// spike, like a level or load cell sensor. The time per sample is printed
+// in microseconds, and every method is checked to return the same medians.
+
+#include <chrono>
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "../../KickSort.h"
+
+#define SAMPLES 20000
+
+typedef void (*SortFunction)(int16_t input[], const uint16_t samples);
+
+static int16_t input[SAMPLES];
+static int16_t reference[SAMPLES];
+
+static void fillInput()
+{
+	srand(1);
+	for (int k = 0; k < SAMPLES; k++)
+	{
+		input[k] = 300 + k / 100 + rand() % 9 - 4;
+		if (rand() % 50 == 0)
+			input[k] = rand() % 1024;
+	}
+}
+
+template <uint8_t WINDOW> static double timeFilter()
+{
+	static KickMedianFilter<int16_t, WINDOW> filter;
+	filter.clear();
+
+	auto start = std::chrono::steady_clock::now();
+	for (int k = 0; k < SAMPLES; k++)
+		reference[k] = filter.filter(input[k]);
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / SAMPLES;
+}
+
+template <uint8_t WINDOW> static double timeSort(SortFunction sort, int samples, bool &match)
+{
+	int16_t window[WINDOW];
+	int16_t copy[WINDOW];
+	uint8_t count = 0, head = 0;
+
+	match = true;
+	auto start = std::chrono::steady_clock::now();
+	for (int k = 0; k < samples; k++)
+	{
+		window[head] = input[k];
+		head = (head + 1) % WINDOW;
+		if (count < WINDOW) count++;
+
+		memcpy(copy, window, count * sizeof(int16_t));
+		sort(copy, count);
+		if (copy[count / 2] != reference[k]) match = false;
+	}
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / samples;
+}
+
+template <uint8_t WINDOW> static void run()
+{
+	static const struct { const char *name; SortFunction sort; } sorts[] = {
+		{ "quickSort", KickSort<int16_t>::quickSort },
+		{ "insertionSort", KickSort<int16_t>::insertionSort },
+		{ "shellSort", KickSort<int16_t>::shellSort },
+		{ "combSort", KickSort<int16_t>::combSort },
+		{ "bubbleSort", KickSort<int16_t>::bubbleSort },
+	};
+
+	printf("window %3u  KickMedianFilter %6.3f us", WINDOW, timeFilter<WINDOW>());
+	for (const auto &s : sorts)
+	{
+		bool match;
+		// The quadratic sorts are slow on big windows, fewer samples will do.
+		double us = timeSort<WINDOW>(s.sort, WINDOW > 64 ? SAMPLES / 10 : SAMPLES, match);
+		printf("  %s %8.3f us%s", s.name, us, match ? "" : " (MISMATCH)");
+	}
+	printf("\n");
+}
+
+int main()
+{
+	fillInput();
+
+	run<5>();
+	run<15>();
+	run<31>();
+	run<63>();
+	run<127>();
+	run<255>();
+
+	return 0;
+}
@@ -0,0 +1,10 @@
+#!/bin/sh
+# Builds the KickSort benchmarks and runs them.
+set -e
+cd "$(dirname "$0")"
+g++ -O2 -I. -o median_benchmark median_benchmark.cpp
+g++ -O2 -I. -o sort_benchmark sort_benchmark.cpp
+./median_benchmark
+echo
+./sort_benchmark
+rm -f median_benchmark sort_benchmark
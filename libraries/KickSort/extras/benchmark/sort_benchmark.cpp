@@ -0,0 +1,165 @@
+// Host benchmark of the KickSort algorithms on sorted, reversed, constant
+// and random inputs of 64 to 4096 samples. Build and run with ./run.sh.
+//
+// Comparisons and swaps are counted by sorting a wrapper type whose
+// operators count themselves. Swaps are element moves divided by three, so
+// a shifting insertion sort gets credit for moving a value in one step.
+// Times are measured separately on plain int16_t arrays, the best of
+// several runs, and every result is checked against std::sort.
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "../../KickSort.h"
+
+#define MAX_SAMPLES 4096
+
+static unsigned long comparisons;
+static unsigned long moves;
+
+struct Counted
+{
+	int16_t value;
+
+	Counted(int value = 0) : value(value) {}
+	Counted(const Counted &other) : value(other.value) { moves++; }
+	Counted &operator=(const Counted &other) { value = other.value; moves++; return *this; }
+
+	bool operator<(const Counted &other) const { comparisons++; return value < other.value; }
+	bool operator>(const Counted &other) const { comparisons++; return value > other.value; }
+};
+
+template<> struct KickSort_Radix<Counted>
+{
+	typedef uint16_t Key;
+	static Key key(const Counted &c) { return KickSort_Radix<int16_t>::key(c.value); }
+};
+
+enum Pattern { SORTED, REVERSED, CONSTANT, RANDOM, PATTERNS };
+static const char *patternNames[PATTERNS] = { "sorted", "reversed", "constant", "random" };
+
+static void fill(int16_t data[], uint16_t samples, Pattern pattern)
+{
+	srand(samples);
+	for (uint16_t k = 0; k < samples; k++)
+	{
+		switch (pattern)
+		{
+			case SORTED:   data[k] = k - samples / 2; break;
+			case REVERSED: data[k] = samples / 2 - k; break;
+			case CONSTANT: data[k] = 512; break;
+			default:       data[k] = rand() % 2048 - 1024; break;
+		}
+	}
+}
+
+static int16_t buffer16[MAX_SAMPLES];
+static Counted bufferCounted[MAX_SAMPLES];
+
+template<typename Type> struct Algorithms
+{
+	static void quick(Type a[], uint16_t n) { KickSort<Type>::quickSort(a, n); }
+	static void intro(Type a[], uint16_t n) { KickSort<Type>::introSort(a, n); }
+	static void insertion(Type a[], uint16_t n) { KickSort<Type>::insertionSort(a, n); }
+	static void shell(Type a[], uint16_t n) { KickSort<Type>::shellSort(a, n); }
+	static void comb(Type a[], uint16_t n) { KickSort<Type>::combSort(a, n); }
+	static void bubble(Type a[], uint16_t n) { KickSort<Type>::bubbleSort(a, n); }
+	static void radix(Type a[], uint16_t n);
+};
+
+template<> void Algorithms<int16_t>::radix(int16_t a[], uint16_t n) { KickSort<int16_t>::radixSort(a, n, buffer16); }
+template<> void Algorithms<Counted>::radix(Counted a[], uint16_t n) { KickSort<Counted>::radixSort(a, n, bufferCounted); }
+
+struct Algorithm
+{
+	const char *name;
+	void (*sort16)(int16_t[], uint16_t);
+	void (*sortCounted)(Counted[], uint16_t);
+};
+
+#define ALGORITHM(name) { #name, Algorithms<int16_t>::name, Algorithms<Counted>::name }
+
+static const Algorithm algorithms[] =
+{
+	ALGORITHM(intro),
+	ALGORITHM(radix),
+	ALGORITHM(quick),
+	ALGORITHM(shell),
+	ALGORITHM(comb),
+	ALGORITHM(insertion),
+	ALGORITHM(bubble),
+};
+
+static int16_t original[MAX_SAMPLES];
+static int16_t expected[MAX_SAMPLES];
+static int16_t data16[MAX_SAMPLES];
+static Counted dataCounted[MAX_SAMPLES];
+
+static bool run(const Algorithm &algorithm, uint16_t samples, Pattern pattern)
+{
+	for (uint16_t k = 0; k < samples; k++) dataCounted[k].value = original[k];
+	comparisons = moves = 0;
+	algorithm.sortCounted(dataCounted, samples);
+	unsigned long c = comparisons, m = moves;
+
+	bool ok = true;
+	for (uint16_t k = 0; k < samples; k++)
+		ok &= dataCounted[k].value == expected[k];
+
+	double best = 1e30;
+	int runs = samples <= 512 ? 20 : 5;
+	for (int r = 0; r < runs; r++)
+	{
+		std::copy(original, original + samples, data16);
+		auto start = std::chrono::steady_clock::now();
+		algorithm.sort16(data16, samples);
+		double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+		if (us < best) best = us;
+	}
+	ok &= std::equal(data16, data16 + samples, expected);
+
+	printf("%5u  %-8s  %-9s  %10lu  %10lu  %10.1f%s\n", samples, patternNames[pattern], algorithm.name,
+		c, m / 3, best, ok ? "" : "  WRONG");
+	return ok;
+}
+
+int main()
+{
+	static const uint16_t sizes[] = { 64, 512, 4096 };
+	bool ok = true;
+
+	// the descending variants share the ascending code, check them once
+	for (uint16_t k = 0; k < 1000; k++) original[k] = rand() % 200 - 100;
+	std::copy(original, original + 1000, expected);
+	std::sort(expected, expected + 1000, [](int16_t a, int16_t b) { return a > b; });
+	std::copy(original, original + 1000, data16);
+	KickSort<int16_t>::introSort(data16, 1000, KickSort_Dir::DESCENDING);
+	ok &= std::equal(data16, data16 + 1000, expected);
+	std::copy(original, original + 1000, data16);
+	KickSort<int16_t>::radixSort(data16, 1000, buffer16, KickSort_Dir::DESCENDING);
+	ok &= std::equal(data16, data16 + 1000, expected);
+
+	printf("    n  input     algorithm  comparisons      swaps     time us\n");
+	for (uint16_t size : sizes)
+	{
+		for (int p = 0; p < PATTERNS; p++)
+		{
+			fill(original, size, (Pattern)p);
+			std::copy(original, original + size, expected);
+			std::sort(expected, expected + size);
+
+			for (const Algorithm &algorithm : algorithms)
+				ok &= run(algorithm, size, (Pattern)p);
+		}
+		printf("\n");
+	}
+
+	if (!ok)
+	{
+		printf("FAILED: a sort returned the wrong order\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,15 @@
+// Minimal Arduino stand-in for running the MAX30100 processing chain on a
+// desktop machine. millis() follows the sample clock of the replayed trace.
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+extern uint32_t fakeMillis;
+
+inline uint32_t millis() { return fakeMillis; }
+
+#endif
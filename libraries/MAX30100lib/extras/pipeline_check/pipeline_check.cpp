@@ -0,0 +1,339 @@
+// Replays IR/red traces through the float processing chain (DCRemover,
+// FilterBuLp1, BeatDetector, SpO2Calculator) and the fixed point chain that
+// PulseOximeter uses (the *Fixed classes), sample by sample, and compares the
+// results. The fixed chain is also run the way PulseOximeter::processSamples()
+// sees the FIFO, in blocks of MAX30100_FIFO_DEPTH samples with back-dated
+// timestamps, which must give the same beats and rates as sample by sample.
+//
+//     ./run.sh [trace files recorded with extras/recorder]
+//
+// Without arguments extras/recorder/test.out.sample is replayed, followed by
+// synthetic traces with a known heart rate. The program exits with an error
+// if the chains disagree by more than the tolerances below.
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "Arduino.h"
+#include "../../src/MAX30100_BeatDetector.h"
+#include "../../src/MAX30100_BeatDetectorFixed.h"
+#include "../../src/MAX30100_Filters.h"
+#include "../../src/MAX30100_SpO2Calculator.h"
+#include "../../src/MAX30100_SpO2CalculatorFixed.h"
+
+#define DC_REMOVER_ALPHA            0.95    // as in MAX30100_PulseOximeter.h
+#define SAMPLE_PERIOD_MS            10
+#define FIFO_DEPTH                  16      // MAX30100_FIFO_DEPTH
+#define READ_LATENCY_MS             3       // millis() is a bit later than the last sample
+
+#define MAX_BEAT_SHIFT_SAMPLES      1       // a beat may be found one sample apart
+#define MAX_SPO2_DIFFERENCE         1       // %
+#define MAX_BLOCK_RATE_DIFFERENCE   0.01    // relative, block-wise against sample by sample
+#define LONG_UPTIME_MS              44739000UL // 12.4 h, the first beat period wrapped to a pulse rate
+
+// A beat found one sample apart changes the beat period by one sample
+// period; the rate may differ by as much until the period filter settles.
+static float maxRateDifference(float rate)
+{
+    return 0.1 + rate * rate * SAMPLE_PERIOD_MS / 60000.0;
+}
+
+uint32_t fakeMillis;
+
+struct Sample
+{
+    uint16_t ir;
+    uint16_t red;
+};
+
+struct Result
+{
+    std::vector<uint32_t> beats;
+    std::vector<float> rates;
+    std::vector<uint8_t> spO2;
+};
+
+static void runFloat(const std::vector<Sample> &trace, Result &result)
+{
+    DCRemover irDCRemover(DC_REMOVER_ALPHA);
+    DCRemover redDCRemover(DC_REMOVER_ALPHA);
+    FilterBuLp1 lpf;
+    BeatDetector beatDetector;
+    SpO2Calculator spO2calculator;
+    bool detecting = false;
+
+    for (size_t i = 0; i < trace.size(); i++) {
+        fakeMillis = i * SAMPLE_PERIOD_MS;
+        float irACValue = irDCRemover.step(trace[i].ir);
+        float redACValue = redDCRemover.step(trace[i].red);
+        float filteredPulseValue = lpf.step(-irACValue);
+        bool beatDetected = beatDetector.addSample(filteredPulseValue);
+
+        if (beatDetector.getRate() > 0) {
+            detecting = true;
+            spO2calculator.update(irACValue, redACValue, beatDetected);
+        } else if (detecting) {
+            detecting = false;
+            spO2calculator.reset();
+        }
+
+        if (beatDetected) {
+            result.beats.push_back(i);
+        }
+        result.rates.push_back(beatDetector.getRate());
+        result.spO2.push_back(spO2calculator.getSpO2());
+    }
+}
+
+// blockSize 1: one sample per update(), millis() is the sample time.
+// Otherwise blockSize samples per update(), timed as in PulseOximeter::processSamples().
+static void runFixed(const std::vector<Sample> &trace, Result &result, size_t blockSize)
+{
+    DCRemoverFixed irDCRemover(DC_REMOVER_ALPHA);
+    DCRemoverFixed redDCRemover(DC_REMOVER_ALPHA);
+    FilterBuLp1Fixed lpf;
+    BeatDetectorFixed beatDetector;
+    SpO2CalculatorFixed spO2calculator;
+    bool detecting = false;
+    uint32_t tsLastSample = 0;
+
+    for (size_t start = 0; start < trace.size(); start += blockSize) {
+        size_t count = trace.size() - start < blockSize ? trace.size() - start : blockSize;
+        uint32_t tsFirst = 0;
+
+        if (blockSize > 1) {
+            fakeMillis = (start + count - 1) * SAMPLE_PERIOD_MS + READ_LATENCY_MS;
+            tsFirst = fakeMillis - (uint32_t)(count - 1) * SAMPLE_PERIOD_MS;
+            if (tsLastSample && (int32_t)(tsFirst - tsLastSample) < SAMPLE_PERIOD_MS) {
+                tsFirst = tsLastSample + SAMPLE_PERIOD_MS;
+            }
+            tsLastSample = tsFirst + (uint32_t)(count - 1) * SAMPLE_PERIOD_MS;
+        }
+
+        for (size_t i = start; i < start + count; i++) {
+            int32_t irACValue = irDCRemover.step(trace[i].ir);
+            int32_t redACValue = redDCRemover.step(trace[i].red);
+            int32_t filteredPulseValue = lpf.step(-irACValue);
+            bool beatDetected;
+
+            if (blockSize > 1) {
+                beatDetected = beatDetector.addSample(filteredPulseValue, tsFirst + (i - start) * SAMPLE_PERIOD_MS);
+            } else {
+                fakeMillis = i * SAMPLE_PERIOD_MS;
+                beatDetected = beatDetector.addSample(filteredPulseValue);
+            }
+
+            if (beatDetector.getRate() > 0) {
+                detecting = true;
+                spO2calculator.update(irACValue, redACValue, beatDetected);
+            } else if (detecting) {
+                detecting = false;
+                spO2calculator.reset();
+            }
+
+            if (beatDetected) {
+                result.beats.push_back(i);
+            }
+            result.rates.push_back(beatDetector.getRate());
+            result.spO2.push_back(spO2calculator.getSpO2());
+        }
+    }
+}
+
+// Tab separated "timestamp ir_level red_level" with a header line, as
+// written by extras/recorder/recorder.py
+static bool loadTrace(const char *path, std::vector<Sample> &trace)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long ts, ir, red;
+        if (sscanf(line, "%lu %lu %lu", &ts, &ir, &red) == 3) {
+            Sample s = { (uint16_t)ir, (uint16_t)red };
+            trace.push_back(s);
+        }
+    }
+    fclose(f);
+
+    return !trace.empty();
+}
+
+// A finger on the sensor: DC level with drift, a pulse with a quick rise and
+// a slower fall, red pulse amplitude redRatio times the IR one, plus noise.
+static void makeTrace(float bpm, float redRatio, float seconds, std::vector<Sample> &trace)
+{
+    srand((unsigned)(bpm * 100));
+    float period = 60.0 / bpm;
+
+    for (int i = 0; i < seconds * 1000 / SAMPLE_PERIOD_MS; i++) {
+        float t = i * SAMPLE_PERIOD_MS / 1000.0;
+        float phase = fmod(t, period) / period;
+        float pulse = phase < 0.15 ? phase / 0.15 : exp(-(phase - 0.15) * 4);
+        float drift = 300 * sin(t * 0.2);
+        float irNoise = (rand() % 21) - 10;
+        float redNoise = (rand() % 21) - 10;
+
+        Sample s;
+        s.ir = 40000 + drift - 250 * pulse + irNoise;
+        s.red = 38000 + drift - 250 * redRatio * pulse + redNoise;
+        trace.push_back(s);
+    }
+}
+
+static bool compare(const char *name, const std::vector<Sample> &trace, float expectedRate)
+{
+    Result f, q, b;
+    runFloat(trace, f);
+    runFixed(trace, q, 1);
+    runFixed(trace, b, FIFO_DEPTH);
+
+    // Beats found by only one of the chains, or a sample apart
+    size_t unmatched = 0;
+    size_t shifted = 0;
+    for (size_t i = 0, j = 0; i < f.beats.size() || j < q.beats.size(); ) {
+        if (i < f.beats.size() && j < q.beats.size() &&
+                labs((long)f.beats[i] - (long)q.beats[j]) <= MAX_BEAT_SHIFT_SAMPLES) {
+            if (f.beats[i] != q.beats[j]) {
+                shifted++;
+            }
+            i++;
+            j++;
+        } else if (j >= q.beats.size() || (i < f.beats.size() && f.beats[i] < q.beats[j])) {
+            unmatched++;
+            i++;
+        } else {
+            unmatched++;
+            j++;
+        }
+    }
+
+    float maxRateDiff = 0;
+    bool rateOk = true;
+    int maxSpO2Diff = 0;
+    for (size_t i = 0; i < trace.size(); i++) {
+        float rateDiff = fabs(f.rates[i] - q.rates[i]);
+        int spO2Diff = abs(f.spO2[i] - q.spO2[i]);
+        // While one chain has just seen a beat the other may follow a sample later
+        bool nearBeat = false;
+        for (size_t k = 0; k < q.beats.size(); k++) {
+            if (labs((long)q.beats[k] - (long)i) <= MAX_BEAT_SHIFT_SAMPLES) {
+                nearBeat = true;
+            }
+        }
+        if (nearBeat) {
+            continue;
+        }
+        if (rateDiff > maxRateDiff) {
+            maxRateDiff = rateDiff;
+        }
+        if (rateDiff > maxRateDifference(f.rates[i])) {
+            rateOk = false;
+        }
+        if (spO2Diff > maxSpO2Diff) {
+            maxSpO2Diff = spO2Diff;
+        }
+    }
+
+    // Beats and rates of the block-wise run that differ from the sample by sample one.
+    // Its timestamps are READ_LATENCY_MS later, that is in the first beat period and
+    // the period filter carries it for a few beats.
+    size_t blockDiff = 0;
+    for (size_t i = 0; i < b.beats.size() || i < q.beats.size(); i++) {
+        if (i >= b.beats.size() || i >= q.beats.size() || b.beats[i] != q.beats[i]) {
+            blockDiff++;
+        }
+    }
+    for (size_t i = 0; i < trace.size(); i++) {
+        if (fabs(b.rates[i] - q.rates[i]) > q.rates[i] * MAX_BLOCK_RATE_DIFFERENCE) {
+            blockDiff++;
+        }
+    }
+
+    bool ok = unmatched == 0 && rateOk && maxSpO2Diff <= MAX_SPO2_DIFFERENCE && blockDiff == 0;
+    if (expectedRate > 0 && fabs(q.rates.back() - expectedRate) > expectedRate * 0.05) {
+        ok = false;
+    }
+
+    printf("%-28s %6zu  %5zu %5zu %4zu %5zu %5zu  %6.1f %6.1f  %3d %3d  %6.2f %4d  %s\n", name, trace.size(),
+            f.beats.size(), q.beats.size(), unmatched, shifted, blockDiff,
+            f.rates.back(), q.rates.back(), f.spO2.back(), q.spO2.back(),
+            maxRateDiff, maxSpO2Diff, ok ? "ok" : "FAIL");
+
+    return ok;
+}
+
+// The fixed chain started long after boot: the first beat period is the whole
+// uptime. It must give a rate near zero, not one wrapped around 32 bits, and
+// then settle.
+static bool longUptime()
+{
+    std::vector<Sample> trace;
+    makeTrace(75, 0.7, 30, trace);
+    DCRemoverFixed irDCRemover(DC_REMOVER_ALPHA);
+    FilterBuLp1Fixed lpf;
+    BeatDetectorFixed beatDetector;
+    size_t beats = 0;
+    float firstRate = 0;
+
+    for (size_t i = 0; i < trace.size(); i++) {
+        int32_t filteredPulseValue = lpf.step(-irDCRemover.step(trace[i].ir));
+        if (beatDetector.addSample(filteredPulseValue, LONG_UPTIME_MS + i * SAMPLE_PERIOD_MS) && beats++ == 0) {
+            firstRate = beatDetector.getRate();
+        }
+    }
+
+    float rate = beatDetector.getRate();
+    bool ok = beats > 0 && firstRate < 2 && fabs(rate - 75) <= 75 * 0.05;
+    printf("fixed chain after %lu ms uptime: %zu beats, first rate %.1f, last rate %.1f bpm  %s\n",
+            (unsigned long)LONG_UPTIME_MS, beats, firstRate, rate, ok ? "ok" : "FAIL");
+
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    bool ok = true;
+
+    printf("                                        beats                         rate bpm    SpO2 %%    max difference\n");
+    printf("trace                        samples  float fixed miss shift block   float  fixed  flt fix    rate spO2\n");
+
+    std::vector<const char *> files;
+    for (int i = 1; i < argc; i++) {
+        files.push_back(argv[i]);
+    }
+    if (files.empty()) {
+        files.push_back("../recorder/test.out.sample");
+    }
+
+    for (size_t i = 0; i < files.size(); i++) {
+        std::vector<Sample> trace;
+        if (!loadTrace(files[i], trace)) {
+            printf("cannot read %s\n", files[i]);
+            return 1;
+        }
+        const char *name = strrchr(files[i], '/');
+        ok &= compare(name ? name + 1 : files[i], trace, 0);
+    }
+
+    if (argc == 1) {
+        static const float rates[] = { 50, 60, 75, 90, 110, 140 };
+        static const float redRatios[] = { 0.5, 0.6, 0.7, 0.8 };
+        for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+            for (size_t k = 0; k < sizeof(redRatios) / sizeof(redRatios[0]); k++) {
+                std::vector<Sample> trace;
+                makeTrace(rates[r], redRatios[k], 30, trace);
+                char name[40];
+                snprintf(name, sizeof(name), "synthetic %3.0f bpm red %.1f", rates[r], redRatios[k]);
+                ok &= compare(name, trace, rates[r]);
+            }
+        }
+        ok &= longUptime();
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+#!/bin/sh
+# Builds the MAX30100 pipeline check and runs it on the given traces
+# (default: the recorder sample trace and synthetic traces).
+set -e
+cd "$(dirname "$0")"
+SRC=../../src
+g++ -O2 -I. -o pipeline_check pipeline_check.cpp \
+    $SRC/MAX30100_BeatDetector.cpp $SRC/MAX30100_BeatDetectorFixed.cpp \
+    $SRC/MAX30100_SpO2Calculator.cpp $SRC/MAX30100_SpO2CalculatorFixed.cpp
+status=0
+./pipeline_check "$@" || status=$?
+rm -f pipeline_check
+exit $status
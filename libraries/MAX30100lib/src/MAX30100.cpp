@@ -20,7 +20,24 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "MAX30100.h"
 
-MAX30100::MAX30100()
+// Largest read the Wire library does in one requestFrom()
+#ifndef MAX30100_I2C_BUFFER_LENGTH
+#if defined(I2C_BUFFER_LENGTH)
+#define MAX30100_I2C_BUFFER_LENGTH  I2C_BUFFER_LENGTH
+#elif defined(BUFFER_LENGTH)
+#define MAX30100_I2C_BUFFER_LENGTH  BUFFER_LENGTH
+#else
+#define MAX30100_I2C_BUFFER_LENGTH  32
+#endif
+#endif
+
+// FIFO samples fetched per I2C transaction, the whole FIFO when the Wire buffer is large enough
+#define FIFO_SAMPLES_PER_READ       (MAX30100_I2C_BUFFER_LENGTH / 4 < MAX30100_FIFO_DEPTH ? \
+                                            MAX30100_I2C_BUFFER_LENGTH / 4 : MAX30100_FIFO_DEPTH)
+
+MAX30100::MAX30100() :
+    drainedCount(0),
+    overflowCount(0)
 {
 }
 
@@ -98,6 +115,19 @@ void MAX30100::resetFifo()
     writeRegister(MAX30100_REG_FIFO_WRITE_POINTER, 0);
     writeRegister(MAX30100_REG_FIFO_READ_POINTER, 0);
     writeRegister(MAX30100_REG_FIFO_OVERFLOW_COUNTER, 0);
+    overflowCount = 0;
+}
+
+// Number of samples fetched from the FIFO by the last readFifo() or update()
+uint8_t MAX30100::getDrainedCount()
+{
+    return drainedCount;
+}
+
+// Samples lost because the FIFO was full, since begin() or resetFifo()
+uint32_t MAX30100::getOverflowCount()
+{
+    return overflowCount;
 }
 
 uint8_t MAX30100::readRegister(uint8_t address)
@@ -118,7 +148,7 @@ void MAX30100::writeRegister(uint8_t address, uint8_t data)
     Wire.endTransmission();
 }
 
-void MAX30100::burstRead(uint8_t baseAddress, uint8_t *buffer, uint8_t length)
+uint8_t MAX30100::burstRead(uint8_t baseAddress, uint8_t *buffer, uint8_t length)
 {
     Wire.beginTransmission(MAX30100_I2C_ADDRESS);
     Wire.write(baseAddress);
@@ -126,28 +156,81 @@ void MAX30100::burstRead(uint8_t baseAddress, uint8_t *buffer, uint8_t length)
     Wire.requestFrom((uint8_t)MAX30100_I2C_ADDRESS, length);
 
     uint8_t idx = 0;
-    while (Wire.available()) {
+    while (Wire.available() && idx < length) {
         buffer[idx++] = Wire.read();
     }
+
+    return idx;
 }
 
-void MAX30100::readFifoData()
+// Drains up to size samples from the FIFO into readouts and returns how many were read.
+// The FIFO holds MAX30100_FIFO_DEPTH samples (160ms at 100Hz), the sketch can call this
+// that rarely without losing samples. The samples come in one I2C transaction when the
+// Wire buffer holds 64 bytes (ESP8266, ESP32), two on AVR.
+uint8_t MAX30100::readFifo(SensorReadout *readouts, uint8_t size)
 {
-    uint8_t buffer[MAX30100_FIFO_DEPTH*4];
-    uint8_t toRead;
+    // Write pointer, overflow counter and read pointer are adjacent registers
+    uint8_t pointers[3];
+    drainedCount = 0;
+
+    if (burstRead(MAX30100_REG_FIFO_WRITE_POINTER, pointers, 3) != 3) {
+        return 0;
+    }
+
+    uint8_t overflows = pointers[1];
+    uint8_t toRead = (pointers[0] - pointers[2]) & (MAX30100_FIFO_DEPTH-1);
+
+    // A full FIFO has the pointers equal too, the overflow counter tells it from an empty one
+    if (toRead == 0 && overflows) {
+        toRead = MAX30100_FIFO_DEPTH;
+    }
+    if (toRead > size) {
+        toRead = size;
+    }
+    if (toRead == 0) {
+        return 0;
+    }
+
+    // The counter is cleared by the device as soon as a sample is popped
+    overflowCount += overflows;
 
-    toRead = (readRegister(MAX30100_REG_FIFO_WRITE_POINTER) - readRegister(MAX30100_REG_FIFO_READ_POINTER)) & (MAX30100_FIFO_DEPTH-1);
+    while (drainedCount < toRead) {
+        uint8_t chunk = toRead - drainedCount;
+        if (chunk > FIFO_SAMPLES_PER_READ) {
+            chunk = FIFO_SAMPLES_PER_READ;
+        }
 
-    if (toRead) {
-        burstRead(MAX30100_REG_FIFO_DATA, buffer, 4 * toRead);
+        uint8_t *bytes = (uint8_t *)(readouts + drainedCount);
+        uint8_t received = burstRead(MAX30100_REG_FIFO_DATA, bytes, 4 * chunk) / 4;
 
-        for (uint8_t i=0 ; i < toRead ; ++i) {
+        for (uint8_t i=0 ; i < received ; ++i) {
+            uint8_t *sample = bytes + i * 4;
             // Warning: the values are always left-aligned
-            readoutsBuffer.push({
-                    .ir=(uint16_t)((buffer[i*4] << 8) | buffer[i*4 + 1]),
-                    .red=(uint16_t)((buffer[i*4 + 2] << 8) | buffer[i*4 + 3])});
+            uint16_t ir = (sample[0] << 8) | sample[1];
+            uint16_t red = (sample[2] << 8) | sample[3];
+
+            readouts[drainedCount + i].ir = ir;
+            readouts[drainedCount + i].red = red;
+        }
+
+        drainedCount += received;
+
+        if (received < chunk) {
+            break;
         }
     }
+
+    return drainedCount;
+}
+
+void MAX30100::readFifoData()
+{
+    SensorReadout readouts[MAX30100_FIFO_DEPTH];
+    uint8_t count = readFifo(readouts, MAX30100_FIFO_DEPTH);
+
+    for (uint8_t i=0 ; i < count ; ++i) {
+        readoutsBuffer.push(readouts[i]);
+    }
 }
 
 void MAX30100::startTemperatureSampling()
@@ -40,6 +40,9 @@ typedef struct {
     uint16_t red;
 } SensorReadout;
 
+// readFifo() decodes the FIFO bytes in place, one 4 bytes sample per readout
+static_assert(sizeof(SensorReadout) == 4, "SensorReadout must be packed in 4 bytes");
+
 class MAX30100 {
 public:
     MAX30100();
@@ -51,6 +54,9 @@ public:
     void setHighresModeEnabled(bool enabled);
     void update();
     bool getRawValues(uint16_t *ir, uint16_t *red);
+    uint8_t readFifo(SensorReadout *readouts, uint8_t size);
+    uint8_t getDrainedCount();
+    uint32_t getOverflowCount();
     void resetFifo();
     void startTemperatureSampling();
     bool isTemperatureReady();
@@ -61,10 +67,12 @@ public:
 
 private:
     CircularBuffer<SensorReadout, RINGBUFFER_SIZE> readoutsBuffer;
+    uint8_t drainedCount;
+    uint32_t overflowCount;
 
     uint8_t readRegister(uint8_t address);
     void writeRegister(uint8_t address, uint8_t data);
-    void burstRead(uint8_t baseAddress, uint8_t *buffer, uint8_t length);
+    uint8_t burstRead(uint8_t baseAddress, uint8_t *buffer, uint8_t length);
     void readFifoData();
 };
 
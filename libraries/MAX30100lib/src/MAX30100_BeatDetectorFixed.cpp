@@ -0,0 +1,167 @@
+/*
+Arduino-MAX30100 oximetry / heart rate integrated sensor library
+Copyright (C) 2016  OXullo Intersecans <x@brainrapers.org>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <Arduino.h>
+
+#include "MAX30100_BeatDetectorFixed.h"
+
+#ifndef min
+#define min(a,b) \
+   ({ __typeof__ (a) _a = (a); \
+       __typeof__ (b) _b = (b); \
+     _a < _b ? _a : _b; })
+#endif
+
+#define BEATDETECTORFIXED_PERIOD_SHIFT      4       // beat period in 1/16 ms
+#define BEATDETECTORFIXED_MIN_THRESHOLD     ((int32_t)BEATDETECTOR_MIN_THRESHOLD << MAX30100_Q8_SHIFT)
+#define BEATDETECTORFIXED_MAX_THRESHOLD     ((int32_t)BEATDETECTOR_MAX_THRESHOLD << MAX30100_Q8_SHIFT)
+#define BEATDETECTORFIXED_STEP_RESILIENCY   ((int32_t)BEATDETECTOR_STEP_RESILIENCY << MAX30100_Q8_SHIFT)
+// BEATDETECTOR_BPFILTER_ALPHA and the other factors in tenths / per 4096
+#define BEATDETECTORFIXED_BPFILTER_ALPHA    ((uint32_t)(BEATDETECTOR_BPFILTER_ALPHA * 10 + 0.5))
+#define BEATDETECTORFIXED_FALLOFF           ((int32_t)((1 - BEATDETECTOR_THRESHOLD_FALLOFF_TARGET) * 10 + 0.5))
+#define BEATDETECTORFIXED_DECAY             ((int32_t)((1 - BEATDETECTOR_THRESHOLD_DECAY_FACTOR) * 4096 + 0.5))
+// Longest gap between beats fed to the period filter, in ms (1 bpm), so that
+// ALPHA * (delta << PERIOD_SHIFT) stays within 32 bits
+#define BEATDETECTORFIXED_MAX_DELTA         60000UL
+
+BeatDetectorFixed::BeatDetectorFixed() :
+    state(BEATDETECTOR_STATE_INIT),
+    threshold(BEATDETECTORFIXED_MIN_THRESHOLD),
+    beatPeriod(0),
+    lastMaxValue(0),
+    thresholdStep(0),
+    tsLastBeat(0)
+{
+}
+
+bool BeatDetectorFixed::addSample(int32_t sample)
+{
+    return checkForBeat(sample, millis());
+}
+
+// For samples drained from the FIFO in a block: timestamp is when the sample was
+// taken by the sensor, in the millis() time base
+bool BeatDetectorFixed::addSample(int32_t sample, uint32_t timestamp)
+{
+    return checkForBeat(sample, timestamp);
+}
+
+float BeatDetectorFixed::getRate()
+{
+    if (beatPeriod != 0) {
+        return 60000.0 * (1 << BEATDETECTORFIXED_PERIOD_SHIFT) / beatPeriod;
+    } else {
+        return 0;
+    }
+}
+
+int32_t BeatDetectorFixed::getCurrentThreshold()
+{
+    return threshold;
+}
+
+// Filtered beat period in ms, 0 when not tracking
+uint16_t BeatDetectorFixed::getBeatPeriod()
+{
+    return beatPeriod >> BEATDETECTORFIXED_PERIOD_SHIFT;
+}
+
+bool BeatDetectorFixed::checkForBeat(int32_t sample, uint32_t now)
+{
+    bool beatDetected = false;
+
+    switch (state) {
+        case BEATDETECTOR_STATE_INIT:
+            if (now > BEATDETECTOR_INIT_HOLDOFF) {
+                state = BEATDETECTOR_STATE_WAITING;
+            }
+            break;
+
+        case BEATDETECTOR_STATE_WAITING:
+            if (sample > threshold) {
+                threshold = min(sample, BEATDETECTORFIXED_MAX_THRESHOLD);
+                state = BEATDETECTOR_STATE_FOLLOWING_SLOPE;
+            }
+
+            // Tracking lost, resetting
+            if (now - tsLastBeat > BEATDETECTOR_INVALID_READOUT_DELAY) {
+                beatPeriod = 0;
+                lastMaxValue = 0;
+            }
+
+            decreaseThreshold();
+            break;
+
+        case BEATDETECTOR_STATE_FOLLOWING_SLOPE:
+            if (sample < threshold) {
+                state = BEATDETECTOR_STATE_MAYBE_DETECTED;
+            } else {
+                threshold = min(sample, BEATDETECTORFIXED_MAX_THRESHOLD);
+            }
+            break;
+
+        case BEATDETECTOR_STATE_MAYBE_DETECTED:
+            if (sample + BEATDETECTORFIXED_STEP_RESILIENCY < threshold) {
+                // Found a beat
+                beatDetected = true;
+                lastMaxValue = sample;
+                state = BEATDETECTOR_STATE_MASKING;
+                uint32_t delta = min(now - tsLastBeat, (uint32_t)BEATDETECTORFIXED_MAX_DELTA);
+                if (delta) {
+                    beatPeriod = (BEATDETECTORFIXED_BPFILTER_ALPHA * (delta << BEATDETECTORFIXED_PERIOD_SHIFT) +
+                            (10 - BEATDETECTORFIXED_BPFILTER_ALPHA) * beatPeriod + 5) / 10;
+                }
+
+                // Per sample threshold fall-off, so decreaseThreshold() needs no division:
+                // lastMaxValue * (1 - FALLOFF_TARGET) spread over the samples of one period
+                if (lastMaxValue > 0 && beatPeriod > 0) {
+                    thresholdStep = (int32_t)(((uint32_t)lastMaxValue * BEATDETECTORFIXED_FALLOFF * BEATDETECTOR_SAMPLES_PERIOD
+                            * (1 << BEATDETECTORFIXED_PERIOD_SHIFT) / 10 + beatPeriod / 2) / beatPeriod);
+                }
+
+                tsLastBeat = now;
+            } else {
+                state = BEATDETECTOR_STATE_FOLLOWING_SLOPE;
+            }
+            break;
+
+        case BEATDETECTOR_STATE_MASKING:
+            if (now - tsLastBeat > BEATDETECTOR_MASKING_HOLDOFF) {
+                state = BEATDETECTOR_STATE_WAITING;
+            }
+            decreaseThreshold();
+            break;
+    }
+
+    return beatDetected;
+}
+
+void BeatDetectorFixed::decreaseThreshold()
+{
+    // When a valid beat rate readout is present, target the
+    if (lastMaxValue > 0 && beatPeriod > 0) {
+        threshold -= thresholdStep;
+    } else {
+        // Asymptotic decay
+        threshold -= (threshold * BEATDETECTORFIXED_DECAY) >> 12;
+    }
+
+    if (threshold < BEATDETECTORFIXED_MIN_THRESHOLD) {
+        threshold = BEATDETECTORFIXED_MIN_THRESHOLD;
+    }
+}
@@ -0,0 +1,52 @@
+/*
+Arduino-MAX30100 oximetry / heart rate integrated sensor library
+Copyright (C) 2016  OXullo Intersecans <x@brainrapers.org>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MAX30100_BEATDETECTORFIXED_H
+#define MAX30100_BEATDETECTORFIXED_H
+
+#include <stdint.h>
+
+#include "MAX30100_BeatDetector.h"
+#include "MAX30100_Filters.h"
+
+// Integer version of BeatDetector, same states and BEATDETECTOR_* settings.
+// Samples and threshold are Q8 (see MAX30100_Filters.h), the beat period is
+// kept in 1/16 ms. The only divisions happen once per detected beat.
+class BeatDetectorFixed
+{
+public:
+    BeatDetectorFixed();
+    bool addSample(int32_t sample);
+    bool addSample(int32_t sample, uint32_t timestamp);
+    float getRate();
+    int32_t getCurrentThreshold();
+    uint16_t getBeatPeriod();
+
+private:
+    bool checkForBeat(int32_t value, uint32_t now);
+    void decreaseThreshold();
+
+    BeatDetectorState state;
+    int32_t threshold;
+    uint32_t beatPeriod;
+    int32_t lastMaxValue;
+    int32_t thresholdStep;
+    uint32_t tsLastBeat;
+};
+
+#endif
@@ -19,6 +19,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef MAX30100_FILTERS_H
 #define MAX30100_FILTERS_H
 
+#include <stdint.h>
+
+// Fixed point signals are Q8: counts * 256 in an int32_t
+#define MAX30100_Q8_SHIFT       8
+#define MAX30100_Q8_ONE         (1L << MAX30100_Q8_SHIFT)
+
 // http://www.schwietering.com/jayduino/filtuino/
 // Low pass butterworth filter order=1 alpha1=0.1
 // Fs=100Hz, Fc=6Hz
@@ -71,4 +77,69 @@ private:
 	float dcw;
 };
 
+// Q8 version of FilterBuLp1. The coefficients are rounded to 63/256 and
+// 130/256, which keeps the DC gain at exactly 1 (Fc moves to ~6.05Hz).
+// Inputs must stay within +/-32767 counts, see DCRemoverFixed::step().
+class FilterBuLp1Fixed
+{
+	public:
+		FilterBuLp1Fixed()
+		{
+			v[0]=0;
+			v[1]=0;
+		}
+	private:
+		int32_t v[2];
+	public:
+		int32_t step(int32_t x) //class II
+		{
+			v[0] = v[1];
+			v[1] = (63 * x + 130 * v[0] + 128) >> 8;
+			return
+				 (v[0] + v[1]);
+		}
+};
+
+// Q8 version of DCRemover. dcw = x + alpha * dcw, output dcw - olddcw is
+// rewritten as tracking the DC level d = (1 - alpha) * dcw:
+//   out = x - d,  d += (1 - alpha) * (x - d)
+// with (1 - alpha) as a fraction of 1024. The output is limited to +/-32767
+// counts, which keeps every product within 32 bits for alpha >= 0.75.
+class DCRemoverFixed
+{
+public:
+	DCRemoverFixed() : beta(0), dc(0)
+	{
+	}
+	DCRemoverFixed(float alpha_) : beta((int32_t)((1 - alpha_) * 1024 + 0.5)), dc(0)
+	{
+	}
+
+	int32_t step(uint16_t x)
+	{
+		int32_t xq = (int32_t)x << MAX30100_Q8_SHIFT;
+		int32_t ac = xq - dc;
+
+		if (ac > 32767L * MAX30100_Q8_ONE) {
+			ac = 32767L * MAX30100_Q8_ONE;
+		} else if (ac < -32767L * MAX30100_Q8_ONE) {
+			ac = -32767L * MAX30100_Q8_ONE;
+		}
+
+		dc += (ac * beta) >> 10;
+
+		return ac;
+	}
+
+	// Same scale as DCRemover::getDCW(): dc / (1 - alpha), in counts
+	int32_t getDCW()
+	{
+		return beta ? (dc / beta) * 4 : 0;
+	}
+
+private:
+	int32_t beta;
+	int32_t dc;
+};
+
 #endif
@@ -27,6 +27,7 @@ PulseOximeter::PulseOximeter() :
     tsLastBeatDetected(0),
     tsLastBiasCheck(0),
     tsLastCurrentAdjustment(0),
+    tsLastSample(0),
     redLedCurrentIndex((uint8_t)RED_LED_CURRENT_START),
     irLedCurrent(DEFAULT_IR_LED_CURRENT),
     onBeatDetected(NULL)
@@ -49,8 +50,8 @@ bool PulseOximeter::begin(PulseOximeterDebuggingMode debuggingMode_)
     hrm.setMode(MAX30100_MODE_SPO2_HR);
     hrm.setLedsCurrent(irLedCurrent, (LEDCurrent)redLedCurrentIndex);
 
-    irDCRemover = DCRemover(DC_REMOVER_ALPHA);
-    redDCRemover = DCRemover(DC_REMOVER_ALPHA);
+    irDCRemover = DCRemoverFixed(DC_REMOVER_ALPHA);
+    redDCRemover = DCRemoverFixed(DC_REMOVER_ALPHA);
 
     state = PULSEOXIMETER_STATE_IDLE;
 
@@ -59,8 +60,6 @@ bool PulseOximeter::begin(PulseOximeterDebuggingMode debuggingMode_)
 
 void PulseOximeter::update()
 {
-    hrm.update();
-
     checkSample();
     checkCurrentBias();
 }
@@ -80,6 +79,18 @@ uint8_t PulseOximeter::getRedLedCurrentBias()
     return redLedCurrentIndex;
 }
 
+// Samples processed by the last update()
+uint8_t PulseOximeter::getDrainedCount()
+{
+    return hrm.getDrainedCount();
+}
+
+// Samples lost because update() wasn't called within MAX30100_FIFO_DEPTH samples
+uint32_t PulseOximeter::getOverflowCount()
+{
+    return hrm.getOverflowCount();
+}
+
 void PulseOximeter::setOnBeatDetectedCallback(void (*cb)())
 {
     onBeatDetected = cb;
@@ -103,16 +114,41 @@ void PulseOximeter::resume()
 
 void PulseOximeter::checkSample()
 {
-    uint16_t rawIRValue, rawRedValue;
+    SensorReadout readouts[MAX30100_FIFO_DEPTH];
+
+    // Drain the whole FIFO in one go, the samples are properly timed by the HRM
+    uint8_t count = hrm.readFifo(readouts, MAX30100_FIFO_DEPTH);
+
+    processSamples(readouts, count);
+}
+
+void PulseOximeter::processSamples(const SensorReadout *readouts, uint8_t count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    // The last sample was taken about now, the others one sampling period apart before it.
+    // The timestamps never go back past the previous block, read latency would make
+    // the beat detector see negative periods otherwise.
+    uint32_t tsFirst = millis() - (uint32_t)(count - 1) * SAMPLING_PERIOD_MS;
+    if (tsLastSample && (int32_t)(tsFirst - tsLastSample) < SAMPLING_PERIOD_MS) {
+        tsFirst = tsLastSample + SAMPLING_PERIOD_MS;
+    }
+    tsLastSample = tsFirst + (uint32_t)(count - 1) * SAMPLING_PERIOD_MS;
+
+    // The whole chain runs in Q8 fixed point (counts * 256), see MAX30100_Filters.h
+    for (uint8_t i=0 ; i < count ; ++i) {
+        uint16_t rawIRValue = readouts[i].ir;
+        uint16_t rawRedValue = readouts[i].red;
+        uint32_t timestamp = tsFirst + i * SAMPLING_PERIOD_MS;
 
-    // Dequeue all available samples, they're properly timed by the HRM
-    while (hrm.getRawValues(&rawIRValue, &rawRedValue)) {
-        float irACValue = irDCRemover.step(rawIRValue);
-        float redACValue = redDCRemover.step(rawRedValue);
+        int32_t irACValue = irDCRemover.step(rawIRValue);
+        int32_t redACValue = redDCRemover.step(rawRedValue);
 
         // The signal fed to the beat detector is mirrored since the cleanest monotonic spike is below zero
-        float filteredPulseValue = lpf.step(-irACValue);
-        bool beatDetected = beatDetector.addSample(filteredPulseValue);
+        int32_t filteredPulseValue = lpf.step(-irACValue);
+        bool beatDetected = beatDetector.addSample(filteredPulseValue, timestamp);
 
         if (beatDetector.getRate() > 0) {
             state = PULSEOXIMETER_STATE_DETECTING;
@@ -132,16 +168,16 @@ void PulseOximeter::checkSample()
 
             case PULSEOXIMETER_DEBUGGINGMODE_AC_VALUES:
                 Serial.print("R:");
-                Serial.print(irACValue);
+                Serial.print((float)irACValue / MAX30100_Q8_ONE);
                 Serial.print(",");
-                Serial.println(redACValue);
+                Serial.println((float)redACValue / MAX30100_Q8_ONE);
                 break;
 
             case PULSEOXIMETER_DEBUGGINGMODE_PULSEDETECT:
                 Serial.print("R:");
-                Serial.print(filteredPulseValue);
+                Serial.print((float)filteredPulseValue / MAX30100_Q8_ONE);
                 Serial.print(",");
-                Serial.println(beatDetector.getCurrentThreshold());
+                Serial.println((float)beatDetector.getCurrentThreshold() / MAX30100_Q8_ONE);
                 break;
 
             default:
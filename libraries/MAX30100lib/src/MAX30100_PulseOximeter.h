@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define MAX30100_PULSEOXIMETER_H
 
 #define SAMPLING_FREQUENCY                  100
+#define SAMPLING_PERIOD_MS                  (1000 / SAMPLING_FREQUENCY)
 #define CURRENT_ADJUSTMENT_PERIOD_MS        500
 #define DEFAULT_IR_LED_CURRENT              MAX30100_LED_CURR_50MA
 #define RED_LED_CURRENT_START               MAX30100_LED_CURR_27_1MA
@@ -28,9 +29,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdint.h>
 
 #include "MAX30100.h"
-#include "MAX30100_BeatDetector.h"
+#include "MAX30100_BeatDetectorFixed.h"
 #include "MAX30100_Filters.h"
-#include "MAX30100_SpO2Calculator.h"
+#include "MAX30100_SpO2CalculatorFixed.h"
 
 typedef enum PulseOximeterState {
     PULSEOXIMETER_STATE_INIT,
@@ -55,6 +56,8 @@ public:
     float getHeartRate();
     uint8_t getSpO2();
     uint8_t getRedLedCurrentBias();
+    uint8_t getDrainedCount();
+    uint32_t getOverflowCount();
     void setOnBeatDetectedCallback(void (*cb)());
     void setIRLedCurrent(LEDCurrent irLedCurrent);
     void shutdown();
@@ -62,6 +65,7 @@ public:
 
 private:
     void checkSample();
+    void processSamples(const SensorReadout *readouts, uint8_t count);
     void checkCurrentBias();
 
     PulseOximeterState state;
@@ -70,13 +74,14 @@ private:
     uint32_t tsLastBeatDetected;
     uint32_t tsLastBiasCheck;
     uint32_t tsLastCurrentAdjustment;
-    BeatDetector beatDetector;
-    DCRemover irDCRemover;
-    DCRemover redDCRemover;
-    FilterBuLp1 lpf;
+    uint32_t tsLastSample;
+    BeatDetectorFixed beatDetector;
+    DCRemoverFixed irDCRemover;
+    DCRemoverFixed redDCRemover;
+    FilterBuLp1Fixed lpf;
     uint8_t redLedCurrentIndex;
     LEDCurrent irLedCurrent;
-    SpO2Calculator spO2calculator;
+    SpO2CalculatorFixed spO2calculator;
     MAX30100 hrm;
 
     void (*onBeatDetected)();
@@ -32,6 +32,8 @@ public:
     uint8_t getSpO2();
 
 private:
+    friend class SpO2CalculatorFixed;
+
     static const uint8_t spO2LUT[43];
 
     float irACValueSqSum;
@@ -0,0 +1,129 @@
+/*
+Arduino-MAX30100 oximetry / heart rate integrated sensor library
+Copyright (C) 2016  OXullo Intersecans <x@brainrapers.org>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "MAX30100_SpO2CalculatorFixed.h"
+#include "MAX30100_Filters.h"
+
+// Squares are taken of Q4 values, their mean is 256x the mean in counts^2
+#define SPO2FIXED_SQ_SHIFT      (2 * (MAX30100_Q8_SHIFT - 4))
+
+static int16_t toQ4(int32_t acValue)
+{
+    acValue >>= MAX30100_Q8_SHIFT - 4;
+    if (acValue > 32767) {
+        return 32767;
+    } else if (acValue < -32767) {
+        return -32767;
+    }
+    return acValue;
+}
+
+SpO2CalculatorFixed::SpO2CalculatorFixed() :
+    irACValueSqSum(0),
+    redACValueSqSum(0),
+    beatsDetectedNum(0),
+    samplesRecorded(0),
+    spO2(0)
+{
+}
+
+void SpO2CalculatorFixed::update(int32_t irACValue, int32_t redACValue, bool beatDetected)
+{
+    int16_t ir = toQ4(irACValue);
+    int16_t red = toQ4(redACValue);
+
+    irACValueSqSum += (uint32_t)((int32_t)ir * ir);
+    redACValueSqSum += (uint32_t)((int32_t)red * red);
+    ++samplesRecorded;
+
+    if (beatDetected) {
+        ++beatsDetectedNum;
+        if (beatsDetectedNum == CALCULATE_EVERY_N_BEATS) {
+            int32_t index = 0;
+
+            // 100 * log(red mean square) / log(ir mean square), in 1/256
+            if (irACValueSqSum && redACValueSqSum) {
+                int32_t logSamples = log2Q16(samplesRecorded) + ((int32_t)SPO2FIXED_SQ_SHIFT << 16);
+                int32_t irLog = log2Q16(irACValueSqSum) - logSamples;
+                int32_t redLog = log2Q16(redACValueSqSum) - logSamples;
+
+                if (irLog != 0) {
+                    int64_t acSqRatio = (int64_t)redLog * (100 * 256) / irLog;
+
+                    if (acSqRatio > 66 * 256) {
+                        index = (acSqRatio >> 8) - 66;
+                    } else if (acSqRatio > 50 * 256) {
+                        index = (acSqRatio >> 8) - 50;
+                    }
+                    // SpO2Calculator reads past the table here
+                    if (index > (int32_t)sizeof(SpO2Calculator::spO2LUT) - 1) {
+                        index = sizeof(SpO2Calculator::spO2LUT) - 1;
+                    }
+                }
+            }
+            reset();
+
+            spO2 = SpO2Calculator::spO2LUT[index];
+        }
+    }
+}
+
+void SpO2CalculatorFixed::reset()
+{
+    samplesRecorded = 0;
+    redACValueSqSum = 0;
+    irACValueSqSum = 0;
+    beatsDetectedNum = 0;
+    spO2 = 0;
+}
+
+uint8_t SpO2CalculatorFixed::getSpO2()
+{
+    return spO2;
+}
+
+// log2(x) in Q16, x > 0. Integer part from the position of the top bit,
+// the 16 fraction bits by repeated squaring of the normalised mantissa.
+int32_t SpO2CalculatorFixed::log2Q16(uint64_t x)
+{
+    int32_t result = 31L << 16;
+
+    while (x >> 32) {
+        x >>= 1;
+        result += 1L << 16;
+    }
+
+    uint32_t m = (uint32_t)x;
+    while (!(m & 0x80000000UL)) {
+        m <<= 1;
+        result -= 1L << 16;
+    }
+
+    // m is now 1.0 .. 2.0 in Q31
+    for (uint8_t i = 0; i < 16; i++) {
+        uint64_t sq = (uint64_t)m * m;
+        if (sq >> 63) {
+            m = sq >> 32;
+            result += 1L << (15 - i);
+        } else {
+            m = sq >> 31;
+        }
+    }
+
+    return result;
+}
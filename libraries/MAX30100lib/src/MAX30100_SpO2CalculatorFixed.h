@@ -0,0 +1,48 @@
+/*
+Arduino-MAX30100 oximetry / heart rate integrated sensor library
+Copyright (C) 2016  OXullo Intersecans <x@brainrapers.org>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MAX30100_SPO2CALCULATORFIXED_H
+#define MAX30100_SPO2CALCULATORFIXED_H
+
+#include <stdint.h>
+
+#include "MAX30100_SpO2Calculator.h"
+
+// Integer version of SpO2Calculator. Takes the Q8 AC values of
+// DCRemoverFixed; they are squared at 1/16 count resolution (limited to
+// +/-2047 counts) into 64 bit sums, and the ratio of the logarithms is
+// taken with a fixed point log2.
+class SpO2CalculatorFixed {
+public:
+    SpO2CalculatorFixed();
+
+    void update(int32_t irACValue, int32_t redACValue, bool beatDetected);
+    void reset();
+    uint8_t getSpO2();
+
+    static int32_t log2Q16(uint64_t x);
+
+private:
+    uint64_t irACValueSqSum;
+    uint64_t redACValueSqSum;
+    uint8_t beatsDetectedNum;
+    uint32_t samplesRecorded;
+    uint8_t spO2;
+};
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * This program samples a ZMPT101B and an ACS712 in the background and
+ * prints their RMS values without blocking loop().
+*/
+
+#include <MainsSampler.h>
+#include <ZMPT101B.h>
+#include <ACS712.h>
+
+#define SENSITIVITY 500.0f
+#define FREQUENCY 50.0f
+
+ZMPT101B voltageSensor(A0, FREQUENCY);
+ACS712 currentSensor(ACS712_05B, A1);
+MainsSampler sampler;
+
+const uint8_t pins[] = { A0, A1 };
+
+// Two full periods at the default sample rate.
+uint16_t window[2 * MAINS_SAMPLER_DEFAULT_RATE / 50];
+
+unsigned long lastPrint = 0;
+
+void setup() {
+  Serial.begin(115200);
+  voltageSensor.setSensitivity(SENSITIVITY);
+
+  // The current sensor is calibrated with analogRead(), so do it before the
+  // sampler takes over the ADC.
+  currentSensor.calibrate();
+
+  if (!sampler.begin(pins, 2)) {
+    Serial.println(F("Sampler failed to start"));
+    while (true)
+      ;
+  }
+}
+
+void loop() {
+  sampler.update();
+
+  // Other work keeps running here while samples are being captured.
+
+  if (millis() - lastPrint >= 1000) {
+    lastPrint = millis();
+
+    uint16_t count = 2 * sampler.samplesPerCycle(FREQUENCY);
+    if (count > sizeof(window) / sizeof(window[0]))
+      count = sizeof(window) / sizeof(window[0]);
+
+    uint16_t n = sampler.read(0, window, count);
+    float voltage = voltageSensor.getRmsVoltage(window, n);
+
+    n = sampler.read(1, window, count);
+    float current = currentSensor.getCurrentAC(window, n);
+
+    Serial.print(voltage);
+    Serial.print(F(" V, "));
+    Serial.print(current);
+    Serial.println(F(" A"));
+  }
+}
@@ -0,0 +1,82 @@
+/**
+ * This program prints the harmonics and total harmonic distortion (THD)
+ * of the voltage and the current measured by a ZMPT101B and an ACS712.
+*/
+
+#include <MainsSampler.h>
+#include <HarmonicAnalyzer.h>
+#include <ZMPT101B.h>
+#include <ACS712.h>
+
+#define SENSITIVITY 500.0f
+#define FREQUENCY 50.0f
+#define ORDER 7
+
+ZMPT101B voltageSensor(A0, FREQUENCY);
+ACS712 currentSensor(ACS712_05B, A1);
+MainsSampler sampler;
+
+const uint8_t pins[] = { A0, A1 };
+
+// One analyzer serves both channels, each gets its own spectrum.
+#if defined(AVR)
+HarmonicAnalyzer<64> analyzer;
+#else
+HarmonicAnalyzer<256> analyzer;
+#endif
+HarmonicSpectrum voltageSpectrum;
+HarmonicSpectrum currentSpectrum;
+
+uint16_t window[MAINS_SAMPLER_BUFFER_SIZE];
+
+unsigned long lastPrint = 0;
+
+void printSpectrum(const char *name, const char *unit, const HarmonicSpectrum &spectrum) {
+  Serial.print(name);
+  Serial.print(spectrum.rms[1]);
+  Serial.print(unit);
+  Serial.print(F(", THD "));
+  Serial.print(100 * spectrum.thd);
+  Serial.print(F("%,"));
+  for (uint8_t h = 2; h <= spectrum.order; h++) {
+    Serial.print(F(" H"));
+    Serial.print(h);
+    Serial.print(F(" "));
+    Serial.print(100 * spectrum.rms[h] / spectrum.rms[1]);
+    Serial.print(F("%"));
+  }
+  Serial.println();
+}
+
+void setup() {
+  Serial.begin(115200);
+  voltageSensor.setSensitivity(SENSITIVITY);
+  currentSensor.calibrate();
+
+  sampler.begin(pins, 2);
+}
+
+void loop() {
+  sampler.update();
+
+  if (millis() - lastPrint >= 1000) {
+    lastPrint = millis();
+
+    uint16_t count = sampler.read(0, window, MAINS_SAMPLER_BUFFER_SIZE);
+
+    // Use the measured line frequency so the periods line up with the FFT.
+    voltageSensor.getRmsVoltageSynced(window, count, sampler.getSampleRate());
+    float frequency = voltageSensor.getFrequency();
+    if (frequency <= 0)
+      frequency = FREQUENCY;
+    float samplesPerCycle = sampler.getSampleRate() / frequency;
+
+    analyzer.analyze(window, count, samplesPerCycle, voltageSensor.getVoltageScale(), voltageSpectrum, ORDER);
+
+    count = sampler.read(1, window, MAINS_SAMPLER_BUFFER_SIZE);
+    analyzer.analyze(window, count, samplesPerCycle, currentSensor.getCurrentScale(), currentSpectrum, ORDER);
+
+    printSpectrum("V1 ", " V", voltageSpectrum);
+    printSpectrum("I1 ", " A", currentSpectrum);
+  }
+}
@@ -0,0 +1,53 @@
+/**
+ * This program measures real power and power factor with a ZMPT101B
+ * and an ACS712 sampled in the same window.
+*/
+
+#include <MainsSampler.h>
+#include <MainsPowerMeter.h>
+#include <ZMPT101B.h>
+#include <ACS712.h>
+
+#define SENSITIVITY 500.0f
+#define FREQUENCY 50.0f
+#define CYCLES 3
+
+ZMPT101B voltageSensor(A0, FREQUENCY);
+ACS712 currentSensor(ACS712_05B, A1);
+MainsPowerMeter<ZMPT101B, ACS712> meter(voltageSensor, currentSensor, FREQUENCY);
+MainsSampler sampler;
+
+const uint8_t pins[] = { A0, A1 };
+uint16_t voltage[CYCLES * MAINS_SAMPLER_DEFAULT_RATE / 50];
+uint16_t current[CYCLES * MAINS_SAMPLER_DEFAULT_RATE / 50];
+
+unsigned long lastPrint = 0;
+
+void setup() {
+  Serial.begin(115200);
+  voltageSensor.setSensitivity(SENSITIVITY);
+
+  // Current is sampled half a frame after voltage.
+  meter.setPhaseCalibration(1.5);
+
+  sampler.begin(pins, 2);
+}
+
+void loop() {
+  sampler.update();
+
+  if (millis() - lastPrint >= 1000) {
+    lastPrint = millis();
+
+    uint16_t count = sampler.read(0, voltage, 1, current, CYCLES * sampler.samplesPerCycle(FREQUENCY));
+    meter.calculate(voltage, current, count);
+
+    Serial.print(meter.getRmsVoltage());
+    Serial.print(F(" V, "));
+    Serial.print(meter.getRmsCurrent());
+    Serial.print(F(" A, "));
+    Serial.print(meter.getRealPower());
+    Serial.print(F(" W, PF "));
+    Serial.println(meter.getPowerFactor());
+  }
+}
@@ -0,0 +1,13 @@
+// Minimal Arduino stand-in for running the MainsMeter calculations on a
+// desktop machine.
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <math.h>
+#include <stdint.h>
+
+#define PI 3.1415926535897932384626433832795
+#define TWO_PI 6.283185307179586476925286766559
+
+#endif
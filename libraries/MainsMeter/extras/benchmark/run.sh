@@ -0,0 +1,10 @@
+#!/bin/sh
+# Builds the HarmonicAnalyzer benchmark against the kissfft copy shipped with
+# the Edge Impulse SDK and runs it.
+set -e
+cd "$(dirname "$0")"
+EI=../../../maixe_inferencing/src
+g++ -O2 -I. -I$EI -o harmonic_benchmark benchmark.cpp ../../src/HarmonicAnalyzer.cpp \
+  $EI/edge-impulse-sdk/dsp/kissfft/kiss_fft.cpp $EI/edge-impulse-sdk/dsp/kissfft/kiss_fftr.cpp
+./harmonic_benchmark
+rm -f harmonic_benchmark
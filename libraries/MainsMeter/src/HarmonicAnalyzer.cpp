@@ -0,0 +1,153 @@
+#include "HarmonicAnalyzer.h"
+
+HarmonicCalculator::HarmonicCalculator(float *re, float *im, float *cosTable, uint16_t points)
+	: re(re), im(im), cosTable(cosTable), points(points)
+{
+}
+
+/// @brief Fill the quarter wave cosine table used for all twiddle factors
+void HarmonicCalculator::initTable()
+{
+	for (uint16_t j = 0; j <= points / 4; j++)
+		cosTable[j] = cos(TWO_PI * j / points);
+}
+
+/// @brief cos(2 * pi * j / points) for j in [0, points / 2]
+float HarmonicCalculator::cosAt(uint16_t j) const
+{
+	return j <= points / 4 ? cosTable[j] : -cosTable[points / 2 - j];
+}
+
+/// @brief sin(2 * pi * j / points) for j in [0, points / 2]
+float HarmonicCalculator::sinAt(uint16_t j) const
+{
+	return j <= points / 4 ? cosTable[points / 4 - j] : cosTable[j - points / 4];
+}
+
+/// @brief In place radix-2 FFT of the points / 2 complex values in re/im
+void HarmonicCalculator::fft()
+{
+	uint16_t size = points / 2;
+
+	for (uint16_t i = 1, j = 0; i < size; i++)
+	{
+		uint16_t bit = size >> 1;
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+
+		if (i < j)
+		{
+			float t = re[i]; re[i] = re[j]; re[j] = t;
+			t = im[i]; im[i] = im[j]; im[j] = t;
+		}
+	}
+
+	for (uint16_t length = 2; length <= size; length <<= 1)
+	{
+		uint16_t half = length >> 1;
+		uint16_t step = points / length;
+
+		for (uint16_t j = 0; j < half; j++)
+		{
+			float wr = cosAt(j * step);
+			float wi = -sinAt(j * step);
+
+			for (uint16_t a = j; a < size; a += length)
+			{
+				uint16_t b = a + half;
+				float tr = wr * re[b] - wi * im[b];
+				float ti = wr * im[b] + wi * re[b];
+				re[b] = re[a] - tr;
+				im[b] = im[a] - ti;
+				re[a] += tr;
+				im[a] += ti;
+			}
+		}
+	}
+}
+
+/// @brief Calculate the harmonics of a window of raw samples
+/// @param samples raw samples, e.g. from MainsSampler::read()
+/// @param count number of samples, at least one period plus one sample
+/// @param samplesPerCycle sample rate divided by the mains frequency
+/// @param scale units per ADC step, e.g. ZMPT101B::getVoltageScale()
+/// @param spectrum receives the results
+/// @param order highest harmonic to calculate
+/// @return false if the window is shorter than one period
+bool HarmonicCalculator::analyze(const uint16_t *samples, uint16_t count, float samplesPerCycle, float scale,
+	HarmonicSpectrum &spectrum, uint8_t order)
+{
+	spectrum = HarmonicSpectrum();
+
+	if (order > HARMONIC_MAX_ORDER)
+		order = HARMONIC_MAX_ORDER;
+	if (order < 1)
+		order = 1;
+
+	// Whole periods in the window (the last sample is only used for
+	// interpolation), limited so the highest harmonic stays below the
+	// middle of the FFT.
+	uint16_t size = points / 2;
+	uint16_t maxCycles = (size - 1) / order;
+	if (samplesPerCycle < 2 || count < 2)
+		return false;
+
+	uint16_t cycles = (count - 1) / samplesPerCycle;
+	if (cycles > maxCycles)
+		cycles = maxCycles;
+	if (cycles == 0)
+		return false;
+
+	// Resample the periods onto the FFT length, even points into re and odd
+	// points into im for the packed real FFT.
+	float step = cycles * samplesPerCycle / points;
+	for (uint16_t j = 0; j < points; j++)
+	{
+		float t = j * step;
+		uint16_t i = t;
+		float x = samples[i] + (t - i) * ((int16_t)samples[i + 1] - (int16_t)samples[i]);
+
+		if (j & 1)
+			im[j >> 1] = x;
+		else
+			re[j >> 1] = x;
+	}
+
+	fft();
+
+	spectrum.order = order;
+	spectrum.cycles = cycles;
+	spectrum.dc = (re[0] + im[0]) / points * scale;
+
+	float sumSquares = 0;
+	for (uint8_t h = 1; h <= order; h++)
+	{
+		// Unpack bin k of the real FFT from bins k and size - k.
+		uint16_t k = h * cycles;
+		uint16_t m = size - k;
+		float evenRe = (re[k] + re[m]) / 2;
+		float evenIm = (im[k] - im[m]) / 2;
+		float oddRe = (im[k] + im[m]) / 2;
+		float oddIm = (re[m] - re[k]) / 2;
+		float wr = cosAt(k);
+		float wi = -sinAt(k);
+		float xr = evenRe + wr * oddRe - wi * oddIm;
+		float xi = evenIm + wr * oddIm + wi * oddRe;
+
+		// Undo the sinc^2 response of the linear interpolation.
+		float x = PI * h / samplesPerCycle;
+		float sinc = sin(x) / x;
+
+		float rms = sqrt(xr * xr + xi * xi) * (float)M_SQRT2 / points * scale / (sinc * sinc);
+		spectrum.rms[h] = rms;
+		spectrum.phase[h] = atan2(xi, xr);
+
+		if (h > 1)
+			sumSquares += rms * rms;
+	}
+
+	spectrum.thd = spectrum.rms[1] > 0 ? sqrt(sumSquares) / spectrum.rms[1] : 0;
+
+	return true;
+}
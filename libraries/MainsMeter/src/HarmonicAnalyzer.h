@@ -0,0 +1,79 @@
+#ifndef HarmonicAnalyzer_h
+#define HarmonicAnalyzer_h
+
+#include <Arduino.h>
+
+// Highest harmonic order a HarmonicSpectrum can hold.
+#ifndef HARMONIC_MAX_ORDER
+	#define HARMONIC_MAX_ORDER 15
+#endif
+
+/// Harmonic content of one channel.
+///
+/// rms[1] is the fundamental and rms[h] harmonic h, both as RMS values in
+/// the units of the scale passed to analyze(). phase[h] is in radians,
+/// relative to a cosine starting at the first sample of the window.
+struct HarmonicSpectrum
+{
+	uint8_t  order = 0;
+	uint8_t  cycles = 0;
+	float    dc = 0;
+	float    rms[HARMONIC_MAX_ORDER + 1] = {};
+	float    phase[HARMONIC_MAX_ORDER + 1] = {};
+	float    thd = 0;
+};
+
+/// Harmonic analysis of a whole number of mains periods with a real FFT.
+///
+/// The window is resampled so that the periods it covers span exactly the
+/// FFT length, which puts harmonic h of the fundamental on bin h * cycles
+/// and avoids leakage between harmonics. The linear interpolation used for
+/// resampling attenuates high harmonics by sinc^2(h / samplesPerCycle);
+/// this is compensated. The FFT packs the real input into a complex FFT of
+/// half the length and only the harmonic bins are unpacked.
+///
+/// All storage is provided by HarmonicAnalyzer<POINTS>, so nothing is
+/// allocated at run time. One analyzer can process any number of channels,
+/// one HarmonicSpectrum each.
+class HarmonicCalculator
+{
+public:
+	bool     analyze(const uint16_t *samples, uint16_t count, float samplesPerCycle, float scale,
+		HarmonicSpectrum &spectrum, uint8_t order = HARMONIC_MAX_ORDER);
+
+	uint16_t getPoints() const { return points; }
+
+protected:
+	HarmonicCalculator(float *re, float *im, float *cosTable, uint16_t points);
+
+	void     initTable();
+
+private:
+	float    *re;
+	float    *im;
+	float    *cosTable;
+	uint16_t points;
+
+	void     fft();
+	float    cosAt(uint16_t j) const;
+	float    sinAt(uint16_t j) const;
+};
+
+/// Harmonic analyzer with a POINTS-point FFT (a power of two, 8 to 4096).
+/// Uses (POINTS + POINTS / 4 + 1) floats: 1.3 KB for 256 points.
+template <uint16_t POINTS>
+class HarmonicAnalyzer : public HarmonicCalculator
+{
+	static_assert(POINTS >= 8 && POINTS <= 4096 && (POINTS & (POINTS - 1)) == 0,
+		"POINTS must be a power of two between 8 and 4096");
+
+public:
+	HarmonicAnalyzer() : HarmonicCalculator(real, imag, table, POINTS) { initTable(); }
+
+private:
+	float real[POINTS / 2];
+	float imag[POINTS / 2];
+	float table[POINTS / 4 + 1];
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "MainsPowerMeter.h"
+
+/// @brief Clear the accumulated samples
+void MainsPowerCalculator::reset()
+{
+	count = 0;
+	lastV = 0;
+	sumV = sumI = 0;
+	sumVV = sumII = 0;
+	sumPV = sumPLastV = sumPI = 0;
+	sumVI = sumLastVI = 0;
+}
+
+/// @brief Accumulate one voltage/current sample pair
+/// @param voltage raw voltage sample
+/// @param current raw current sample taken right after it
+void MainsPowerCalculator::add(uint16_t voltage, uint16_t current)
+{
+	// Sums are taken relative to the first sample so they stay small; the
+	// real offset (the window mean) is removed in calculate().
+	if (count == 0)
+	{
+		offsetV = voltage;
+		offsetI = current;
+	}
+
+	int16_t v = voltage - offsetV;
+	int16_t i = current - offsetI;
+
+	sumV += v;
+	sumI += i;
+	sumVV += (int32_t)v * v;
+	sumII += (int32_t)i * i;
+
+	// Power needs the previous voltage sample, so it starts at the second pair.
+	if (count > 0)
+	{
+		sumPV += v;
+		sumPLastV += lastV;
+		sumPI += i;
+		sumVI += (int32_t)v * i;
+		sumLastVI += (int32_t)lastV * i;
+	}
+
+	lastV = v;
+	count++;
+}
+
+/// @brief Accumulate a block of voltage/current sample pairs
+/// @param voltage raw voltage samples
+/// @param current raw current samples taken in the same frames
+/// @param count number of sample pairs
+void MainsPowerCalculator::add(const uint16_t *voltage, const uint16_t *current, uint16_t count)
+{
+	for (uint16_t k = 0; k < count; k++)
+		add(voltage[k], current[k]);
+}
+
+/// @brief Turn the accumulated sums into RMS values and power
+/// @param voltageScale volts per ADC step
+/// @param currentScale amperes per ADC step
+void MainsPowerCalculator::calculate(float voltageScale, float currentScale)
+{
+	if (count < 2)
+	{
+		Vrms = Irms = realPower = apparentPower = powerFactor = 0;
+		return;
+	}
+
+	float meanV = (float)sumV / count;
+	float meanI = (float)sumI / count;
+	float varV = (float)sumVV / count - meanV * meanV;
+	float varI = (float)sumII / count - meanI * meanI;
+
+	Vrms = voltageScale * sqrt(varV > 0 ? varV : 0);
+	Irms = currentScale * sqrt(varI > 0 ? varI : 0);
+
+	// Mean of (phase shifted V) * I minus the product of their means.
+	uint16_t n = count - 1;
+	float shiftedVI = ((1.0f - phaseCal) * sumLastVI + phaseCal * sumVI) / n;
+	float shiftedV = ((1.0f - phaseCal) * sumPLastV + phaseCal * sumPV) / n;
+	float instP = shiftedVI - shiftedV * ((float)sumPI / n);
+
+	realPower = voltageScale * currentScale * instP;
+	apparentPower = Vrms * Irms;
+	powerFactor = apparentPower > 0 ? realPower / apparentPower : 0;
+}
@@ -0,0 +1,110 @@
+#ifndef MainsPowerMeter_h
+#define MainsPowerMeter_h
+
+#include <Arduino.h>
+
+#define MAINS_POWER_DEFAULT_FREQUENCY 50.0f
+#define MAINS_POWER_DEFAULT_PHASECAL 1.0f
+
+/// Voltage, current and power from paired voltage/current samples.
+///
+/// Samples are accumulated as exact integer sums; the DC offset of each
+/// channel is the mean of the window. Phase calibration follows
+/// EnergyMonitor::calcVI() from EmonLib: the voltage paired with current
+/// sample k is V[k-1] + phaseCal * (V[k] - V[k-1]). A value of 1.0 applies no
+/// shift; when current is sampled half way between two voltage samples
+/// (MainsSampler with two pins, or analogRead() of V then I) 1.5 removes
+/// that sampling delay, and sensor phase errors are calibrated on top.
+class MainsPowerCalculator
+{
+public:
+	void  setPhaseCalibration(float value) { phaseCal = value; }
+
+	void  reset();
+	void  add(uint16_t voltage, uint16_t current);
+	void  add(const uint16_t *voltage, const uint16_t *current, uint16_t count);
+	void  calculate(float voltageScale, float currentScale);
+
+	float getRmsVoltage() const { return Vrms; }
+	float getRmsCurrent() const { return Irms; }
+	float getRealPower() const { return realPower; }
+	float getApparentPower() const { return apparentPower; }
+	float getPowerFactor() const { return powerFactor; }
+	uint16_t getSampleCount() const { return count; }
+
+private:
+	float    phaseCal = MAINS_POWER_DEFAULT_PHASECAL;
+
+	uint16_t count = 0;
+	uint16_t offsetV = 0;
+	uint16_t offsetI = 0;
+	int16_t  lastV = 0;
+
+	int32_t  sumV = 0, sumI = 0;
+	int64_t  sumVV = 0, sumII = 0;
+	int32_t  sumPV = 0, sumPLastV = 0, sumPI = 0;
+	int64_t  sumVI = 0, sumLastVI = 0;
+
+	float    Vrms = 0;
+	float    Irms = 0;
+	float    realPower = 0;
+	float    apparentPower = 0;
+	float    powerFactor = 0;
+};
+
+/// Combined V+I meter built on a ZMPT101B and an ACS712 driver.
+///
+/// The sensor classes only need getPin() and getVoltageScale() /
+/// getCurrentScale(), so the sketch-local ACS712 copies work as well.
+template <class VoltageSensor, class CurrentSensor>
+class MainsPowerMeter : public MainsPowerCalculator
+{
+public:
+	MainsPowerMeter(VoltageSensor &voltageSensor, CurrentSensor &currentSensor,
+		float frequency = MAINS_POWER_DEFAULT_FREQUENCY)
+		: voltageSensor(voltageSensor), currentSensor(currentSensor),
+		  period(1000000 / frequency)
+	{
+	}
+
+	/// @brief Sample voltage and current alternately with analogRead() for
+	/// a number of periods and calculate the results. Blocks for that time.
+	/// @param cycles number of mains periods to integrate over
+	void measure(uint8_t cycles = 1)
+	{
+		uint8_t pinV = voltageSensor.getPin();
+		uint8_t pinI = currentSensor.getPin();
+		uint32_t window = period * cycles;
+
+		reset();
+		uint32_t t_start = micros();
+		while (micros() - t_start < window)
+		{
+			uint16_t sampleV = analogRead(pinV);
+			uint16_t sampleI = analogRead(pinI);
+			add(sampleV, sampleI);
+		}
+		calculate(voltageSensor.getVoltageScale(), currentSensor.getCurrentScale());
+	}
+
+	/// @brief Calculate the results from samples captured elsewhere, e.g.
+	/// with MainsSampler::read() of the voltage and current channels.
+	/// @param voltage raw voltage samples
+	/// @param current raw current samples taken in the same frames
+	/// @param count number of sample pairs, ideally whole periods
+	void calculate(const uint16_t *voltage, const uint16_t *current, uint16_t count)
+	{
+		reset();
+		add(voltage, current, count);
+		calculate(voltageSensor.getVoltageScale(), currentSensor.getCurrentScale());
+	}
+
+	using MainsPowerCalculator::calculate;
+
+private:
+	VoltageSensor &voltageSensor;
+	CurrentSensor &currentSensor;
+	uint32_t period;
+};
+
+#endif
@@ -0,0 +1,399 @@
+#include "MainsSampler.h"
+
+#if defined(ESP32) && defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+	#define MAINS_SAMPLER_ESP32_DMA
+	#include "esp_adc/adc_continuous.h"
+#endif
+
+#if defined(AVR)
+
+static MainsSampler *activeSampler = nullptr;
+static uint8_t adcMux[MAINS_SAMPLER_MAX_CHANNELS];
+static uint8_t adcChannels = 0;
+static volatile uint8_t adcIndex = 0;
+static uint16_t adcFrame[MAINS_SAMPLER_MAX_CHANNELS];
+
+static inline void selectMux(uint8_t mux)
+{
+	ADMUX = _BV(REFS0) | (mux & 0x07);
+#if defined(MUX5)
+	if (mux & 0x08)
+		ADCSRB |= _BV(MUX5);
+	else
+		ADCSRB &= ~_BV(MUX5);
+#endif
+}
+
+ISR(ADC_vect)
+{
+	uint8_t index = adcIndex;
+
+	adcFrame[index] = ADC;
+	// The trigger is the rising edge of OCF1B, so clear it for the next one.
+	TIFR1 = _BV(OCF1B);
+
+	if (++index >= adcChannels)
+	{
+		index = 0;
+		activeSampler->pushFrame(adcFrame);
+	}
+
+	adcIndex = index;
+	// Takes effect for the next timer-triggered conversion.
+	selectMux(adcMux[index]);
+}
+
+#elif defined(MAINS_SAMPLER_ESP32_DMA)
+
+#define MAINS_SAMPLER_DMA_FRAME_BYTES (64 * SOC_ADC_DIGI_RESULT_BYTES)
+#define MAINS_SAMPLER_DMA_POOL_BYTES (8 * MAINS_SAMPLER_DMA_FRAME_BYTES)
+
+static adc_continuous_handle_t adcHandle = nullptr;
+static adc_channel_t adcChannelOf[MAINS_SAMPLER_MAX_CHANNELS];
+static uint8_t adcDecimation = 1;
+static uint8_t adcDecimationCount = 0;
+static uint32_t adcSum[MAINS_SAMPLER_MAX_CHANNELS];
+
+static bool IRAM_ATTR onPoolOverflow(adc_continuous_handle_t handle,
+	const adc_continuous_evt_data_t *edata, void *user_data)
+{
+	(*(volatile uint32_t *)user_data)++;
+	return false;
+}
+
+#endif
+
+/// @brief Start sampling a single analog input
+/// @param pin analog pin to sample
+/// @param sampleRate samples per second
+/// @return true if acquisition was started
+bool MainsSampler::begin(uint8_t pin, uint16_t sampleRate)
+{
+	return begin(&pin, 1, sampleRate);
+}
+
+/// @brief Start sampling several analog inputs in lockstep
+/// @param pins analog pins to sample, in frame order
+/// @param count number of pins (up to MAINS_SAMPLER_MAX_CHANNELS)
+/// @param sampleRate frames per second, i.e. samples per second per pin
+/// @return true if acquisition was started
+bool MainsSampler::begin(const uint8_t *pins, uint8_t count, uint16_t sampleRate)
+{
+	if (count == 0 || count > MAINS_SAMPLER_MAX_CHANNELS || sampleRate == 0)
+		return false;
+
+	end();
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		this->pins[i] = pins[i];
+		pinMode(pins[i], INPUT);
+	}
+	channelCount = count;
+	this->sampleRate = sampleRate;
+	head = 0;
+	frames = 0;
+	overruns = 0;
+
+	running = startHardware();
+	return running;
+}
+
+/// @brief Stop acquisition and hand the ADC back to analogRead()
+void MainsSampler::end()
+{
+	if (running)
+		stopHardware();
+	running = false;
+}
+
+/// @brief Collect pending samples. Call from loop(); it never blocks.
+/// On AVR sampling is interrupt driven and this is a no-op.
+void MainsSampler::update()
+{
+	if (!running)
+		return;
+
+#if defined(AVR)
+	return;
+#elif defined(MAINS_SAMPLER_ESP32_DMA)
+	uint8_t raw[MAINS_SAMPLER_DMA_FRAME_BYTES];
+	uint32_t length = 0;
+
+	while (adc_continuous_read(adcHandle, raw, sizeof(raw), &length, 0) == ESP_OK)
+	{
+		for (uint32_t i = 0; i < length; i += SOC_ADC_DIGI_RESULT_BYTES)
+		{
+			adc_digi_output_data_t *result = (adc_digi_output_data_t *)&raw[i];
+	#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+			uint32_t channel = result->type1.channel;
+			uint32_t value = result->type1.data;
+	#else
+			uint32_t channel = result->type2.channel;
+			uint32_t value = result->type2.data;
+	#endif
+			uint8_t index = 0;
+			while (index < channelCount && adcChannelOf[index] != channel)
+				index++;
+			if (index == channelCount)
+				continue;
+
+			adcSum[index] += value;
+
+			// The pattern ends with the last pin; one pass over it is one
+			// hardware frame, and adcDecimation of them make one sample frame.
+			if (index == channelCount - 1 && ++adcDecimationCount >= adcDecimation)
+			{
+				uint16_t frame[MAINS_SAMPLER_MAX_CHANNELS];
+				for (uint8_t c = 0; c < channelCount; c++)
+				{
+					frame[c] = adcSum[c] / adcDecimation;
+					adcSum[c] = 0;
+				}
+				adcDecimationCount = 0;
+				pushFrame(frame);
+			}
+		}
+	}
+#else
+	uint32_t now = micros();
+	uint32_t elapsed = now - lastSample;
+
+	if (elapsed < interval)
+		return;
+
+	uint32_t due = elapsed / interval;
+	if (due > 1)
+		overruns += due - 1;
+	lastSample += due * interval;
+
+	uint16_t frame[MAINS_SAMPLER_MAX_CHANNELS];
+	for (uint8_t c = 0; c < channelCount; c++)
+		frame[c] = analogRead(pins[c]);
+	pushFrame(frame);
+#endif
+}
+
+/// @brief Number of buffered samples needed to cover one mains cycle
+/// @param frequency AC system frequency
+/// @return samples per cycle at the current sample rate
+uint16_t MainsSampler::samplesPerCycle(float frequency) const
+{
+	return (uint16_t)(sampleRate / frequency + 0.5f);
+}
+
+/// @brief Total frames captured since begin(). Compare two values to
+/// find out how many new samples arrived in between.
+/// @return frame counter
+uint32_t MainsSampler::getFrameCount()
+{
+	noInterrupts();
+	uint32_t value = frames;
+	interrupts();
+	return value;
+}
+
+/// @brief Samples lost because the driver buffer overflowed or, when
+/// polling, because update() was called too late.
+/// @return lost sample counter
+uint32_t MainsSampler::getOverrunCount()
+{
+	noInterrupts();
+	uint32_t value = overruns;
+	interrupts();
+	return value;
+}
+
+/// @brief Number of frames currently held in the ring buffer
+/// @return buffered frames
+uint16_t MainsSampler::available()
+{
+	uint32_t value = getFrameCount();
+	return value < MAINS_SAMPLER_BUFFER_SIZE ? value : MAINS_SAMPLER_BUFFER_SIZE;
+}
+
+/// @brief Copy the most recent samples of one channel, oldest first
+/// @param channel index of the pin as given to begin()
+/// @param samples destination buffer
+/// @param count number of samples wanted
+/// @return number of samples copied
+uint16_t MainsSampler::read(uint8_t channel, uint16_t *samples, uint16_t count)
+{
+	if (channel >= channelCount)
+		return 0;
+
+	uint16_t stored = available();
+	if (count > stored)
+		count = stored;
+
+	noInterrupts();
+	uint16_t index = (head - count) & (MAINS_SAMPLER_BUFFER_SIZE - 1);
+	for (uint16_t i = 0; i < count; i++)
+	{
+		samples[i] = buffer[index][channel];
+		index = (index + 1) & (MAINS_SAMPLER_BUFFER_SIZE - 1);
+	}
+	interrupts();
+
+	return count;
+}
+
+/// @brief Copy the most recent samples of two channels from the same
+/// frames, e.g. voltage and current for a power calculation
+/// @param channelA index of the first pin as given to begin()
+/// @param samplesA destination buffer for the first pin
+/// @param channelB index of the second pin as given to begin()
+/// @param samplesB destination buffer for the second pin
+/// @param count number of samples wanted per channel
+/// @return number of samples copied per channel
+uint16_t MainsSampler::read(uint8_t channelA, uint16_t *samplesA, uint8_t channelB, uint16_t *samplesB, uint16_t count)
+{
+	if (channelA >= channelCount || channelB >= channelCount)
+		return 0;
+
+	uint16_t stored = available();
+	if (count > stored)
+		count = stored;
+
+	noInterrupts();
+	uint16_t index = (head - count) & (MAINS_SAMPLER_BUFFER_SIZE - 1);
+	for (uint16_t i = 0; i < count; i++)
+	{
+		samplesA[i] = buffer[index][channelA];
+		samplesB[i] = buffer[index][channelB];
+		index = (index + 1) & (MAINS_SAMPLER_BUFFER_SIZE - 1);
+	}
+	interrupts();
+
+	return count;
+}
+
+/// @brief Append one frame (one value per channel) to the ring buffer.
+/// Used by the acquisition backends; can also feed an external ADC.
+/// @param values one sample per channel, in pin order
+void MainsSampler::pushFrame(const uint16_t *values)
+{
+	uint16_t index = head;
+
+	for (uint8_t c = 0; c < channelCount; c++)
+		buffer[index][c] = values[c];
+
+	head = (index + 1) & (MAINS_SAMPLER_BUFFER_SIZE - 1);
+	frames++;
+}
+
+bool MainsSampler::startHardware()
+{
+#if defined(AVR)
+	uint32_t ticks = F_CPU / 8 / ((uint32_t)sampleRate * channelCount);
+	if (ticks < 2 || ticks > 65536)
+		return false;
+
+	for (uint8_t i = 0; i < channelCount; i++)
+	{
+		uint8_t pin = pins[i] >= A0 ? pins[i] - A0 : pins[i];
+	#if defined(analogPinToChannel)
+		adcMux[i] = analogPinToChannel(pin);
+	#else
+		adcMux[i] = pin;
+	#endif
+	}
+	adcChannels = channelCount;
+	adcIndex = 0;
+	activeSampler = this;
+
+	noInterrupts();
+	// Timer1 in CTC mode, prescaler 8; compare match B triggers the ADC.
+	TCCR1A = 0;
+	TCCR1B = 0;
+	TCNT1 = 0;
+	OCR1A = ticks - 1;
+	OCR1B = ticks - 1;
+	TIFR1 = _BV(OCF1B);
+	TCCR1B = _BV(WGM12) | _BV(CS11);
+
+	selectMux(adcMux[0]);
+	ADCSRB = (ADCSRB & ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0))) | _BV(ADTS2) | _BV(ADTS0);
+	ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+	interrupts();
+
+	return true;
+#elif defined(MAINS_SAMPLER_ESP32_DMA)
+	uint32_t frequency = (uint32_t)sampleRate * channelCount;
+
+	adcDecimation = (SOC_ADC_SAMPLE_FREQ_THRES_LOW + frequency - 1) / frequency;
+	if (adcDecimation == 0)
+		adcDecimation = 1;
+	frequency *= adcDecimation;
+	if (frequency > SOC_ADC_SAMPLE_FREQ_THRES_HIGH)
+		return false;
+
+	adc_digi_pattern_config_t pattern[MAINS_SAMPLER_MAX_CHANNELS] = {};
+	for (uint8_t i = 0; i < channelCount; i++)
+	{
+		adc_unit_t unit;
+		if (adc_continuous_io_to_channel(pins[i], &unit, &adcChannelOf[i]) != ESP_OK || unit != ADC_UNIT_1)
+			return false;
+
+		pattern[i].atten = ADC_ATTEN_DB_12;
+		pattern[i].channel = adcChannelOf[i];
+		pattern[i].unit = ADC_UNIT_1;
+		pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+		adcSum[i] = 0;
+	}
+	adcDecimationCount = 0;
+
+	adc_continuous_handle_cfg_t handleConfig = {};
+	handleConfig.max_store_buf_size = MAINS_SAMPLER_DMA_POOL_BYTES;
+	handleConfig.conv_frame_size = MAINS_SAMPLER_DMA_FRAME_BYTES;
+	if (adc_continuous_new_handle(&handleConfig, &adcHandle) != ESP_OK)
+		return false;
+
+	adc_continuous_config_t config = {};
+	config.pattern_num = channelCount;
+	config.adc_pattern = pattern;
+	config.sample_freq_hz = frequency;
+	config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+	#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+	config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+	#else
+	config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+	#endif
+
+	adc_continuous_evt_cbs_t callbacks = {};
+	callbacks.on_pool_ovf = onPoolOverflow;
+
+	if (adc_continuous_config(adcHandle, &config) != ESP_OK ||
+		adc_continuous_register_event_callbacks(adcHandle, &callbacks, (void *)&overruns) != ESP_OK ||
+		adc_continuous_start(adcHandle) != ESP_OK)
+	{
+		adc_continuous_deinit(adcHandle);
+		adcHandle = nullptr;
+		return false;
+	}
+
+	return true;
+#else
+	interval = 1000000UL / sampleRate;
+	lastSample = micros();
+	return interval > 0;
+#endif
+}
+
+void MainsSampler::stopHardware()
+{
+#if defined(AVR)
+	noInterrupts();
+	// Back to the state left by the Arduino core init().
+	ADCSRA = _BV(ADEN) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+	ADCSRB &= ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0));
+	TCCR1B = _BV(CS11) | _BV(CS10);
+	TCCR1A = _BV(WGM10);
+	interrupts();
+	activeSampler = nullptr;
+#elif defined(MAINS_SAMPLER_ESP32_DMA)
+	adc_continuous_stop(adcHandle);
+	adc_continuous_deinit(adcHandle);
+	adcHandle = nullptr;
+#endif
+}
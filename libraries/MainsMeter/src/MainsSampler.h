@@ -0,0 +1,74 @@
+#ifndef MainsSampler_h
+#define MainsSampler_h
+
+#include <Arduino.h>
+
+// Number of analog inputs that can be sampled in the same frame.
+#ifndef MAINS_SAMPLER_MAX_CHANNELS
+	#define MAINS_SAMPLER_MAX_CHANNELS 2
+#endif
+
+// Frames kept per channel. Must be a power of two.
+#ifndef MAINS_SAMPLER_BUFFER_SIZE
+	#if defined(AVR)
+		#define MAINS_SAMPLER_BUFFER_SIZE 128
+	#else
+		#define MAINS_SAMPLER_BUFFER_SIZE 256
+	#endif
+#endif
+
+#define MAINS_SAMPLER_DEFAULT_RATE 2000
+
+#if (MAINS_SAMPLER_BUFFER_SIZE & (MAINS_SAMPLER_BUFFER_SIZE - 1)) != 0
+	#error "MAINS_SAMPLER_BUFFER_SIZE must be a power of two"
+#endif
+
+/// Background acquisition of one or more analog inputs at a fixed rate.
+///
+/// On AVR, Timer1 triggers the ADC and the ADC interrupt stores the result,
+/// so sampling carries on while loop() is busy (Timer1 is then unavailable
+/// to Servo/TimerOne). On ESP32 (Arduino core 3.x) the ADC runs in
+/// continuous DMA mode and update() drains the driver buffer. Elsewhere
+/// update() falls back to polling analogRead() when a sample is due.
+///
+/// All channels of a frame are converted back to back, so frame n of the
+/// voltage channel and frame n of the current channel belong together.
+class MainsSampler
+{
+public:
+	bool     begin(uint8_t pin, uint16_t sampleRate = MAINS_SAMPLER_DEFAULT_RATE);
+	bool     begin(const uint8_t *pins, uint8_t count, uint16_t sampleRate = MAINS_SAMPLER_DEFAULT_RATE);
+	void     end();
+	void     update();
+
+	uint16_t getSampleRate() const { return sampleRate; }
+	uint8_t  getChannelCount() const { return channelCount; }
+	uint16_t samplesPerCycle(float frequency) const;
+
+	uint32_t getFrameCount();
+	uint32_t getOverrunCount();
+	uint16_t available();
+	uint16_t read(uint8_t channel, uint16_t *samples, uint16_t count);
+	uint16_t read(uint8_t channelA, uint16_t *samplesA, uint8_t channelB, uint16_t *samplesB, uint16_t count);
+
+	void     pushFrame(const uint16_t *values);
+
+private:
+	uint8_t  pins[MAINS_SAMPLER_MAX_CHANNELS];
+	uint8_t  channelCount = 0;
+	uint16_t sampleRate = 0;
+	bool     running = false;
+
+	volatile uint16_t buffer[MAINS_SAMPLER_BUFFER_SIZE][MAINS_SAMPLER_MAX_CHANNELS];
+	volatile uint16_t head = 0;
+	volatile uint32_t frames = 0;
+	volatile uint32_t overruns = 0;
+
+	uint32_t lastSample = 0;
+	uint32_t interval = 0;
+
+	bool     startHardware();
+	void     stopHardware();
+};
+
+#endif
@@ -30,6 +30,8 @@ NonBlockingDallas::NonBlockingDallas(DallasTemperature *dallasTemp)
 	_startConversionMillis = 0;
 	_conversionMillis = 0;
 	_currentState = notFound;
+	_autoRequest = true;
+	_validReadings = 0;
 	cb_onIntervalElapsed = NULL;
 	cb_onTemperatureChange = NULL;
 	for (int i = 0; i < ONE_WIRE_MAX_DEV; i++)
@@ -88,6 +90,8 @@ void NonBlockingDallas::begin(resolution res, unsigned long tempInterval)
 
 void NonBlockingDallas::waitNextReading()
 {
+	if (!_autoRequest)
+		return;
 	if (_lastReadingMillis != 0 && (millis() - _lastReadingMillis < _tempInterval - _conversionMillis))
 		return;
 	requestTemperature();
@@ -105,6 +109,7 @@ void NonBlockingDallas::waitConversion()
 
 void NonBlockingDallas::readSensors()
 {
+	_validReadings = 0;
 	for (int i = 0; i < _sensorsCount; i++)
 	{
 		readTemperatures(i);
@@ -125,6 +130,8 @@ void NonBlockingDallas::readTemperatures(int deviceIndex)
 		return;
 	}
 
+	_validReadings |= 1 << deviceIndex;
+
 	// Invoked only if reading is valid.
 	if (cb_onIntervalElapsed)
 		(*cb_onIntervalElapsed)(deviceIndex, rawTemp);
@@ -196,6 +203,18 @@ void NonBlockingDallas::requestTemperature()
 #endif
 }
 
+/**
+ * @brief Check if a requested reading is still in progress. With
+ * setAutoRequest(false) readings are only made on requestTemperature(), so a
+ * scheduler can decide when each bus is used.
+ *
+ * @return true from requestTemperature() until the sensors have been read
+ */
+bool NonBlockingDallas::isReading()
+{
+	return _currentState == waitingConversion || _currentState == readingSensor;
+}
+
 /**
  * @brief Functions below are extensions to the origninal NonBlockingDallas
  
@@ -233,6 +252,17 @@ bool NonBlockingDallas::indexExist(uint8_t deviceIndex)
 	return false;
 }
 
+/**
+ * @brief Check if the last readout of a sensor succeeded
+ *
+ * @return true if the sensor answered with a valid scratchpad
+ * @return false if it was disconnected or the CRC failed
+ */
+bool NonBlockingDallas::isLastReadingValid(uint8_t deviceIndex)
+{
+	return this->indexExist(deviceIndex) && (_validReadings & (1 << deviceIndex));
+}
+
 /**
  * @brief If exist index, copie address into DeviceAddress
  *
@@ -45,6 +45,8 @@ public:
 	void begin(resolution res, unsigned long tempInterval);
 	void update();
 	void requestTemperature();
+	void setAutoRequest(bool enabled) { _autoRequest = enabled; }
+	bool isReading();
 	void onIntervalElapsed(void (*callback)(int deviceIndex, int32_t temperatureRAW))
 	{
 		cb_onIntervalElapsed = callback;
@@ -65,6 +67,7 @@ public:
 	 */
 
 	bool indexExist(uint8_t deviceIndex);
+	bool isLastReadingValid(uint8_t deviceIndex);
 	bool getDeviceAddress(uint8_t deviceIndex, DeviceAddress deviceAddress);
 	String getAddressString(uint8_t deviceIndex);
 	int32_t getTemperatureRAW(uint8_t deviceIndex);
@@ -119,6 +122,8 @@ private:
 	unsigned long _lastReadingMillis;	  // Time at last temperature sensor readout
 	unsigned long _startConversionMillis; // Time at start conversion of the sensor
 	unsigned long _conversionMillis;	  // Sensor conversion time based on the resolution [milliseconds]
+	bool _autoRequest;					  // Request a new reading every _tempInterval
+	uint16_t _validReadings;			  // Bit per sensor, set if its last readout was valid
 
 	unsigned long _tempInterval;			 // Interval among each sensor reading [milliseconds]
 	int32_t _temperatures[ONE_WIRE_MAX_DEV]; // Array of last valid temperature raw values
@@ -37,6 +37,10 @@ definitions for newer hardware support are anticipated.
       thanks @everslick re:  https://github.com/espressif/arduino-esp32/issues/1335
   Altered by garyd9 for clean merge with Paul Stoffregen's source
 
+Version 2.4:
+  UART backend, interrupts stay enabled during bit slots
+  Overdrive speed: overdrive_skip(), overdrive_select(), set_overdrive()
+
 Version 2.3:
   Unknown chip fallback mode, Roger Clark
   Teensy-LC compatibility, Paul Stoffregen
@@ -159,16 +163,84 @@ sample code bearing this copyright.
 #endif
 
 
+// UART backend baud rates. The reset byte 0xF0 holds the bus low for 5
+// bits, a slot byte for 1 bit (0xFF: write 1 or read) or 9 bits (0x00:
+// write 0). Presence pulses and bits read as 0 show up as zeros in the
+// echo.
+#define UART_RESET_BAUD     9600     // 520us low, presence sampled up to 470us later
+#define UART_DATA_BAUD      115200   // 8.7us or 78us low, 87us slots
+#define UART_OD_RESET_BAUD  66667    // 75us low
+#define UART_OD_DATA_BAUD   1000000  // 1us or 9us low, 10us slots
+#define UART_ECHO_TIMEOUT   5000     // us, 8 slot bytes take 0.7ms
+
 void OneWire::begin(uint8_t pin)
 {
 	pinMode(pin, INPUT);
 	bitmask = PIN_TO_BITMASK(pin);
 	baseReg = PIN_TO_BASEREG(pin);
+	overdrive = false;
+#if ONEWIRE_UART
+	uart = NULL;
+#endif
 #if ONEWIRE_SEARCH
 	reset_search();
 #endif
 }
 
+#if ONEWIRE_UART
+static void uart_baud(HardwareSerial *serial, uint32_t baud)
+{
+	serial->flush();
+#if defined(ARDUINO_ARCH_ESP32)
+	serial->updateBaudRate(baud);	// begin() would reinstall the driver
+#else
+	serial->begin(baud);
+#endif
+}
+
+void OneWire::begin(HardwareSerial &serial)
+{
+	uart = &serial;
+	overdrive = false;
+	uart_baud(uart, UART_DATA_BAUD);
+#if ONEWIRE_SEARCH
+	reset_search();
+#endif
+}
+
+// Send count slot bytes and replace them with what came back on RX.
+// Returns false if the echo doesn't come (RX not wired to the bus).
+bool OneWire::uart_exchange(uint8_t *buf, uint8_t count)
+{
+	while (uart->available()) uart->read();
+	uart->write(buf, count);
+	unsigned long start = micros();
+	for (uint8_t i = 0; i < count; ) {
+		int c = uart->read();
+		if (c >= 0) {
+			buf[i++] = c;
+		} else if (micros() - start > UART_ECHO_TIMEOUT) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Write a byte as 8 slots, LSB first, and read back what the bus did:
+// a slot sent as 0xFF that a device pulled low reads as 0.
+uint8_t OneWire::uart_byte(uint8_t v)
+{
+	uint8_t slots[8];
+	for (uint8_t i = 0; i < 8; i++) slots[i] = (v >> i) & 1 ? 0xFF : 0x00;
+	if (!uart_exchange(slots, 8)) return 0xFF;
+	uint8_t r = 0;
+	for (uint8_t i = 0; i < 8; i++) {
+		if (slots[i] == 0xFF) r |= 1 << i;
+	}
+	return r;
+}
+#endif
+
 
 // Perform the onewire reset function.  We will wait up to 250uS for
 // the bus to come high, if it doesn't then it is broken or shorted
@@ -183,6 +255,16 @@ uint8_t CRIT_TIMING OneWire::reset(void)
 	uint8_t r;
 	uint8_t retries = 125;
 
+#if ONEWIRE_UART
+	if (uart) {
+		uint8_t echo = 0xF0;
+		uart_baud(uart, overdrive ? UART_OD_RESET_BAUD : UART_RESET_BAUD);
+		bool ok = uart_exchange(&echo, 1);
+		uart_baud(uart, overdrive ? UART_OD_DATA_BAUD : UART_DATA_BAUD);
+		// 0xF0: nobody answered, 0x00: the bus is held low
+		return ok && echo != 0xF0 && echo != 0x00;
+	}
+#endif
 	noInterrupts();
 	DIRECT_MODE_INPUT(reg, mask);
 	interrupts();
@@ -192,6 +274,19 @@ uint8_t CRIT_TIMING OneWire::reset(void)
 		delayMicroseconds(2);
 	} while ( !DIRECT_READ(reg, mask));
 
+	if (overdrive) {
+		noInterrupts();
+		DIRECT_WRITE_LOW(reg, mask);
+		DIRECT_MODE_OUTPUT(reg, mask);	// 70us, at most 80us
+		delayMicroseconds(70);
+		DIRECT_MODE_INPUT(reg, mask);
+		delayMicroseconds(8);
+		r = !DIRECT_READ(reg, mask);
+		interrupts();
+		delayMicroseconds(40);
+		return r;
+	}
+
 	noInterrupts();
 	DIRECT_WRITE_LOW(reg, mask);
 	DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
@@ -215,6 +310,24 @@ void CRIT_TIMING OneWire::write_bit(uint8_t v)
 	IO_REG_TYPE mask IO_REG_MASK_ATTR = bitmask;
 	__attribute__((unused)) volatile IO_REG_TYPE *reg IO_REG_BASE_ATTR = baseReg;
 
+#if ONEWIRE_UART
+	if (uart) {
+		uint8_t slot = (v & 1) ? 0xFF : 0x00;
+		uart_exchange(&slot, 1);
+		return;
+	}
+#endif
+	if (overdrive) {
+		noInterrupts();
+		DIRECT_WRITE_LOW(reg, mask);
+		DIRECT_MODE_OUTPUT(reg, mask);
+		delayMicroseconds((v & 1) ? 1 : 8);
+		DIRECT_WRITE_HIGH(reg, mask);
+		interrupts();
+		delayMicroseconds((v & 1) ? 8 : 3);
+		return;
+	}
+
 	if (v & 1) {
 		noInterrupts();
 		DIRECT_WRITE_LOW(reg, mask);
@@ -244,6 +357,26 @@ uint8_t CRIT_TIMING OneWire::read_bit(void)
 	__attribute__((unused)) volatile IO_REG_TYPE *reg IO_REG_BASE_ATTR = baseReg;
 	uint8_t r;
 
+#if ONEWIRE_UART
+	if (uart) {
+		uint8_t slot = 0xFF;
+		uart_exchange(&slot, 1);
+		return slot == 0xFF;
+	}
+#endif
+	if (overdrive) {
+		noInterrupts();
+		DIRECT_MODE_OUTPUT(reg, mask);
+		DIRECT_WRITE_LOW(reg, mask);
+		delayMicroseconds(1);
+		DIRECT_MODE_INPUT(reg, mask);
+		delayMicroseconds(1);
+		r = DIRECT_READ(reg, mask);
+		interrupts();
+		delayMicroseconds(7);
+		return r;
+	}
+
 	noInterrupts();
 	DIRECT_MODE_OUTPUT(reg, mask);
 	DIRECT_WRITE_LOW(reg, mask);
@@ -266,6 +399,13 @@ uint8_t CRIT_TIMING OneWire::read_bit(void)
 void OneWire::write(uint8_t v, uint8_t power /* = 0 */) {
     uint8_t bitMask;
 
+#if ONEWIRE_UART
+    if (uart) {
+	uart_byte(v);
+	return;
+    }
+#endif
+
     for (bitMask = 0x01; bitMask; bitMask <<= 1) {
 	OneWire::write_bit( (bitMask & v)?1:0);
     }
@@ -280,6 +420,9 @@ void OneWire::write(uint8_t v, uint8_t power /* = 0 */) {
 void OneWire::write_bytes(const uint8_t *buf, uint16_t count, bool power /* = 0 */) {
   for (uint16_t i = 0 ; i < count ; i++)
     write(buf[i]);
+#if ONEWIRE_UART
+  if (uart) return;
+#endif
   if (!power) {
     noInterrupts();
     DIRECT_MODE_INPUT(baseReg, bitmask);
@@ -295,6 +438,10 @@ uint8_t OneWire::read() {
     uint8_t bitMask;
     uint8_t r = 0;
 
+#if ONEWIRE_UART
+    if (uart) return uart_byte(0xFF);
+#endif
+
     for (bitMask = 0x01; bitMask; bitMask <<= 1) {
 	if ( OneWire::read_bit()) r |= bitMask;
     }
@@ -326,8 +473,36 @@ void OneWire::skip()
     write(0xCC);           // Skip ROM
 }
 
+//
+// Do an Overdrive Skip ROM or Overdrive Match ROM, at the speed the bus
+// is at, then go on at overdrive speed
+//
+void OneWire::overdrive_skip()
+{
+    write(0x3C);           // Overdrive Skip ROM
+    set_overdrive(true);
+}
+
+void OneWire::overdrive_select(const uint8_t rom[8])
+{
+    write(0x69);           // Overdrive Match ROM
+    set_overdrive(true);   // the ROM is sent at overdrive speed
+    for (uint8_t i = 0; i < 8; i++) write(rom[i]);
+}
+
+void OneWire::set_overdrive(bool on)
+{
+	overdrive = on;
+#if ONEWIRE_UART
+	if (uart) uart_baud(uart, on ? UART_OD_DATA_BAUD : UART_DATA_BAUD);
+#endif
+}
+
 void OneWire::depower()
 {
+#if ONEWIRE_UART
+	if (uart) return;
+#endif
 	noInterrupts();
 	DIRECT_MODE_INPUT(baseReg, bitmask);
 	interrupts();
@@ -51,6 +51,18 @@
 #define ONEWIRE_CRC16 1
 #endif
 
+// You can drive the bus from a hardware serial port instead of a pin
+// (see OneWire(HardwareSerial&) below). Define this to 0 to leave it out;
+// it defaults to 0 on boards without a hardware serial port.
+#ifndef ONEWIRE_UART
+#if defined(HAVE_HWSERIAL0) || defined(HAVE_HWSERIAL1) || defined(ARDUINO_ARCH_ESP32) || \
+    defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_SAMD) || defined(CORE_TEENSY)
+#define ONEWIRE_UART 1
+#else
+#define ONEWIRE_UART 0
+#endif
+#endif
+
 // Board-specific macros for direct GPIO
 #include "util/OneWire_direct_regtype.h"
 
@@ -59,6 +71,13 @@ class OneWire
   private:
     IO_REG_TYPE bitmask;
     volatile IO_REG_TYPE *baseReg;
+    bool overdrive;
+
+#if ONEWIRE_UART
+    HardwareSerial *uart;  // NULL when a pin drives the bus
+    bool uart_exchange(uint8_t *buf, uint8_t count);
+    uint8_t uart_byte(uint8_t v);
+#endif
 
 #if ONEWIRE_SEARCH
     // global search state
@@ -69,10 +88,36 @@ class OneWire
 #endif
 
   public:
-    OneWire() { }
+    OneWire() : overdrive(false)
+#if ONEWIRE_UART
+      , uart(NULL)
+#endif
+      { }
     OneWire(uint8_t pin) { begin(pin); }
     void begin(uint8_t pin);
 
+#if ONEWIRE_UART
+    // Drive the bus from a hardware serial port: RX straight to the bus,
+    // TX to the bus through an open-drain buffer (or a Schottky diode,
+    // cathode on TX), and the usual 4.7k pull-up. Every reset and bit slot
+    // is one byte timed by the UART, so interrupts are never disabled.
+    // A whole byte goes out as 8 slot bytes in one go. The 'power' flag
+    // of write() has no effect: the UART can't provide a strong pull-up
+    // for parasite powered devices.
+    // The constructor only keeps the port, so it can make a global; the
+    // first reset() sets the baud rate. begin() sets it at once and must
+    // be called from setup(). On boards where serial.begin() picks the
+    // pins (ESP32), call serial.begin(9600, SERIAL_8N1, rx, tx) before
+    // the first reset() or begin().
+    OneWire(HardwareSerial &serial) : overdrive(false), uart(&serial)
+    {
+#if ONEWIRE_SEARCH
+      reset_search();
+#endif
+    }
+    void begin(HardwareSerial &serial);
+#endif
+
     // Perform a 1-Wire reset cycle. Returns 1 if a device responds
     // with a presence pulse.  Returns 0 if there is no device or the
     // bus is shorted or otherwise held low for more than 250uS
@@ -111,6 +156,19 @@ class OneWire
     // someone shorts your bus.
     void depower(void);
 
+    // Overdrive speed, about 8 times faster than standard. Do the reset
+    // first, then overdrive_skip() switches every device that supports
+    // overdrive (DS28EA00, DS2431, DS2408 ...), or overdrive_select() one
+    // device, and the master with them. Devices without overdrive, like
+    // the DS18B20 and DS18S20, ignore everything until a standard speed
+    // reset. set_overdrive(false) goes back: the next reset() is a
+    // standard one and returns every device to standard speed. With the
+    // pin backend, overdrive needs a fast CPU; on 8-bit AVR use the UART.
+    void overdrive_skip(void);
+    void overdrive_select(const uint8_t rom[8]);
+    void set_overdrive(bool on);
+    bool get_overdrive(void) { return overdrive; }
+
 #if ONEWIRE_SEARCH
     // Clear the search state so that if will start from the beginning again.
     void reset_search();
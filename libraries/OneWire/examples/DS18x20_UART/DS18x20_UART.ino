@@ -0,0 +1,48 @@
+#include <OneWire.h>
+
+// OneWire DS18B20 on a UART, for an ESP32 with Wi-Fi running
+//
+// The UART times every bit slot, so interrupts are never disabled and
+// Wi-Fi isn't held up while the bus is busy.
+//
+// Wiring: GPIO16 (RX2) to the bus, GPIO17 (TX2) to the bus through a
+// Schottky diode (cathode on TX) or an open-drain buffer, 4.7K pull-up
+// from the bus to 3.3V. Parasite power is not possible this way.
+
+#define RX_PIN 16
+#define TX_PIN 17
+
+OneWire ds;          // begun in setup(), once Serial2 has its pins
+
+void setup(void) {
+  Serial.begin(115200);
+  Serial2.begin(9600, SERIAL_8N1, RX_PIN, TX_PIN);
+  ds.begin(Serial2);
+}
+
+void loop(void) {
+  byte data[9];
+
+  if (!ds.reset()) {
+    Serial.println("No device on the bus.");
+    delay(1000);
+    return;
+  }
+  ds.skip();           // a single DS18B20 on the bus
+  ds.write(0x44);      // start conversion
+  delay(750);
+
+  ds.reset();
+  ds.skip();
+  ds.write(0xBE);      // read scratchpad
+  ds.read_bytes(data, 9);
+  if (OneWire::crc8(data, 8) != data[8]) {
+    Serial.println("CRC is not valid!");
+    return;
+  }
+
+  int16_t raw = (data[1] << 8) | data[0];
+  Serial.print("Temperature = ");
+  Serial.print((float)raw / 16.0);
+  Serial.println(" Celsius");
+}
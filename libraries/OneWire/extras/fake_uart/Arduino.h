@@ -0,0 +1,28 @@
+// Just enough of Arduino.h to build OneWire on a PC with the UART backend.
+// micros() moves 10us per call, so the echo timeout runs out on its own.
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+
+#define ARDUINO 100
+#define INPUT 0
+#define OUTPUT 1
+#define LOW 0
+#define HIGH 1
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define HAVE_HWSERIAL0
+
+extern unsigned long fakeMicros;
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return 1; }
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline void delayMicroseconds(unsigned int) {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline unsigned long micros() { return fakeMicros += 10; }
+
+#include "FakeUart.h"
@@ -0,0 +1,114 @@
+// A HardwareSerial with TX and RX wired to a 1-Wire bus, and one device on
+// that bus. Every byte written comes back on RX as the bus saw it:
+//
+// * 0xF0 at the reset baud rate is a reset: 0xE0 when the device answers
+//   with a presence pulse, 0xF0 when nobody does
+// * any other byte is a slot: 0xFF is a 1 (or a read), 0x00 a 0, and a 0xFF
+//   slot the device pulls low to send a 0 comes back as 0xF8
+//
+// The device knows Read ROM, Skip ROM, Overdrive Skip ROM, Overdrive Match
+// ROM and Read Scratchpad, and only hears slots at its own speed: 1000000
+// baud once it went to overdrive, 115200 otherwise. A standard speed reset
+// puts it back.
+//
+// echo = false leaves RX silent (RX not wired), forceEcho >= 0 replaces
+// every echo (0x00 for a bus held low).
+
+#pragma once
+#include <deque>
+
+class HardwareSerial {
+public:
+	uint32_t baud = 0;      // last begin()
+	int begins = 0;
+	bool present = true;    // the device is on the bus
+	bool supportsOd = true; // it knows the overdrive ROM commands
+	bool devOd = false;     // it is in overdrive
+	bool echo = true;
+	int forceEcho = -1;
+	uint8_t rom[8] = { 0x42, 1, 2, 3, 4, 5, 6, 0 };
+	uint8_t pad[9] = { 0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0 };
+
+	void begin(uint32_t b) { baud = b; begins++; }
+	void flush() {}
+	int available() { return rx.size(); }
+	int read()
+	{
+		if (rx.empty()) return -1;
+		int c = rx.front();
+		rx.pop_front();
+		return c;
+	}
+	size_t write(const uint8_t *b, size_t n)
+	{
+		for (size_t i = 0; i < n; i++) {
+			uint8_t e = isReset(b[i]) ? resetPulse() : slot(b[i]);
+			if (forceEcho >= 0) e = forceEcho;
+			if (echo) rx.push_back(e);
+		}
+		return n;
+	}
+	size_t write(uint8_t c) { return write(&c, 1); }
+
+private:
+	std::deque<uint8_t> rx;
+	std::deque<uint8_t> out; // bits the device still has to send
+	bool active = false;     // reset seen, listening to ROM and function commands
+	int stage = 0;           // 0: ROM command, 1: function command, 2: Match ROM
+	uint8_t cmd = 0;
+	int bits = 0;
+	int matched = 0;
+
+	bool isReset(uint8_t b)
+	{
+		return b == 0xF0 && (baud == 9600 || baud == 66667);
+	}
+
+	uint8_t resetPulse()
+	{
+		if (baud == 9600) devOd = false;
+		if (!present || (baud == 66667 && !devOd)) return 0xF0;
+		active = true;
+		stage = 0;
+		cmd = 0;
+		bits = 0;
+		out.clear();
+		return 0xE0;
+	}
+
+	void send(const uint8_t *b, int n)
+	{
+		for (int i = 0; i < n; i++) {
+			for (int k = 0; k < 8; k++) out.push_back((b[i] >> k) & 1);
+		}
+	}
+
+	uint8_t slot(uint8_t b)
+	{
+		bool sameSpeed = (baud == 1000000) == devOd;
+		if (!present || !active || !sameSpeed) return b;
+		if (!out.empty()) {
+			uint8_t bit = out.front();
+			out.pop_front();
+			return (b == 0xFF && bit == 0) ? 0xF8 : b;
+		}
+		cmd |= (b == 0xFF) << bits;
+		if (++bits < 8) return b;
+		uint8_t c = cmd;
+		cmd = 0;
+		bits = 0;
+		if (stage == 0) {
+			if (c == 0x33) { send(rom, 8); stage = 1; }
+			else if (c == 0xCC) stage = 1;
+			else if (c == 0x3C && supportsOd) { devOd = true; stage = 1; }
+			else if (c == 0x69 && supportsOd) { devOd = true; stage = 2; matched = 0; }
+			else active = false;
+		} else if (stage == 2) {
+			if (c != rom[matched]) active = false;
+			if (++matched == 8) stage = 1;
+		} else if (c == 0xBE) {
+			send(pad, 9);
+		}
+		return b;
+	}
+};
@@ -0,0 +1,10 @@
+#!/bin/sh
+# Builds OneWire with the UART backend against the fake UART and runs the
+# checks.
+set -e
+cd "$(dirname "$0")"
+status=0
+g++ -O2 -Wall -I. -o test_uart test_uart.cpp ../../OneWire.cpp
+./test_uart || status=$?
+rm -f test_uart
+exit $status
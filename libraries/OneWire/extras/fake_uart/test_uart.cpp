@@ -0,0 +1,131 @@
+// Runs the OneWire UART backend against FakeUart: the reset and slot
+// echoes, and the baud rate switching for overdrive.
+
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "Check.h"
+#include "../../OneWire.h"
+
+unsigned long fakeMicros = 0;
+
+static void setup(HardwareSerial &serial)
+{
+	serial.rom[7] = OneWire::crc8(serial.rom, 7);
+	serial.pad[8] = OneWire::crc8(serial.pad, 8);
+}
+
+static void resetEcho()
+{
+	printf("reset echo\n");
+	HardwareSerial serial;
+	setup(serial);
+	OneWire ow(serial);
+	CHECK(serial.baud == 0);  // the constructor leaves the port alone
+	CHECK(ow.reset() == 1);   // 0xE0, presence
+	CHECK(serial.baud == 115200);
+	serial.present = false;
+	CHECK(ow.reset() == 0);   // 0xF0, nobody answered
+	serial.present = true;
+	serial.forceEcho = 0x00;
+	CHECK(ow.reset() == 0);   // bus held low
+	serial.forceEcho = 0x10;
+	CHECK(ow.reset() == 1);   // a long presence pulse
+	serial.forceEcho = -1;
+	serial.echo = false;
+	CHECK(ow.reset() == 0);   // RX not wired, timed out
+	CHECK(ow.read() == 0xFF);
+}
+
+static void slotEcho()
+{
+	printf("slot echo to bits\n");
+	HardwareSerial serial;
+	OneWire ow(serial);
+	serial.forceEcho = 0xFF;
+	CHECK(ow.read_bit() == 1);
+	serial.forceEcho = 0xF8;
+	CHECK(ow.read_bit() == 0);  // pulled low by a device
+	serial.forceEcho = 0xFE;
+	CHECK(ow.read_bit() == 0);  // pulled low late in the slot
+	serial.forceEcho = 0x00;
+	CHECK(ow.read_bit() == 0);
+	serial.forceEcho = 0xFF;
+	CHECK(ow.read() == 0xFF);
+	serial.forceEcho = 0xF8;
+	CHECK(ow.read() == 0x00);
+}
+
+static void readRom()
+{
+	printf("read ROM and scratchpad\n");
+	HardwareSerial serial;
+	setup(serial);
+	OneWire ow;
+	ow.begin(serial);
+	CHECK(serial.baud == 115200);
+	CHECK(ow.reset());
+	ow.write(0x33);
+	uint8_t rom[8];
+	ow.read_bytes(rom, 8);
+	CHECK(memcmp(rom, serial.rom, 8) == 0);
+
+	CHECK(ow.reset());
+	ow.write(0xCC);
+	for (int i = 0; i < 8; i++) ow.write_bit((0xBE >> i) & 1);
+	uint8_t b = 0;
+	for (int i = 0; i < 8; i++) b |= ow.read_bit() << i;
+	CHECK(b == 0x50);
+}
+
+static void overdrive()
+{
+	printf("overdrive baud rates\n");
+	HardwareSerial serial;
+	setup(serial);
+	OneWire ow(serial);
+	CHECK(!ow.get_overdrive());
+	CHECK(ow.reset());
+	ow.overdrive_skip();
+	CHECK(ow.get_overdrive());
+	CHECK(serial.baud == 1000000 && serial.devOd);
+	ow.write(0xBE);
+	uint8_t pad[9];
+	ow.read_bytes(pad, 9);
+	CHECK(pad[0] == 0x50 && OneWire::crc8(pad, 8) == pad[8]);
+
+	int begins = serial.begins;
+	CHECK(ow.reset());  // at 66667 baud, the device stays in overdrive
+	CHECK(serial.begins == begins + 2 && serial.baud == 1000000);
+	CHECK(serial.devOd);
+	ow.write(0xCC);
+	ow.write(0xBE);
+	CHECK(ow.read() == 0x50);
+
+	ow.set_overdrive(false);
+	CHECK(serial.baud == 115200);
+	CHECK(ow.reset());  // at 9600 baud, back to standard speed
+	CHECK(!serial.devOd);
+	ow.overdrive_select(serial.rom);
+	CHECK(serial.devOd);
+	ow.write(0xBE);
+	CHECK(ow.read() == 0x50);
+
+	ow.set_overdrive(false);
+	serial.supportsOd = false;
+	CHECK(ow.reset());
+	ow.overdrive_skip();
+	CHECK(!ow.reset());  // no overdrive presence pulse
+	ow.set_overdrive(false);
+	CHECK(ow.reset());
+}
+
+int main()
+{
+	resetEcho();
+	slotEcho();
+	readRom();
+	overdrive();
+	printf("%d checks, %d failed\n", checks, failures);
+	return failures ? 1 : 0;
+}
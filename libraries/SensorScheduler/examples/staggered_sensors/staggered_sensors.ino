@@ -0,0 +1,59 @@
+#include <OneWire.h>
+#include <DallasTemperature.h>
+#include <NonBlockingDallas.h>
+#include <DHT.h>
+#include <SensorScheduler.h>
+
+// Use pins that support attachInterrupt() for the DHTs
+DHT dht1(2, DHT11);
+DHT dht2(3, DHT22);
+
+OneWire oneWire(4);
+DallasTemperature dallasTemp(&oneWire);
+NonBlockingDallas water(&dallasTemp);
+
+SensorScheduler scheduler(5000);
+
+unsigned long lastPrint = 0;
+
+void setup() {
+  Serial.begin(9600);
+
+  dht1.begin();
+  dht2.begin();
+  water.begin(NonBlockingDallas::resolution_12, 5000);
+
+  scheduler.add(dht1);
+  scheduler.add(dht2);
+  scheduler.add(water);
+  scheduler.begin();
+}
+
+void loop() {
+  scheduler.update();
+
+  if (millis() - lastPrint >= 5000) {
+    lastPrint = millis();
+
+    for (uint8_t i = 0; i < scheduler.getCount(); i++) {
+      const SensorStats &stats = scheduler.getStats(i);
+
+      Serial.print(F("Sensor "));
+      Serial.print(i);
+      Serial.print(F(": "));
+      Serial.print(scheduler.getTemperature(i));
+      Serial.print(F(" C "));
+      Serial.print(scheduler.getHumidity(i));
+      Serial.print(F(" %  age "));
+      Serial.print(scheduler.getAge(i));
+      Serial.print(F(" ms  latency "));
+      Serial.print(stats.lastLatency);
+      Serial.print(F("/"));
+      Serial.print(stats.maxLatency);
+      Serial.print(F(" ms  ok "));
+      Serial.print(stats.readings);
+      Serial.print(F("  failed "));
+      Serial.println(stats.failures);
+    }
+  }
+}
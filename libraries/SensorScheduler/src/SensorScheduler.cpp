@@ -0,0 +1,232 @@
+#include "SensorScheduler.h"
+
+/// @brief SensorScheduler constructor
+/// @param interval default time between two readings of each sensor
+SensorScheduler::SensorScheduler(uint32_t interval)
+	: interval(interval)
+{
+}
+
+/// @brief Add a DHT sensor. Call its begin() as usual.
+/// @return index of the sensor, -1 if the scheduler is full
+int8_t SensorScheduler::add(DHT &dht)
+{
+	int8_t index = addSensor();
+	if (index >= 0)
+	{
+		sensors[index].dht = &dht;
+		setInterval(index, interval);
+	}
+	return index;
+}
+
+/// @brief Add a DS18B20 bus. Call its begin() as usual; its own interval is
+/// replaced by the scheduler's.
+/// @return index of the sensor, -1 if the scheduler is full
+int8_t SensorScheduler::add(NonBlockingDallas &dallas)
+{
+	int8_t index = addSensor();
+	if (index >= 0)
+	{
+		sensors[index].dallas = &dallas;
+		dallas.setAutoRequest(false);
+		setInterval(index, interval);
+	}
+	return index;
+}
+
+int8_t SensorScheduler::addSensor()
+{
+	if (count >= SENSOR_SCHEDULER_MAX)
+		return -1;
+	sensors[count] = Sensor();
+	return count++;
+}
+
+/// @brief Change how often one sensor is read. DHTs are read at most every
+/// two seconds.
+/// @param sensor index returned by add()
+/// @param milliseconds time between two readings
+void SensorScheduler::setInterval(uint8_t sensor, uint32_t milliseconds)
+{
+	if (sensor >= count)
+		return;
+	if (sensors[sensor].dht && milliseconds < SENSOR_SCHEDULER_DHT_MIN_INTERVAL)
+		milliseconds = SENSOR_SCHEDULER_DHT_MIN_INTERVAL;
+	sensors[sensor].interval = milliseconds;
+}
+
+/// @brief Spread the first readings over the interval. Call it in setup()
+/// after adding the sensors.
+void SensorScheduler::begin()
+{
+	uint32_t now = millis();
+	for (uint8_t i = 0; i < count; i++)
+		sensors[i].due = now + sensors[i].interval / count * i;
+	active = -1;
+}
+
+/// @brief Advance the sensor being read or start the next one that is due.
+/// Call it from loop().
+void SensorScheduler::update()
+{
+	uint32_t now = millis();
+
+	if (active >= 0)
+	{
+		bool ok = false;
+		if (!poll(sensors[active], ok))
+			return;
+		finish(sensors[active], ok);
+		active = -1;
+	}
+
+	// Start the most overdue sensor, if any is due.
+	int8_t next = -1;
+	uint32_t late = 0;
+	for (uint8_t i = 0; i < count; i++)
+	{
+		int32_t overdue = now - sensors[i].due;
+		if (overdue >= 0 && (next < 0 || (uint32_t)overdue > late))
+		{
+			next = i;
+			late = overdue;
+		}
+	}
+	if (next >= 0)
+		start(next);
+}
+
+void SensorScheduler::start(uint8_t index)
+{
+	Sensor &sensor = sensors[index];
+
+	started = millis();
+	// Next reading one interval after this one started, or right away if
+	// the sensor fell more than an interval behind.
+	sensor.due += sensor.interval;
+	if ((int32_t)(started - sensor.due) > 0)
+		sensor.due = started;
+
+	if (sensor.dht)
+	{
+		// The scheduler keeps the DHT's two second pause itself.
+		if (!sensor.dht->startRead(true))
+		{
+			finish(sensor, false);
+			return;
+		}
+	}
+	else
+	{
+		if (sensor.dallas->getSensorsCount() == 0)
+		{
+			finish(sensor, false);
+			return;
+		}
+		sensor.dallas->requestTemperature();
+	}
+	active = index;
+}
+
+/// @return true once the reading is complete, with ok set if it succeeded
+bool SensorScheduler::poll(Sensor &sensor, bool &ok)
+{
+	if (sensor.dht)
+	{
+		uint8_t result = sensor.dht->poll();
+		if (result == DHT_READ_BUSY)
+			return false;
+		ok = result == DHT_READ_OK;
+		if (ok)
+		{
+			// These return what poll() just received.
+			sensor.temperature = sensor.dht->readTemperature();
+			sensor.humidity = sensor.dht->readHumidity();
+		}
+		return true;
+	}
+
+	sensor.dallas->update();
+	if (sensor.dallas->isReading())
+	{
+		// A conversion that never completes must not block the others.
+		if (millis() - started < SENSOR_SCHEDULER_TIMEOUT)
+			return false;
+		ok = false;
+		return true;
+	}
+
+	uint8_t devices = sensor.dallas->getSensorsCount();
+	ok = devices > 0;
+	for (uint8_t d = 0; d < devices; d++)
+		ok &= sensor.dallas->isLastReadingValid(d);
+	if (sensor.dallas->isLastReadingValid(0))
+		sensor.temperature = sensor.dallas->getTemperatureC((uint8_t)0);
+	return true;
+}
+
+void SensorScheduler::finish(Sensor &sensor, bool ok)
+{
+	uint32_t now = millis();
+	SensorStats &stats = sensor.stats;
+
+	uint32_t latency = now - started;
+	stats.lastLatency = latency > 0xFFFF ? 0xFFFF : latency;
+	if (stats.lastLatency > stats.maxLatency)
+		stats.maxLatency = stats.lastLatency;
+
+	if (ok)
+	{
+		sensor.valid = true;
+		stats.readings++;
+		stats.consecutiveFailures = 0;
+		stats.lastReading = now;
+	}
+	else
+	{
+		stats.failures++;
+		stats.consecutiveFailures++;
+	}
+}
+
+/// @brief Check if a sensor has been read successfully at least once
+bool SensorScheduler::hasValue(uint8_t sensor) const
+{
+	return sensor < count && sensors[sensor].valid;
+}
+
+/// @brief Time since the last good reading of a sensor
+/// @return milliseconds, 0xFFFFFFFF if it was never read
+uint32_t SensorScheduler::getAge(uint8_t sensor) const
+{
+	if (!hasValue(sensor))
+		return 0xFFFFFFFF;
+	return millis() - sensors[sensor].stats.lastReading;
+}
+
+/// @brief Latest good temperature of a sensor
+/// @param sensor index returned by add()
+/// @param device device on a DS18B20 bus, ignored for a DHT
+/// @return degrees Celsius, NAN if the sensor was never read
+float SensorScheduler::getTemperature(uint8_t sensor, uint8_t device)
+{
+	if (!hasValue(sensor))
+		return NAN;
+	if (sensors[sensor].dallas && device > 0)
+	{
+		if (!sensors[sensor].dallas->indexExist(device))
+			return NAN;
+		return sensors[sensor].dallas->getTemperatureC(device);
+	}
+	return sensors[sensor].temperature;
+}
+
+/// @brief Latest good humidity of a DHT sensor
+/// @return percent, NAN for a DS18B20 bus or if the sensor was never read
+float SensorScheduler::getHumidity(uint8_t sensor) const
+{
+	if (!hasValue(sensor))
+		return NAN;
+	return sensors[sensor].humidity;
+}
@@ -0,0 +1,85 @@
+#ifndef SensorScheduler_h
+#define SensorScheduler_h
+
+#include <Arduino.h>
+#include <DHT.h>
+#include <NonBlockingDallas.h>
+
+// Number of sensors (DHTs or DS18B20 buses) a scheduler can hold.
+#ifndef SENSOR_SCHEDULER_MAX
+	#define SENSOR_SCHEDULER_MAX 8
+#endif
+
+#define SENSOR_SCHEDULER_DEFAULT_INTERVAL 5000UL
+#define SENSOR_SCHEDULER_TIMEOUT 2000UL
+#define SENSOR_SCHEDULER_DHT_MIN_INTERVAL 2000UL
+
+/// Counters of one sensor, all in milliseconds where they are times.
+struct SensorStats
+{
+	uint32_t readings = 0;
+	uint32_t failures = 0;
+	uint32_t consecutiveFailures = 0;
+	uint16_t lastLatency = 0;
+	uint16_t maxLatency = 0;
+	uint32_t lastReading = 0;
+};
+
+/// Reads several DHT sensors and DS18B20 buses in turn, never two at once.
+///
+/// Each sensor is read every interval, with the first readings spread
+/// evenly over the interval so they do not pile up. When several sensors are
+/// due at the same time the most overdue one goes first. DHTs are read with
+/// DHT::startRead()/poll() and DS18B20 buses with NonBlockingDallas in
+/// manual mode, so update() never waits for a sensor. The latest good values
+/// are kept, so getTemperature() and getHumidity() can be called as often as
+/// needed without touching a sensor.
+///
+/// A DS18B20 bus counts as one sensor: all its devices convert together and
+/// a reading fails if any of them does not answer.
+class SensorScheduler
+{
+public:
+	SensorScheduler(uint32_t interval = SENSOR_SCHEDULER_DEFAULT_INTERVAL);
+
+	int8_t   add(DHT &dht);
+	int8_t   add(NonBlockingDallas &dallas);
+	void     setInterval(uint8_t sensor, uint32_t milliseconds);
+
+	void     begin();
+	void     update();
+
+	uint8_t  getCount() const { return count; }
+	bool     isBusy() const { return active >= 0; }
+	bool     hasValue(uint8_t sensor) const;
+	uint32_t getAge(uint8_t sensor) const;
+	float    getTemperature(uint8_t sensor, uint8_t device = 0);
+	float    getHumidity(uint8_t sensor) const;
+	const SensorStats &getStats(uint8_t sensor) const { return sensors[sensor < count ? sensor : 0].stats; }
+
+private:
+	struct Sensor
+	{
+		DHT *dht = NULL;
+		NonBlockingDallas *dallas = NULL;
+		uint32_t interval = 0;
+		uint32_t due = 0;
+		float temperature = NAN;
+		float humidity = NAN;
+		bool valid = false;          // read successfully at least once
+		SensorStats stats;
+	};
+
+	Sensor   sensors[SENSOR_SCHEDULER_MAX];
+	uint8_t  count = 0;
+	int8_t   active = -1;
+	uint32_t started = 0;
+	uint32_t interval;
+
+	int8_t   addSensor();
+	void     start(uint8_t index);
+	bool     poll(Sensor &sensor, bool &ok);
+	void     finish(Sensor &sensor, bool ok);
+};
+
+#endif
@@ -0,0 +1,114 @@
+/*
+  MAX30105 Breakout: Read the whole FIFO in bursts while the sketch is busy
+
+  Example8 calls check() for every sample, so the sketch can't do anything
+  else for long. Here the sensor runs at 25 samples per second (100Hz with 4
+  sample averaging), its 32 sample FIFO lasts 1.28 seconds, and loop() spends
+  most of that time on something else (a stand-in for network I/O).
+  readFIFO() then drains everything that came in straight into the SpO2
+  buffers, in as few I2C transactions as the Wire buffer allows.
+
+  getSamplesDrained() tells how many samples the last read returned and
+  getOverflowCount() how many were lost because the FIFO was full; make
+  the busy time longer than 1.28 seconds to see it count.
+
+  Hardware Connections (Breakoutboard to Arduino):
+  -5V = 5V (3.3V is allowed)
+  -GND = GND
+  -SDA = A4 (or SDA)
+  -SCL = A5 (or SCL)
+  -INT = Not connected
+
+  This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+*/
+
+#include <Wire.h>
+#include "MAX30105.h"
+#include "spo2_algorithm.h"
+
+MAX30105 particleSensor;
+
+#define SAMPLES 100 //4 seconds at 25 samples per second
+#define NEW_SAMPLES 25 //Recalculate once per second
+#define BUSY_TIME 1000 //ms spent elsewhere on every loop, keep it below 1280
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+//Not enough SRAM for 32-bit samples on the Uno, see Example8
+uint16_t irBuffer[SAMPLES];
+uint16_t redBuffer[SAMPLES];
+#else
+uint32_t irBuffer[SAMPLES];
+uint32_t redBuffer[SAMPLES];
+#endif
+
+int fill = 0; //Samples in the buffers
+int newSamples = 0; //Samples since the last calculation
+
+int32_t spo2;
+int8_t validSPO2;
+int32_t heartRate;
+int8_t validHeartRate;
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("Initializing...");
+
+  if (particleSensor.begin(Wire, I2C_SPEED_FAST) == false) //Use default I2C port, 400kHz speed
+  {
+    Serial.println("MAX30105 was not found. Please check wiring/power. ");
+    while (1);
+  }
+
+  byte ledBrightness = 60; //Options: 0=Off to 255=50mA
+  byte sampleAverage = 4; //Options: 1, 2, 4, 8, 16, 32
+  byte ledMode = 2; //Options: 1 = Red only, 2 = Red + IR, 3 = Red + IR + Green
+  int sampleRate = 100; //Options: 50, 100, 200, 400, 800, 1000, 1600, 3200
+  int pulseWidth = 411; //Options: 69, 118, 215, 411
+  int adcRange = 4096; //Options: 2048, 4096, 8192, 16384
+
+  particleSensor.setup(ledBrightness, sampleAverage, ledMode, sampleRate, pulseWidth, adcRange); //Configure sensor with these settings
+}
+
+void loop()
+{
+  //Make room for a full FIFO by dropping the oldest samples
+  if (fill > SAMPLES - MAX30105_FIFO_DEPTH)
+  {
+    int drop = fill - (SAMPLES - MAX30105_FIFO_DEPTH);
+    for (int i = drop; i < fill; i++)
+    {
+      redBuffer[i - drop] = redBuffer[i];
+      irBuffer[i - drop] = irBuffer[i];
+    }
+    fill -= drop;
+  }
+
+  //Everything that came in since the last loop, in one go
+  fill += particleSensor.readFIFO(redBuffer + fill, irBuffer + fill, NULL, SAMPLES - fill);
+  newSamples += particleSensor.getSamplesDrained();
+
+  Serial.print("Drained[");
+  Serial.print(particleSensor.getSamplesDrained());
+  Serial.print("] Lost[");
+  Serial.print(particleSensor.getOverflowCount());
+  Serial.print("]");
+
+  if (fill == SAMPLES && newSamples >= NEW_SAMPLES)
+  {
+    maxim_heart_rate_and_oxygen_saturation(irBuffer, SAMPLES, redBuffer, &spo2, &validSPO2, &heartRate, &validHeartRate);
+    newSamples = 0;
+  }
+
+  Serial.print(" HR[");
+  Serial.print(heartRate, DEC);
+  Serial.print("] HRvalid[");
+  Serial.print(validHeartRate, DEC);
+  Serial.print("] SPO2[");
+  Serial.print(spo2, DEC);
+  Serial.print("] SPO2Valid[");
+  Serial.print(validSPO2, DEC);
+  Serial.println("]");
+
+  delay(BUSY_TIME); //Network I/O, display updates...
+}
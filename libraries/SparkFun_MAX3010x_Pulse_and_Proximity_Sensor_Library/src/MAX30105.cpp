@@ -137,6 +137,8 @@ static const uint8_t MAX_30105_EXPECTEDPARTID = 0x15;
 
 MAX30105::MAX30105() {
   // Constructor
+  samplesDrained = 0;
+  overflowCount = 0;
 }
 
 boolean MAX30105::begin(TwoWire &wirePort, uint32_t i2cSpeed, uint8_t i2caddr) {
@@ -158,6 +160,8 @@ boolean MAX30105::begin(TwoWire &wirePort, uint32_t i2cSpeed, uint8_t i2caddr) {
 
   // Populate revision ID
   readRevisionID();
+
+  overflowCount = 0;
   
   return true;
 }
@@ -594,17 +598,16 @@ uint16_t MAX30105::check(void)
   //Read register FIDO_DATA in (3-byte * number of active LED) chunks
   //Until FIFO_RD_PTR = FIFO_WR_PTR
 
-  byte readPointer = getReadPointer();
-  byte writePointer = getWritePointer();
+  uint8_t overflow;
+  int numberOfSamples = readFIFOPointers(overflow);
 
-  int numberOfSamples = 0;
+  samplesDrained = 0;
 
   //Do we have new data?
-  if (readPointer != writePointer)
+  if (numberOfSamples > 0)
   {
-    //Calculate the number of readings we need to get from sensor
-    numberOfSamples = writePointer - readPointer;
-    if (numberOfSamples < 0) numberOfSamples += 32; //Wrap condition
+    //The sensor clears its overflow counter once we pop a sample
+    overflowCount += overflow;
 
     //We now have the number of readings, now calc bytes to read
     //For this example we are just doing Red and IR (3 bytes each)
@@ -640,62 +643,158 @@ uint16_t MAX30105::check(void)
         sense.head++; //Advance the head of the storage struct
         sense.head %= STORAGE_SIZE; //Wrap condition
 
-        byte temp[sizeof(uint32_t)]; //Array of 4 bytes that we will convert into long
-        uint32_t tempLong;
+        sense.red[sense.head] = readFIFOValue(); //Store this reading into the sense array
 
-        //Burst read three bytes - RED
-        temp[3] = 0;
-        temp[2] = _i2cPort->read();
-        temp[1] = _i2cPort->read();
-        temp[0] = _i2cPort->read();
+        if (activeLEDs > 1)
+          sense.IR[sense.head] = readFIFOValue();
 
-        //Convert array to long
-        memcpy(&tempLong, temp, sizeof(tempLong));
-		
-		tempLong &= 0x3FFFF; //Zero out all but 18 bits
+        if (activeLEDs > 2)
+          sense.green[sense.head] = readFIFOValue();
 
-        sense.red[sense.head] = tempLong; //Store this reading into the sense array
+        toGet -= activeLEDs * 3;
+      }
 
-        if (activeLEDs > 1)
-        {
-          //Burst read three more bytes - IR
-          temp[3] = 0;
-          temp[2] = _i2cPort->read();
-          temp[1] = _i2cPort->read();
-          temp[0] = _i2cPort->read();
+    } //End while (bytesLeftToRead > 0)
 
-          //Convert array to long
-          memcpy(&tempLong, temp, sizeof(tempLong));
+    samplesDrained = numberOfSamples;
 
-		  tempLong &= 0x3FFFF; //Zero out all but 18 bits
-          
-		  sense.IR[sense.head] = tempLong;
-        }
+  } //End readPtr != writePtr
 
-        if (activeLEDs > 2)
-        {
-          //Burst read three more bytes - Green
-          temp[3] = 0;
-          temp[2] = _i2cPort->read();
-          temp[1] = _i2cPort->read();
-          temp[0] = _i2cPort->read();
+  return (numberOfSamples); //Let the world know how much new data we found
+}
 
-          //Convert array to long
-          memcpy(&tempLong, temp, sizeof(tempLong));
+//Reads the write pointer, overflow counter and read pointer in one burst
+//Returns the number of samples waiting in the FIFO
+uint8_t MAX30105::readFIFOPointers(uint8_t &overflow)
+{
+  overflow = 0;
 
-		  tempLong &= 0x3FFFF; //Zero out all but 18 bits
+  //The three registers are adjacent, FIFO_WR_PTR first
+  _i2cPort->beginTransmission(_i2caddr);
+  _i2cPort->write(MAX30105_FIFOWRITEPTR);
+  _i2cPort->endTransmission(false);
 
-          sense.green[sense.head] = tempLong;
-        }
+  _i2cPort->requestFrom((uint8_t)_i2caddr, (uint8_t)3);
+  if (_i2cPort->available() < 3)
+    return (0); //Fail
 
-        toGet -= activeLEDs * 3;
+  byte writePointer = _i2cPort->read();
+  overflow = _i2cPort->read();
+  byte readPointer = _i2cPort->read();
+
+  uint8_t numberOfSamples = (writePointer - readPointer) & (MAX30105_FIFO_DEPTH - 1); //Wrap condition
+
+  //The pointers are equal both when the FIFO is empty and when it is full
+  //A full FIFO has lost samples, which the overflow counter tells
+  if (numberOfSamples == 0 && overflow > 0)
+    numberOfSamples = MAX30105_FIFO_DEPTH;
+
+  return (numberOfSamples);
+}
+
+//Reads the next three bytes of a FIFO burst
+uint32_t MAX30105::readFIFOValue(void)
+{
+  byte temp[sizeof(uint32_t)]; //Array of 4 bytes that we will convert into long
+  uint32_t tempLong;
+
+  temp[3] = 0;
+  temp[2] = _i2cPort->read();
+  temp[1] = _i2cPort->read();
+  temp[0] = _i2cPort->read();
+
+  //Convert array to long
+  memcpy(&tempLong, temp, sizeof(tempLong));
+
+  tempLong &= 0x3FFFF; //Zero out all but 18 bits
+
+  return (tempLong);
+}
+
+//Drains up to maxSamples samples from the FIFO straight into the caller's buffers,
+//so a sketch can read the whole FIFO (32 samples) in one go instead of calling check()
+//for every sample. Pass NULL for a channel you don't need.
+//The data comes in as few I2C transactions as the Wire buffer allows:
+//two for 32 samples of Red+IR on an ESP32, seven on an Uno.
+//Returns the number of samples read, see getOverflowCount() for the ones lost
+uint8_t MAX30105::readFIFO(uint32_t *redBuffer, uint32_t *irBuffer, uint32_t *greenBuffer, uint8_t maxSamples)
+{
+  return (readFIFOBurst(redBuffer, irBuffer, greenBuffer, maxSamples, sizeof(uint32_t)));
+}
+
+//Same as above for the 16 bit buffers maxim_heart_rate_and_oxygen_saturation() takes on the Uno
+//Like Example8, only the lower 16 bits of each value are kept
+uint8_t MAX30105::readFIFO(uint16_t *redBuffer, uint16_t *irBuffer, uint16_t *greenBuffer, uint8_t maxSamples)
+{
+  return (readFIFOBurst(redBuffer, irBuffer, greenBuffer, maxSamples, sizeof(uint16_t)));
+}
+
+uint8_t MAX30105::readFIFOBurst(void *redBuffer, void *irBuffer, void *greenBuffer, uint8_t maxSamples, uint8_t valueSize)
+{
+  uint8_t overflow;
+  uint8_t numberOfSamples = readFIFOPointers(overflow);
+
+  samplesDrained = 0;
+
+  if (numberOfSamples > maxSamples) numberOfSamples = maxSamples;
+  if (numberOfSamples == 0 || activeLEDs == 0) return (0); //Nothing to read, or setup() not called
+
+  //The sensor clears its overflow counter once we pop a sample
+  overflowCount += overflow;
+
+  void *buffers[3] = {redBuffer, irBuffer, greenBuffer};
+  uint8_t bytesPerSample = activeLEDs * 3;
+  uint8_t samplesPerRead = I2C_BUFFER_LENGTH / bytesPerSample;
+
+  while (samplesDrained < numberOfSamples)
+  {
+    uint8_t toGet = numberOfSamples - samplesDrained;
+    if (toGet > samplesPerRead) toGet = samplesPerRead;
+
+    //Each read starts at FIFO_DATA, which does not auto increment
+    _i2cPort->beginTransmission(_i2caddr);
+    _i2cPort->write(MAX30105_FIFODATA);
+    _i2cPort->endTransmission(false);
+
+    _i2cPort->requestFrom((uint8_t)_i2caddr, (uint8_t)(toGet * bytesPerSample));
+    if (_i2cPort->available() < toGet * bytesPerSample)
+      break; //Fail, keep what we have
+
+    for (uint8_t x = 0 ; x < toGet ; x++)
+    {
+      for (uint8_t led = 0 ; led < activeLEDs ; led++)
+      {
+        uint32_t value = readFIFOValue();
+
+        if (buffers[led] == NULL) continue;
+        if (valueSize == sizeof(uint32_t))
+          ((uint32_t *)buffers[led])[samplesDrained] = value;
+        else
+          ((uint16_t *)buffers[led])[samplesDrained] = value;
       }
+      samplesDrained++;
+    }
+  }
 
-    } //End while (bytesLeftToRead > 0)
+  return (samplesDrained);
+}
 
-  } //End readPtr != writePtr
+//Number of samples read from the FIFO by the last check() or readFIFO()
+uint8_t MAX30105::getSamplesDrained(void)
+{
+  return (samplesDrained);
+}
 
-  return (numberOfSamples); //Let the world know how much new data we found
+//Samples the sensor dropped since begin() because the FIFO was full
+//Read the FIFO more often, or use a lower sample rate or more sample averaging
+uint32_t MAX30105::getOverflowCount(void)
+{
+  return (overflowCount);
+}
+
+void MAX30105::clearOverflowCount(void)
+{
+  overflowCount = 0;
 }
 
 //Check for new data but give up after a certain amount of time
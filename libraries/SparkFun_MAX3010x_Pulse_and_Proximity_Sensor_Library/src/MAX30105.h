@@ -25,6 +25,8 @@
 #define I2C_SPEED_STANDARD        100000
 #define I2C_SPEED_FAST            400000
 
+#define MAX30105_FIFO_DEPTH       32 //Samples the sensor FIFO holds
+
 //Define the size of the I2C buffer based on the platform the user has
 #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
 
@@ -36,6 +38,15 @@
   //SAMD21 uses RingBuffer.h
   #define I2C_BUFFER_LENGTH SERIAL_BUFFER_SIZE
 
+#elif defined(I2C_BUFFER_LENGTH)
+
+  //ESP32 defines I2C_BUFFER_LENGTH in Wire.h
+
+#elif defined(BUFFER_LENGTH)
+
+  //ESP8266 and others define BUFFER_LENGTH in Wire.h
+  #define I2C_BUFFER_LENGTH BUFFER_LENGTH
+
 #else
 
   //The catch-all default is 32
@@ -106,6 +117,13 @@ class MAX30105 {
   uint32_t getFIFOIR(void); //Returns the FIFO sample pointed to by tail
   uint32_t getFIFOGreen(void); //Returns the FIFO sample pointed to by tail
 
+  //Burst FIFO Reading
+  uint8_t readFIFO(uint32_t *redBuffer, uint32_t *irBuffer, uint32_t *greenBuffer, uint8_t maxSamples); //Drains the FIFO into the caller's buffers
+  uint8_t readFIFO(uint16_t *redBuffer, uint16_t *irBuffer, uint16_t *greenBuffer, uint8_t maxSamples); //Same, keeping the lower 16 bits
+  uint8_t getSamplesDrained(void); //Samples read by the last check() or readFIFO()
+  uint32_t getOverflowCount(void); //Samples lost because the FIFO was full
+  void clearOverflowCount(void);
+
   uint8_t getWritePointer(void);
   uint8_t getReadPointer(void);
   void clearFIFO(void); //Sets the read/write pointers to zero
@@ -140,6 +158,13 @@ class MAX30105 {
   void readRevisionID();
 
   void bitMask(uint8_t reg, uint8_t mask, uint8_t thing);
+
+  uint8_t samplesDrained; //Set by check() and readFIFO()
+  uint32_t overflowCount; //Samples the sensor dropped since begin()
+
+  uint8_t readFIFOPointers(uint8_t &overflow); //Returns the number of samples waiting in the FIFO
+  uint32_t readFIFOValue(void); //Returns the next 18 bit value of the current burst
+  uint8_t readFIFOBurst(void *redBuffer, void *irBuffer, void *greenBuffer, uint8_t maxSamples, uint8_t valueSize);
  
    #define STORAGE_SIZE 4 //Each long is 4 bytes so limit this to fit on your micro
   typedef struct Record
@@ -0,0 +1,25 @@
+// Minimal Arduino stand-in for running TinyGPSPlus on a desktop machine.
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ARDUINO 100
+
+typedef uint8_t byte;
+
+#define TWO_PI 6.283185307179586476925286766559
+#define radians(deg) ((deg) * 0.017453292519943295769236907684886)
+#define degrees(rad) ((rad) * 57.295779513082320876798154814105)
+#define sq(x) ((x) * (x))
+
+#define PROGMEM
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+
+unsigned long millis();
+
+#endif
@@ -0,0 +1,303 @@
+// Host benchmark for TinyGPSPlus::encode(): characters per second through
+// the parser, on NMEA log files given on the command line or, without
+// arguments, on a generated hour of a 10 Hz multi-constellation receiver
+// (RMC, VTG, GGA, two GSA, GPS and GLONASS GSV, GLL every epoch, as a
+// u-blox M8 sends them). Then compares distanceBetweenE7() and courseToE7()
+// with the double functions. Build and run with ./run.sh; it first checks
+// the satellites kept from NMEA 4.10 GSV sentences and fails if they're wrong.
+
+#include <chrono>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "../../src/TinyGPS++.h"
+
+#define EPOCHS 36000 // one hour at 10 Hz
+#define RUNS 5
+#define CHUNK 64     // bytes a sketch reads from the UART at a time
+#define PAIRS 200000 // position pairs per distance
+
+static unsigned long now = 0;
+unsigned long millis() { return now; }
+
+static void sentence(std::string &log, const char *body)
+{
+  uint8_t parity = 0;
+  for (const char *p = body; *p; p++)
+    parity ^= (uint8_t)*p;
+  char line[100];
+  snprintf(line, sizeof(line), "$%s*%02X\r\n", body, parity);
+  log += line;
+}
+
+static void ndeg(char *out, size_t size, double value, int degreeDigits)
+{
+  value = fabs(value);
+  int deg = (int)value;
+  snprintf(out, size, "%0*d%08.5f", degreeDigits, deg, (value - deg) * 60);
+}
+
+// A car going round a 2 km circle near Kano at 50 km/h
+static std::string generateLog()
+{
+  std::string log;
+  char body[100], lat[16], lng[16], hms[16];
+  const double speed = 27.0; // knots
+  for (long n = 0; n < EPOCHS; n++)
+  {
+    double t = n / 10.0;
+    double angle = t * speed * 0.514444 / 1000.0;
+    double la = 12.0022 + 0.009 * sin(angle), lo = 8.5920 + 0.0092 * cos(angle);
+    double course = fmod(270 + 360 - fmod(degrees(angle), 360), 360);
+    ndeg(lat, sizeof(lat), la, 2);
+    ndeg(lng, sizeof(lng), lo, 3);
+    long s = (long)t;
+    snprintf(hms, sizeof(hms), "%02ld%02ld%02ld.%02d", 10 + s / 3600, s / 60 % 60, s % 60, (int)(n % 10) * 10);
+
+    snprintf(body, sizeof(body), "GNRMC,%s,A,%s,N,%s,E,%.3f,%.2f,181026,,,A", hms, lat, lng, speed, course);
+    sentence(log, body);
+    snprintf(body, sizeof(body), "GNVTG,%.2f,T,,M,%.3f,N,%.3f,K,A", course, speed, speed * 1.852);
+    sentence(log, body);
+    snprintf(body, sizeof(body), "GNGGA,%s,%s,N,%s,E,1,12,0.81,%.1f,M,16.2,M,,", hms, lat, lng, 476.0 + (n % 50) / 10.0);
+    sentence(log, body);
+    sentence(log, "GNGSA,A,3,02,05,12,13,15,18,20,25,,,,,1.42,0.81,1.17");
+    sentence(log, "GNGSA,A,3,65,66,72,75,,,,,,,,,1.42,0.81,1.17");
+    if (n % 10 == 0) // GSV once a second
+    {
+      sentence(log, "GPGSV,3,1,10,02,35,045,42,05,62,312,45,12,20,105,38,13,48,201,40");
+      sentence(log, "GPGSV,3,2,10,15,10,280,33,18,55,150,44,20,28,075,39,25,15,330,36");
+      sentence(log, "GPGSV,3,3,10,29,05,010,,31,03,250,");
+      sentence(log, "GLGSV,2,1,06,65,40,060,41,66,70,180,43,72,25,300,37,75,12,120,34");
+      sentence(log, "GLGSV,2,2,06,76,04,010,,88,08,210,");
+    }
+    snprintf(body, sizeof(body), "GNGLL,%s,N,%s,E,%s,A,A", lat, lng, hms);
+    sentence(log, body);
+  }
+  return log;
+}
+
+static bool readLog(const char *path, std::string &log)
+{
+  FILE *f = fopen(path, "rb");
+  if (f == NULL)
+    return false;
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    log.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+static void run(const char *name, const std::string &log, bool custom, bool bulk)
+{
+  double best = 1e9;
+  TinyGPSPlus *result = NULL;
+  for (int r = 0; r < RUNS; r++)
+  {
+    delete result;
+    result = new TinyGPSPlus;
+    TinyGPSPlus &gps = *result;
+    // a tracker reading the GSA PDOP and the GSV count the old way
+    TinyGPSCustom gsaPdop, gsvCount;
+    if (custom)
+    {
+      gsaPdop.begin(gps, "GNGSA", 15);
+      gsvCount.begin(gps, "GPGSV", 3);
+    }
+    unsigned sentences = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (bulk)
+    {
+      for (size_t i = 0; i < log.size(); i += CHUNK)
+        sentences += gps.encode(log.data() + i, log.size() - i < CHUNK ? log.size() - i : CHUNK);
+    }
+    else
+    {
+      for (size_t i = 0; i < log.size(); i++)
+        if (gps.encode(log[i]))
+          sentences++;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (elapsed < best)
+      best = elapsed;
+    if (r == RUNS - 1)
+      printf("%-10s %-9s %-9s %8.1f Mchars/s  %7.2f Msentences/s\n", name, bulk ? "buffer" : "per char",
+             custom ? "2 custom" : "no custom", log.size() / best / 1e6, sentences / best / 1e6);
+  }
+
+  TinyGPSPlus &gps = *result;
+  if (!custom && !bulk)
+  {
+    printf("           %lu chars, %lu sentences passed, %lu failed, %lu with fix\n",
+           (unsigned long)gps.charsProcessed(), (unsigned long)gps.passedChecksum(),
+           (unsigned long)gps.failedChecksum(), (unsigned long)gps.sentencesWithFix());
+    printf("           %.6f %.6f  %.1f km/h  %.1f deg  alt %.1f m  %02d:%02d:%02d.%02d\n",
+           gps.location.lat(), gps.location.lng(), gps.speed.kmph(), gps.course.deg(), gps.altitude.meters(),
+           gps.time.hour(), gps.time.minute(), gps.time.second(), gps.time.centisecond());
+    printf("           fix %ldD  pdop %.2f hdop %.2f vdop %.2f  satellites %lu used",
+           (long)gps.fixType.value(), gps.pdop.dop(), gps.hdop.hdop(), gps.vdop.dop(), (unsigned long)gps.satellites.value());
+    printf(", in view GP %u GL %u GA %u GB %u, %u kept\n", gps.satellitesInView.inView(GPS_TALKER_GP),
+           gps.satellitesInView.inView(GPS_TALKER_GL), gps.satellitesInView.inView(GPS_TALKER_GA),
+           gps.satellitesInView.inView(GPS_TALKER_GB), gps.satellitesInView.count());
+  }
+  delete result;
+}
+
+// NMEA 4.10 receivers append a signal ID to GSV; it mustn't become a satellite
+static bool checkGsvSignalId()
+{
+  std::string log;
+  sentence(log, "GPGSV,2,1,06,02,35,045,42,05,62,312,45,12,20,105,38,13,48,201,40,1");
+  sentence(log, "GPGSV,2,2,06,25,40,120,35,29,10,300,,1");
+  TinyGPSPlus gps;
+  for (size_t i = 0; i < log.size(); i++)
+    gps.encode(log[i]);
+  bool ok = gps.passedChecksum() == 2 && gps.satellitesInView.count() == 6;
+  for (uint8_t i = 0; i < gps.satellitesInView.count(); i++)
+    if (gps.satellitesInView[i].prn == 1)
+      ok = false;
+  printf("NMEA 4.10 GSV: %u satellites kept of %u in view: %s\n", gps.satellitesInView.count(),
+         gps.satellitesInView.inView(GPS_TALKER_GP), ok ? "ok" : "FAILED");
+  return ok;
+}
+
+// distanceBetween() as an AVR computes it, where double is a 32 bit float
+static float distanceFloat(float lat1, float long1, float lat2, float long2)
+{
+  float delta = radians(long1 - long2);
+  float sdlong = sinf(delta);
+  float cdlong = cosf(delta);
+  lat1 = radians(lat1);
+  lat2 = radians(lat2);
+  float slat1 = sinf(lat1);
+  float clat1 = cosf(lat1);
+  float slat2 = sinf(lat2);
+  float clat2 = cosf(lat2);
+  delta = (clat1 * slat2) - (slat1 * clat2 * cdlong);
+  delta = sq(delta);
+  delta += sq(clat2 * sdlong);
+  delta = sqrtf(delta);
+  float denom = (slat1 * slat2) + (clat1 * clat2 * cdlong);
+  delta = atan2f(delta, denom);
+  return delta * 6372795;
+}
+
+struct Pair { int32_t lat1, lng1, lat2, lng2; double meters, course; };
+
+// Random pairs up to 80 degrees of latitude, about `range` meters apart
+static std::vector<Pair> pairs(double range)
+{
+  std::vector<Pair> v(PAIRS);
+  for (size_t i = 0; i < v.size(); i++)
+  {
+    Pair &p = v[i];
+    double lat = (rand() / (double)RAND_MAX * 2 - 1) * 80;
+    double lng = (rand() / (double)RAND_MAX * 2 - 1) * 180;
+    double angle = rand() / (double)RAND_MAX * TWO_PI;
+    double d = range * (0.5 + rand() / (double)RAND_MAX) / 111226.0;
+    double lat2 = lat + d * cos(angle);
+    double lng2 = lng + d * sin(angle) / cos(radians(lat));
+    if (lng2 > 180) lng2 -= 360;
+    if (lng2 < -180) lng2 += 360;
+    p.lat1 = lround(lat * 1e7); p.lng1 = lround(lng * 1e7);
+    p.lat2 = lround(lat2 * 1e7); p.lng2 = lround(lng2 * 1e7);
+    p.meters = TinyGPSPlus::distanceBetween(p.lat1 / 1e7, p.lng1 / 1e7, p.lat2 / 1e7, p.lng2 / 1e7);
+    p.course = TinyGPSPlus::courseTo(p.lat1 / 1e7, p.lng1 / 1e7, p.lat2 / 1e7, p.lng2 / 1e7);
+  }
+  return v;
+}
+
+static double courseError(double a, double b)
+{
+  double e = fabs(a - b);
+  return e > 180 ? 360 - e : e;
+}
+
+static void compareDistance()
+{
+  printf("\nlargest error against the double functions, latitudes up to 80 degrees\n");
+  printf("distance   distanceBetweenE7()    courseToE7()   distanceBetween() in float\n");
+  static const double ranges[] = { 10, 100, 1000, 10000, 100000, 1000000 };
+  volatile double sink = 0; // keeps the timed calls
+  std::chrono::steady_clock::time_point start;
+  double doubleTime = 0, intTime = 0;
+  for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++)
+  {
+    std::vector<Pair> v = pairs(ranges[r]);
+    double maxAbs = 0, maxRel = 0, maxCourse = 0, maxFloat = 0;
+    for (size_t i = 0; i < v.size(); i++)
+    {
+      const Pair &p = v[i];
+      double e = fabs(TinyGPSPlus::distanceBetweenE7(p.lat1, p.lng1, p.lat2, p.lng2) - p.meters);
+      if (e > maxAbs) maxAbs = e;
+      if (e / p.meters > maxRel && p.meters >= 1000) maxRel = e / p.meters;
+      if (p.meters > 1)
+      {
+        double c = courseError(TinyGPSPlus::courseToE7(p.lat1, p.lng1, p.lat2, p.lng2) / 100.0, p.course);
+        if (c > maxCourse) maxCourse = c;
+      }
+      double f = fabs(distanceFloat(p.lat1 / 1e7f, p.lng1 / 1e7f, p.lat2 / 1e7f, p.lng2 / 1e7f) - p.meters);
+      if (f > maxFloat) maxFloat = f;
+    }
+    if (ranges[r] < 1000)
+      printf("%7.0f m  %9.2f m           %7.3f deg  %8.1f m\n", ranges[r], maxAbs, maxCourse, maxFloat);
+    else
+      printf("%7.0f m  %9.2f m %6.3f%%  %7.3f deg  %8.1f m\n", ranges[r], maxAbs, maxRel * 100, maxCourse, maxFloat);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < v.size(); i++)
+    {
+      const Pair &p = v[i];
+      sink += TinyGPSPlus::distanceBetween(p.lat1 / 1e7, p.lng1 / 1e7, p.lat2 / 1e7, p.lng2 / 1e7);
+      sink += TinyGPSPlus::courseTo(p.lat1 / 1e7, p.lng1 / 1e7, p.lat2 / 1e7, p.lng2 / 1e7);
+    }
+    doubleTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < v.size(); i++)
+    {
+      const Pair &p = v[i];
+      sink += TinyGPSPlus::distanceBetweenE7(p.lat1, p.lng1, p.lat2, p.lng2);
+      sink += TinyGPSPlus::courseToE7(p.lat1, p.lng1, p.lat2, p.lng2);
+    }
+    intTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  size_t calls = PAIRS * (sizeof(ranges) / sizeof(ranges[0]));
+  printf("distance and course: double %.0f ns, integer %.0f ns per pair\n",
+         doubleTime / calls * 1e9, intTime / calls * 1e9);
+}
+
+int main(int argc, char **argv)
+{
+  if (!checkGsvSignalId())
+    return 1;
+  if (argc < 2)
+  {
+    std::string log = generateLog();
+    printf("generated: %ld epochs at 10 Hz, %lu chars, %lu chars/s of receiver output\n",
+           (long)EPOCHS, (unsigned long)log.size(), (unsigned long)(log.size() / (EPOCHS / 10)));
+    run("generated", log, false, false);
+    run("generated", log, true, false);
+    run("generated", log, false, true);
+    run("generated", log, true, true);
+    compareDistance();
+    return 0;
+  }
+  for (int i = 1; i < argc; i++)
+  {
+    std::string log;
+    if (!readLog(argv[i], log))
+    {
+      printf("%s: can't read\n", argv[i]);
+      return 1;
+    }
+    const char *name = strrchr(argv[i], '/') ? strrchr(argv[i], '/') + 1 : argv[i];
+    run(name, log, false, false);
+    run(name, log, true, false);
+    run(name, log, false, true);
+    run(name, log, true, true);
+  }
+  return 0;
+}
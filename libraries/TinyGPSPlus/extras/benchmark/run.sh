@@ -0,0 +1,8 @@
+#!/bin/sh
+# Builds the benchmark and runs it on a generated 10 Hz log, or on the
+# NMEA log files given as arguments.
+set -e
+dir="$(dirname "$0")"
+g++ -O2 -DARDUINO=100 -I"$dir" -o "$dir/tinygps_benchmark" "$dir/benchmark.cpp" "$dir/../../src/TinyGPS++.cpp"
+"$dir/tinygps_benchmark" "$@"
+rm -f "$dir/tinygps_benchmark"
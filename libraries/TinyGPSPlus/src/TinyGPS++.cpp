@@ -27,15 +27,17 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include <ctype.h>
 #include <stdlib.h>
 
-#define _GPRMCterm   "GPRMC"
-#define _GPGGAterm   "GPGGA"
-#define _GNRMCterm   "GNRMC"
-#define _GNGGAterm   "GNGGA"
+// The address of a sentence is a two letter talker and a three letter
+// sentence id. 5 bits per letter make a perfect hash of the id, so a
+// single switch finds the sentence whatever the talker.
+#define _GPS_ID(a, b, c) (((uint16_t)((a) - 'A') << 10) | ((uint16_t)((b) - 'A') << 5) | (uint16_t)((c) - 'A'))
+#define _GPS_TALKER(a, b) (((uint16_t)(a) << 8) | (uint8_t)(b))
 
 TinyGPSPlus::TinyGPSPlus()
   :  parity(0)
   ,  isChecksumTerm(false)
   ,  curSentenceType(GPS_SENTENCE_OTHER)
+  ,  curTalker(GPS_TALKER_OTHER)
   ,  curTermNumber(0)
   ,  curTermOffset(0)
   ,  sentenceHasFix(false)
@@ -97,6 +99,38 @@ bool TinyGPSPlus::encode(char c)
   return false;
 }
 
+uint16_t TinyGPSPlus::encode(const char *chars, size_t count)
+{
+  uint16_t sentences = 0;
+  const char *end = chars + count;
+
+  while (chars < end)
+  {
+    // Ordinary characters, most of a sentence, go straight into the term
+    // with the parsing state held in locals
+    const char *run = chars;
+    uint8_t offset = curTermOffset;
+    uint8_t runParity = parity;
+    while (chars < end && (uint8_t)*chars > '*' && *chars != ',')
+    {
+      char c = *chars++;
+      if (offset < sizeof(term) - 1)
+        term[offset++] = c;
+      runParity ^= c;
+    }
+    curTermOffset = offset;
+    if (!isChecksumTerm)
+      parity = runParity;
+    encodedCharCount += chars - run;
+
+    // Separators, '$' and the rare odd character
+    if (chars < end && encode(*chars++))
+      ++sentences;
+  }
+
+  return sentences;
+}
+
 //
 // internal utilities
 //
@@ -170,7 +204,7 @@ bool TinyGPSPlus::endOfTermHandler()
 
       switch(curSentenceType)
       {
-      case GPS_SENTENCE_GPRMC:
+      case GPS_SENTENCE_RMC:
         date.commit();
         time.commit();
         if (sentenceHasFix)
@@ -180,7 +214,7 @@ bool TinyGPSPlus::endOfTermHandler()
            course.commit();
         }
         break;
-      case GPS_SENTENCE_GPGGA:
+      case GPS_SENTENCE_GGA:
         time.commit();
         if (sentenceHasFix)
         {
@@ -190,10 +224,31 @@ bool TinyGPSPlus::endOfTermHandler()
         satellites.commit();
         hdop.commit();
         break;
+      case GPS_SENTENCE_GSA:
+        fixType.commit();
+        pdop.commit();
+        hdop.commit();
+        vdop.commit();
+        break;
+      case GPS_SENTENCE_GSV:
+        satellitesInView.commit(curTalker);
+        break;
+      case GPS_SENTENCE_VTG:
+        if (sentenceHasFix)
+        {
+          speed.commit();
+          course.commit();
+        }
+        break;
+      case GPS_SENTENCE_GLL:
+        time.commit();
+        if (sentenceHasFix)
+          location.commit();
+        break;
       }
 
       // Commit all custom listeners of this sentence type
-      for (TinyGPSCustom *p = customCandidates; p != NULL && strcmp(p->sentenceName, customCandidates->sentenceName) == 0; p = p->next)
+      for (TinyGPSCustom *p = customCandidates; p != NULL && sameSentence(p, customCandidates); p = p->next)
          p->commit();
       return true;
     }
@@ -209,78 +264,182 @@ bool TinyGPSPlus::endOfTermHandler()
   // the first term determines the sentence type
   if (curTermNumber == 0)
   {
-    if (!strcmp(term, _GPRMCterm) || !strcmp(term, _GNRMCterm))
-      curSentenceType = GPS_SENTENCE_GPRMC;
-    else if (!strcmp(term, _GPGGAterm) || !strcmp(term, _GNGGAterm))
-      curSentenceType = GPS_SENTENCE_GPGGA;
-    else
-      curSentenceType = GPS_SENTENCE_OTHER;
-
-    // Any custom candidates of this sentence type?
-    for (customCandidates = customElts; customCandidates != NULL && strcmp(customCandidates->sentenceName, term) < 0; customCandidates = customCandidates->next);
-    if (customCandidates != NULL && strcmp(customCandidates->sentenceName, term) > 0)
-       customCandidates = NULL;
-
+    identifySentence();
     return false;
   }
 
-  if (curSentenceType != GPS_SENTENCE_OTHER && term[0])
+  if (curSentenceType == GPS_SENTENCE_GSV)
+  {
+    satellitesInView.set(curTermNumber, term);
+  }
+
+  else if (curSentenceType != GPS_SENTENCE_OTHER && term[0])
     switch(COMBINE(curSentenceType, curTermNumber))
   {
-    case COMBINE(GPS_SENTENCE_GPRMC, 1): // Time in both sentences
-    case COMBINE(GPS_SENTENCE_GPGGA, 1):
+    case COMBINE(GPS_SENTENCE_RMC, 1): // Time in both sentences
+    case COMBINE(GPS_SENTENCE_GGA, 1):
+    case COMBINE(GPS_SENTENCE_GLL, 5):
       time.setTime(term);
       break;
-    case COMBINE(GPS_SENTENCE_GPRMC, 2): // GPRMC validity
+    case COMBINE(GPS_SENTENCE_RMC, 2): // GPRMC validity
+    case COMBINE(GPS_SENTENCE_GLL, 6):
       sentenceHasFix = term[0] == 'A';
       break;
-    case COMBINE(GPS_SENTENCE_GPRMC, 3): // Latitude
-    case COMBINE(GPS_SENTENCE_GPGGA, 2):
+    case COMBINE(GPS_SENTENCE_RMC, 3): // Latitude
+    case COMBINE(GPS_SENTENCE_GGA, 2):
+    case COMBINE(GPS_SENTENCE_GLL, 1):
       location.setLatitude(term);
       break;
-    case COMBINE(GPS_SENTENCE_GPRMC, 4): // N/S
-    case COMBINE(GPS_SENTENCE_GPGGA, 3):
+    case COMBINE(GPS_SENTENCE_RMC, 4): // N/S
+    case COMBINE(GPS_SENTENCE_GGA, 3):
+    case COMBINE(GPS_SENTENCE_GLL, 2):
       location.rawNewLatData.negative = term[0] == 'S';
       break;
-    case COMBINE(GPS_SENTENCE_GPRMC, 5): // Longitude
-    case COMBINE(GPS_SENTENCE_GPGGA, 4):
+    case COMBINE(GPS_SENTENCE_RMC, 5): // Longitude
+    case COMBINE(GPS_SENTENCE_GGA, 4):
+    case COMBINE(GPS_SENTENCE_GLL, 3):
       location.setLongitude(term);
       break;
-    case COMBINE(GPS_SENTENCE_GPRMC, 6): // E/W
-    case COMBINE(GPS_SENTENCE_GPGGA, 5):
+    case COMBINE(GPS_SENTENCE_RMC, 6): // E/W
+    case COMBINE(GPS_SENTENCE_GGA, 5):
+    case COMBINE(GPS_SENTENCE_GLL, 4):
       location.rawNewLngData.negative = term[0] == 'W';
       break;
-    case COMBINE(GPS_SENTENCE_GPRMC, 7): // Speed (GPRMC)
+    case COMBINE(GPS_SENTENCE_RMC, 7): // Speed (GPRMC)
       speed.set(term);
       break;
-    case COMBINE(GPS_SENTENCE_GPRMC, 8): // Course (GPRMC)
+    case COMBINE(GPS_SENTENCE_VTG, 5): // Speed in knots, empty without a fix
+      speed.set(term);
+      sentenceHasFix = true;
+      break;
+    case COMBINE(GPS_SENTENCE_RMC, 8): // Course (GPRMC)
+    case COMBINE(GPS_SENTENCE_VTG, 1): // true course
       course.set(term);
       break;
-    case COMBINE(GPS_SENTENCE_GPRMC, 9): // Date (GPRMC)
+    case COMBINE(GPS_SENTENCE_RMC, 9): // Date (GPRMC)
       date.setDate(term);
       break;
-    case COMBINE(GPS_SENTENCE_GPGGA, 6): // Fix data (GPGGA)
+    case COMBINE(GPS_SENTENCE_GGA, 6): // Fix data (GPGGA)
       sentenceHasFix = term[0] > '0';
       break;
-    case COMBINE(GPS_SENTENCE_GPGGA, 7): // Satellites used (GPGGA)
+    case COMBINE(GPS_SENTENCE_GGA, 7): // Satellites used (GPGGA)
       satellites.set(term);
       break;
-    case COMBINE(GPS_SENTENCE_GPGGA, 8): // HDOP
+    case COMBINE(GPS_SENTENCE_GGA, 8): // HDOP
+    case COMBINE(GPS_SENTENCE_GSA, 16):
       hdop.set(term);
       break;
-    case COMBINE(GPS_SENTENCE_GPGGA, 9): // Altitude (GPGGA)
+    case COMBINE(GPS_SENTENCE_GGA, 9): // Altitude (GPGGA)
       altitude.set(term);
       break;
+    case COMBINE(GPS_SENTENCE_GSA, 2): // Fix type 1/2/3
+      fixType.set(term);
+      sentenceHasFix = term[0] > '1';
+      break;
+    case COMBINE(GPS_SENTENCE_GSA, 15): // PDOP
+      pdop.set(term);
+      break;
+    case COMBINE(GPS_SENTENCE_GSA, 17): // VDOP
+      vdop.set(term);
+      break;
+    case COMBINE(GPS_SENTENCE_VTG, 9): // Mode, N: not valid (NMEA 2.3 and up)
+    case COMBINE(GPS_SENTENCE_GLL, 7):
+      if (term[0] == 'N')
+        sentenceHasFix = false;
+      break;
   }
 
   // Set custom values as needed
-  for (TinyGPSCustom *p = customCandidates; p != NULL && strcmp(p->sentenceName, customCandidates->sentenceName) == 0 && p->termNumber <= curTermNumber; p = p->next)
+  for (TinyGPSCustom *p = customCandidates; p != NULL && p->termNumber <= curTermNumber && sameSentence(p, customCandidates); p = p->next)
     if (p->termNumber == curTermNumber)
          p->set(term);
 
   return false;
 }
 
+// Finds the built-in sentence type and the custom elements of the
+// sentence whose first term has just been read
+void TinyGPSPlus::identifySentence()
+{
+  curSentenceType = GPS_SENTENCE_OTHER;
+  curTalker = GPS_TALKER_OTHER;
+
+  if (curTermOffset == 5)
+  {
+    switch(_GPS_TALKER(term[0], term[1]))
+    {
+    case _GPS_TALKER('G', 'P'): curTalker = GPS_TALKER_GP; break;
+    case _GPS_TALKER('G', 'L'): curTalker = GPS_TALKER_GL; break;
+    case _GPS_TALKER('G', 'A'): curTalker = GPS_TALKER_GA; break;
+    case _GPS_TALKER('G', 'B'):
+    case _GPS_TALKER('B', 'D'): curTalker = GPS_TALKER_GB; break;
+    case _GPS_TALKER('G', 'N'): curTalker = GPS_TALKER_GN; break;
+    }
+
+    if (curTalker != GPS_TALKER_OTHER &&
+        term[2] >= 'A' && term[2] <= 'Z' && term[3] >= 'A' && term[3] <= 'Z' && term[4] >= 'A' && term[4] <= 'Z')
+      switch(_GPS_ID(term[2], term[3], term[4]))
+    {
+      case _GPS_ID('R', 'M', 'C'): curSentenceType = GPS_SENTENCE_RMC; break;
+      case _GPS_ID('G', 'G', 'A'): curSentenceType = GPS_SENTENCE_GGA; break;
+      case _GPS_ID('G', 'S', 'A'): curSentenceType = GPS_SENTENCE_GSA; break;
+      case _GPS_ID('G', 'S', 'V'):
+        curSentenceType = GPS_SENTENCE_GSV;
+        satellitesInView.start();
+        break;
+      case _GPS_ID('V', 'T', 'G'): curSentenceType = GPS_SENTENCE_VTG; break;
+      case _GPS_ID('G', 'L', 'L'): curSentenceType = GPS_SENTENCE_GLL; break;
+    }
+  }
+
+  // Any custom candidates of this sentence type? The list is sorted by
+  // hash, names are only compared when the hashes match.
+  if (customElts == NULL)
+  {
+    customCandidates = NULL;
+    return;
+  }
+  uint32_t hash = hashSentenceName(term);
+  for (customCandidates = customElts; customCandidates != NULL; customCandidates = customCandidates->next)
+  {
+    if (customCandidates->sentenceHash < hash)
+      continue;
+    if (customCandidates->sentenceHash > hash)
+    {
+      customCandidates = NULL;
+      break;
+    }
+    int cmp = strcmp(customCandidates->sentenceName, term);
+    if (cmp == 0)
+      break;
+    if (cmp > 0)
+    {
+      customCandidates = NULL;
+      break;
+    }
+  }
+}
+
+// static
+// FNV-1a, orders the custom elements
+uint32_t TinyGPSPlus::hashSentenceName(const char *name)
+{
+  uint32_t hash = 2166136261UL;
+  while (*name)
+  {
+    hash ^= (uint8_t)*name++;
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+// static
+bool TinyGPSPlus::sameSentence(const TinyGPSCustom *a, const TinyGPSCustom *b)
+{
+  return a->sentenceHash == b->sentenceHash &&
+    (a->sentenceName == b->sentenceName || strcmp(a->sentenceName, b->sentenceName) == 0);
+}
+
 /* static */
 double TinyGPSPlus::distanceBetween(double lat1, double long1, double lat2, double long2)
 {
@@ -334,6 +493,159 @@ const char *TinyGPSPlus::cardinal(double course)
   return directions[direction % 16];
 }
 
+// cos() from 0 to 90.6 degrees in steps of 2^23 1e-7 degrees (0.84 degree), Q15
+static const uint16_t cosTable[] PROGMEM =
+{
+  32768, 32764, 32754, 32736, 32712, 32680, 32642, 32596, 32543, 32484, 32417, 32344,
+  32264, 32176, 32082, 31981, 31873, 31758, 31637, 31508, 31373, 31231, 31083, 30928,
+  30766, 30597, 30422, 30241, 30053, 29859, 29658, 29451, 29237, 29017, 28791, 28559,
+  28321, 28077, 27826, 27570, 27308, 27039, 26766, 26486, 26201, 25910, 25613, 25311,
+  25004, 24691, 24373, 24050, 23721, 23388, 23049, 22706, 22358, 22005, 21647, 21284,
+  20917, 20546, 20170, 19790, 19405, 19016, 18624, 18227, 17826, 17422, 17014, 16602,
+  16186, 15768, 15345, 14920, 14491, 14059, 13624, 13187, 12746, 12303, 11857, 11408,
+  10957, 10504, 10049, 9591, 9131, 8669, 8206, 7741, 7274, 6805, 6335, 5864,
+  5391, 4917, 4442, 3967, 3490, 3013, 2535, 2056, 1577, 1098, 618, 138,
+  0
+};
+
+// atan() from 0 to 1 in steps of 1/32, in 1/100 degree
+static const uint16_t atanTable[] PROGMEM =
+{
+  0, 179, 358, 536, 713, 888, 1062, 1234, 1404, 1571, 1735, 1897, 2056, 2211, 2363, 2511,
+  2657, 2798, 2936, 3070, 3201, 3327, 3451, 3571, 3687, 3800, 3909, 4016, 4119, 4218, 4315, 4409,
+  4500
+};
+
+// Meters per 1e-7 degree of latitude on the sphere of distanceBetween(), Q21
+#define _GPS_METERS_PER_UNIT_Q21 23326UL
+
+static uint16_t cosE7(int32_t latE7)
+{
+  uint32_t a = latE7 < 0 ? -latE7 : latE7;
+  uint16_t i = a >> 23;
+  if (i >= sizeof(cosTable) / sizeof(cosTable[0]) - 1)
+    return 0;
+  uint16_t c0 = pgm_read_word(&cosTable[i]);
+  uint16_t c1 = pgm_read_word(&cosTable[i + 1]);
+  return c0 - (uint16_t)(((uint32_t)(c0 - c1) * ((a >> 11) & 0xFFF)) >> 12);
+}
+
+// t = tan from 0 to 1 in Q15, returns 1/100 degrees
+static uint16_t atanCentidegrees(uint16_t t)
+{
+  uint8_t i = t >> 10;
+  if (i >= 32)
+    return 4500;
+  uint16_t a0 = pgm_read_word(&atanTable[i]);
+  uint16_t a1 = pgm_read_word(&atanTable[i + 1]);
+  return a0 + (uint16_t)(((uint32_t)(a1 - a0) * (t & 0x3FF)) >> 10);
+}
+
+static uint16_t isqrt(uint32_t n)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > n)
+    bit >>= 2;
+  while (bit != 0)
+  {
+    if (n >= root + bit)
+    {
+      n -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+      root >>= 1;
+    bit >>= 2;
+  }
+  return (uint16_t)root;
+}
+
+// Difference of longitudes taken the short way round, in 1e-7 degrees.
+// Only longitudes of opposite signs can be more than 180 degrees apart.
+static int32_t longitudeDifference(int32_t long1, int32_t long2)
+{
+  if ((long1 < 0) == (long2 < 0))
+    return long2 - long1;
+  if (long2 >= 0)
+  {
+    uint32_t east = (uint32_t)long2 - (uint32_t)long1;
+    return east > 1800000000UL ? -(int32_t)(3600000000UL - east) : (int32_t)east;
+  }
+  uint32_t west = (uint32_t)long1 - (uint32_t)long2;
+  return west > 1800000000UL ? (int32_t)(3600000000UL - west) : -(int32_t)west;
+}
+
+// v * q / 32768 without overflow, q at most 32768
+static int32_t mulQ15(int32_t v, uint16_t q)
+{
+  return (v >> 15) * (int32_t)q + (((v & 0x7FFF) * (int32_t)q) >> 15);
+}
+
+// East (x) and north (y) offset from position 1 to position 2 on a plane
+// touching the earth at their middle latitude, in 1e-7 degrees of latitude.
+// Both are scaled down to fit 15 bits, the returned shift scales them back.
+static uint8_t flatOffset(int32_t lat1, int32_t long1, int32_t lat2, int32_t long2, int32_t &x, int32_t &y)
+{
+  x = mulQ15(longitudeDifference(long1, long2), cosE7((lat1 + lat2) / 2));
+  y = lat2 - lat1;
+
+  uint8_t shift = 0;
+  while (x > 32767 || x < -32767 || y > 32767 || y < -32767)
+  {
+    x >>= 1;
+    y >>= 1;
+    ++shift;
+  }
+  return shift;
+}
+
+/* static */
+uint32_t TinyGPSPlus::distanceBetweenE7(int32_t lat1, int32_t long1, int32_t lat2, int32_t long2)
+{
+  int32_t x, y;
+  uint8_t shift = flatOffset(lat1, long1, lat2, long2, x, y);
+  uint32_t r = isqrt((uint32_t)(x * x) + (uint32_t)(y * y));
+  return (r * _GPS_METERS_PER_UNIT_Q21 + (1UL << (20 - shift))) >> (21 - shift);
+}
+
+/* static */
+uint16_t TinyGPSPlus::courseToE7(int32_t lat1, int32_t long1, int32_t lat2, int32_t long2)
+{
+  int32_t x, y;
+  flatOffset(lat1, long1, lat2, long2, x, y);
+  uint32_t ax = x < 0 ? -x : x;
+  uint32_t ay = y < 0 ? -y : y;
+  if (ax == 0 && ay == 0)
+    return 0;
+
+  // angle from north towards the east or west, 0 to 9000
+  uint16_t a;
+  if (ax <= ay)
+    a = atanCentidegrees((ax << 15) / ay);
+  else
+    a = 9000 - atanCentidegrees((ay << 15) / ax);
+
+  int32_t course = a;
+  if (y < 0)
+    course = 18000 - course;
+  if (x < 0)
+    course = 36000 - course;
+
+  // That is the course at the middle. The great circle leaves position 1
+  // closer to the pole by half the longitude difference times sin(latitude).
+  int32_t mid = (lat1 + lat2) / 2;
+  uint16_t s = cosE7(900000000L - (mid < 0 ? -mid : mid));
+  int32_t convergence = mulQ15(longitudeDifference(long1, long2), s) / 200000;
+  course -= mid < 0 ? -convergence : convergence;
+
+  if (course < 0)
+    course += 36000;
+  else if (course >= 36000)
+    course -= 36000;
+  return course;
+}
+
 void TinyGPSLocation::commit()
 {
    rawLatData = rawNewLatData;
@@ -366,6 +678,24 @@ double TinyGPSLocation::lng()
    return rawLngData.negative ? -ret : ret;
 }
 
+int32_t TinyGPSLocation::latE7()
+{
+   updated = false;
+   return toE7(rawLatData);
+}
+
+int32_t TinyGPSLocation::lngE7()
+{
+   updated = false;
+   return toE7(rawLngData);
+}
+
+int32_t TinyGPSLocation::toE7(const RawDegrees &raw)
+{
+   int32_t ret = raw.deg * 10000000L + (raw.billionths + 50) / 100;
+   return raw.negative ? -ret : ret;
+}
+
 void TinyGPSDate::commit()
 {
    date = newDate;
@@ -467,6 +797,7 @@ void TinyGPSCustom::begin(TinyGPSPlus &gps, const char *_sentenceName, int _term
    lastCommitTime = 0;
    updated = valid = false;
    sentenceName = _sentenceName;
+   sentenceHash = TinyGPSPlus::hashSentenceName(_sentenceName);
    termNumber = _termNumber;
    memset(stagingBuffer, '\0', sizeof(stagingBuffer));
    memset(buffer, '\0', sizeof(buffer));
@@ -491,8 +822,15 @@ void TinyGPSPlus::insertCustom(TinyGPSCustom *pElt, const char *sentenceName, in
 {
    TinyGPSCustom **ppelt;
 
+   // sorted by hash, then name, then term number
    for (ppelt = &this->customElts; *ppelt != NULL; ppelt = &(*ppelt)->next)
    {
+      if (pElt->sentenceHash != (*ppelt)->sentenceHash)
+      {
+         if (pElt->sentenceHash < (*ppelt)->sentenceHash)
+            break;
+         continue;
+      }
       int cmp = strcmp(sentenceName, (*ppelt)->sentenceName);
       if (cmp < 0 || (cmp == 0 && termNumber < (*ppelt)->termNumber))
          break;
@@ -501,3 +839,66 @@ void TinyGPSPlus::insertCustom(TinyGPSCustom *pElt, const char *sentenceName, in
    pElt->next = *ppelt;
    *ppelt = pElt;
 }
+
+void TinyGPSSatellitesInView::start()
+{
+   memset(newSats, 0, sizeof(newSats));
+   newTotal = messageNumber = messageCount = lastTerm = 0;
+}
+
+// $--GSV,messages,message number,in view,{prn,elevation,azimuth,snr}x1..4
+void TinyGPSSatellitesInView::set(uint8_t termNumber, const char *term)
+{
+   lastTerm = termNumber;
+   if (termNumber == 1)
+      messageCount = atoi(term);
+   else if (termNumber == 2)
+      messageNumber = atoi(term);
+   else if (termNumber == 3)
+      newTotal = atoi(term);
+   else if (termNumber >= 4 && termNumber < 4 + 4 * 4)
+   {
+      TinyGPSSatellite &sat = newSats[(termNumber - 4) / 4];
+      switch ((termNumber - 4) % 4)
+      {
+      case 0: sat.prn = atoi(term); break;
+      case 1: sat.elevation = atoi(term); break;
+      case 2: sat.azimuth = atoi(term); break;
+      case 3: sat.snr = atoi(term); break;
+      }
+   }
+}
+
+void TinyGPSSatellitesInView::commit(uint8_t talker)
+{
+   if (messageNumber == 0 || messageCount == 0)
+      return;
+
+   // the first message of a group replaces the constellation's satellites
+   if (messageNumber == 1)
+   {
+      uint8_t kept = 0;
+      for (uint8_t i = 0; i < satCount; i++)
+         if (sats[i].talker != talker)
+            sats[kept++] = sats[i];
+      satCount = kept;
+   }
+   total[talker] = newTotal;
+
+   // NMEA 4.10 appends a signal ID after the last block; only blocks whose
+   // four terms were all present are satellites
+   for (uint8_t i = 0; i < 4 && satCount < _GPS_MAX_SATELLITES; i++)
+   {
+      if (newSats[i].prn == 0 || lastTerm < 7 + 4 * i)
+         continue;
+      sats[satCount] = newSats[i];
+      sats[satCount].talker = talker;
+      satCount++;
+   }
+
+   if (messageNumber == messageCount)
+   {
+      lastCommitTime = millis();
+      valid = updated = true;
+   }
+}
@@ -30,8 +30,9 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "WProgram.h"
 #endif
 #include <limits.h>
+#include <string.h>
 
-#define _GPS_VERSION "1.0.2" // software version of this library
+#define _GPS_VERSION "1.2.0" // software version of this library
 #define _GPS_MPH_PER_KNOT 1.15077945
 #define _GPS_MPS_PER_KNOT 0.51444444
 #define _GPS_KMPH_PER_KNOT 1.852
@@ -40,6 +41,27 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #define _GPS_FEET_PER_METER 3.2808399
 #define _GPS_MAX_FIELD_SIZE 15
 
+// Satellites kept from GSV sentences, over all constellations
+#ifndef _GPS_MAX_SATELLITES
+#if defined(__AVR__)
+#define _GPS_MAX_SATELLITES 12
+#else
+#define _GPS_MAX_SATELLITES 32
+#endif
+#endif
+
+// Talkers (constellations), the first two letters of a sentence
+enum
+{
+   GPS_TALKER_OTHER = 0,
+   GPS_TALKER_GP,    // GPS
+   GPS_TALKER_GL,    // GLONASS
+   GPS_TALKER_GA,    // Galileo
+   GPS_TALKER_GB,    // BeiDou, also BD
+   GPS_TALKER_GN,    // combined solution
+   GPS_TALKER_COUNT
+};
+
 struct RawDegrees
 {
    uint16_t deg;
@@ -61,6 +83,8 @@ public:
    const RawDegrees &rawLng()     { updated = false; return rawLngData; }
    double lat();
    double lng();
+   int32_t latE7(); // 1e-7 degrees, no floating point
+   int32_t lngE7();
 
    TinyGPSLocation() : valid(false), updated(false)
    {}
@@ -72,6 +96,7 @@ private:
    void commit();
    void setLatitude(const char *term);
    void setLongitude(const char *term);
+   static int32_t toE7(const RawDegrees &raw);
 };
 
 struct TinyGPSDate
@@ -189,6 +214,55 @@ struct TinyGPSHDOP : TinyGPSDecimal
    double hdop() { return value() / 100.0; }
 };
 
+struct TinyGPSDOP : TinyGPSDecimal
+{
+   double dop() { return value() / 100.0; }
+};
+
+struct TinyGPSSatellite
+{
+   uint8_t prn;
+   int8_t elevation;   // degrees
+   uint16_t azimuth;   // degrees
+   uint8_t snr;        // dB-Hz, 0 if not tracked
+   uint8_t talker;     // GPS_TALKER_xx of the GSV sentence
+};
+
+// Satellites in view from GSV sentences. Each constellation's entries are
+// replaced when its next group of GSV sentences starts; isUpdated() turns
+// true when a group is complete.
+struct TinyGPSSatellitesInView
+{
+   friend class TinyGPSPlus;
+public:
+   bool isValid() const    { return valid; }
+   bool isUpdated() const  { return updated; }
+   uint32_t age() const    { return valid ? millis() - lastCommitTime : (uint32_t)ULONG_MAX; }
+
+   uint8_t count()         { updated = false; return satCount; } // entries, at most _GPS_MAX_SATELLITES
+   const TinyGPSSatellite &operator[](uint8_t index) const { return sats[index]; }
+   uint8_t inView(uint8_t talker) const { return talker < GPS_TALKER_COUNT ? total[talker] : 0; } // as reported
+
+   TinyGPSSatellitesInView() : valid(false), updated(false), satCount(0)
+   {
+      memset(total, 0, sizeof(total));
+   }
+
+private:
+   bool valid, updated;
+   uint32_t lastCommitTime;
+   TinyGPSSatellite sats[_GPS_MAX_SATELLITES];
+   uint8_t satCount;
+   uint8_t total[GPS_TALKER_COUNT];
+
+   // the GSV sentence being parsed
+   TinyGPSSatellite newSats[4];
+   uint8_t newTotal, messageNumber, messageCount, lastTerm;
+   void start();
+   void set(uint8_t termNumber, const char *term);
+   void commit(uint8_t talker);
+};
+
 class TinyGPSPlus;
 class TinyGPSCustom
 {
@@ -211,6 +285,7 @@ private:
    unsigned long lastCommitTime;
    bool valid, updated;
    const char *sentenceName;
+   uint32_t sentenceHash;
    int termNumber;
    friend class TinyGPSPlus;
    TinyGPSCustom *next;
@@ -221,6 +296,7 @@ class TinyGPSPlus
 public:
   TinyGPSPlus();
   bool encode(char c); // process one character received from GPS
+  uint16_t encode(const char *chars, size_t count); // a buffer of characters, returns the sentences that passed
   TinyGPSPlus &operator << (char c) {encode(c); return *this;}
 
   TinyGPSLocation location;
@@ -231,6 +307,9 @@ public:
   TinyGPSAltitude altitude;
   TinyGPSInteger satellites;
   TinyGPSHDOP hdop;
+  TinyGPSInteger fixType;     // GSA: 1 no fix, 2 2D, 3 3D
+  TinyGPSDOP pdop, vdop;      // GSA
+  TinyGPSSatellitesInView satellitesInView; // GSV
 
   static const char *libraryVersion() { return _GPS_VERSION; }
 
@@ -238,22 +317,35 @@ public:
   static double courseTo(double lat1, double long1, double lat2, double long2);
   static const char *cardinal(double course);
 
+  // Integer versions of distanceBetween() (meters) and courseTo() (1/100
+  // degree) for positions in 1e-7 degrees, as latE7() and lngE7() return
+  // them. They treat the earth as flat around the middle of the two
+  // positions. Up to 100 km the distance is within 0.1% plus the rounding
+  // to the meter and the course within 0.05 degree (0.15 under 100 m).
+  // Use the double functions beyond that.
+  static uint32_t distanceBetweenE7(int32_t lat1, int32_t long1, int32_t lat2, int32_t long2);
+  static uint16_t courseToE7(int32_t lat1, int32_t long1, int32_t lat2, int32_t long2);
+
   static int32_t parseDecimal(const char *term);
   static void parseDegrees(const char *term, RawDegrees &deg);
+  static uint32_t hashSentenceName(const char *name);
 
   uint32_t charsProcessed()   const { return encodedCharCount; }
   uint32_t sentencesWithFix() const { return sentencesWithFixCount; }
   uint32_t failedChecksum()   const { return failedChecksumCount; }
   uint32_t passedChecksum()   const { return passedChecksumCount; }
+  uint8_t talker()            const { return curTalker; } // of the last sentence, GPS_TALKER_xx
 
 private:
-  enum {GPS_SENTENCE_GPGGA, GPS_SENTENCE_GPRMC, GPS_SENTENCE_OTHER};
+  enum {GPS_SENTENCE_GGA, GPS_SENTENCE_RMC, GPS_SENTENCE_GSA, GPS_SENTENCE_GSV,
+        GPS_SENTENCE_VTG, GPS_SENTENCE_GLL, GPS_SENTENCE_OTHER};
 
   // parsing state variables
   uint8_t parity;
   bool isChecksumTerm;
   char term[_GPS_MAX_FIELD_SIZE];
   uint8_t curSentenceType;
+  uint8_t curTalker;
   uint8_t curTermNumber;
   uint8_t curTermOffset;
   bool sentenceHasFix;
@@ -273,6 +365,8 @@ private:
   // internal utilities
   int fromHex(char a);
   bool endOfTermHandler();
+  void identifySentence();
+  static bool sameSentence(const TinyGPSCustom *a, const TinyGPSCustom *b);
 };
 
 #endif // def(__TinyGPSPlus_h)
@@ -17,6 +17,13 @@ void ZMPT101B::setSensitivity(float value)
 	sensitivity = value;
 }
 
+/// @brief Get the voltage represented by one ADC step
+/// @return volts per ADC step at the current sensitivity
+float ZMPT101B::getVoltageScale()
+{
+	return ZMPT101B_VREF / ZMPT101B_ADC_SCALE * sensitivity;
+}
+
 /// @brief Calculate zero point
 /// @return zero / center value
 int ZMPT101B::getZeroPoint()
@@ -57,8 +64,165 @@ float ZMPT101B::getRmsVoltage(uint8_t loopCount)
 			measurements_count++;
 		}
 
-		readingVoltage += sqrt(Vsum / measurements_count) / ADC_SCALE * VREF * sensitivity;
+		readingVoltage += sqrt(Vsum / measurements_count) / ZMPT101B_ADC_SCALE * ZMPT101B_VREF * sensitivity;
 	}
 
 	return readingVoltage / loopCount;
 }
+
+/// @brief Calculate root mean square (RMS) of AC voltage from samples that
+/// were already captured, e.g. by a background sampler. The zero point is
+/// taken from the same window, so no extra period is spent measuring it.
+/// @param samples raw ADC readings, ideally covering whole periods
+/// @param count number of samples
+/// @return root mean square (RMS) of AC voltage
+float ZMPT101B::getRmsVoltage(const uint16_t *samples, uint16_t count)
+{
+	if (count == 0)
+		return 0.0f;
+
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < count; i++)
+		sum += samples[i];
+
+	int zeroPoint = sum / count;
+
+	uint64_t Vsum = 0;
+	for (uint16_t i = 0; i < count; i++)
+	{
+		int32_t Vnow = samples[i] - zeroPoint;
+		Vsum += (uint32_t)(Vnow * Vnow);
+	}
+
+	return sqrt((float)Vsum / count) / ZMPT101B_ADC_SCALE * ZMPT101B_VREF * sensitivity;
+}
+
+/// @brief Calculate root mean square (RMS) of AC voltage over an exact
+/// number of cycles. The window starts and ends on rising zero crossings,
+/// so a grid or generator that is off its nominal frequency does not leave
+/// a partial cycle in the result. The line frequency is measured as well,
+/// see getFrequency().
+/// @param cycles number of whole cycles to integrate over
+/// @param timeout maximum time in milliseconds to wait for the crossings
+/// @return root mean square (RMS) of AC voltage, 0 if no crossing was found
+float ZMPT101B::getRmsVoltageSynced(uint8_t cycles, uint16_t timeout)
+{
+	if (zeroPoint < 0)
+		zeroPoint = getZeroPoint();
+
+	uint8_t crossings = 0;
+	bool armed = false;
+	float t_first = 0, t_last = 0;
+
+	int32_t Vnow = 0;
+	int32_t Vsum = 0;
+	uint64_t Vsquares = 0; // (4095 / 2)^2 per sample on a 12-bit ADC
+	uint32_t measurements_count = 0;
+
+	uint32_t t_start = millis();
+	uint32_t t_zero = micros();
+	uint32_t t_prev = t_zero;
+	int previous = analogRead(pin);
+
+	while (millis() - t_start < timeout)
+	{
+		int sample = analogRead(pin);
+		uint32_t t_now = micros();
+
+		if (sample < zeroPoint - ZMPT101B_ZERO_CROSSING_HYSTERESIS)
+		{
+			armed = true;
+		}
+		else if (armed && sample >= zeroPoint)
+		{
+			// Interpolate the crossing between the two samples.
+			armed = false;
+			float t_cross = (t_prev - t_zero) + (float)(zeroPoint - previous) / (sample - previous) * (t_now - t_prev);
+
+			if (crossings == 0)
+				t_first = t_cross;
+			t_last = t_cross;
+
+			if (++crossings > cycles)
+				break;
+		}
+
+		if (crossings > 0)
+		{
+			Vnow = sample - zeroPoint;
+			Vsum += Vnow;
+			Vsquares += (uint32_t)(Vnow * Vnow);
+			measurements_count++;
+		}
+
+		previous = sample;
+		t_prev = t_now;
+	}
+
+	if (measurements_count == 0)
+	{
+		measuredFrequency = 0.0f;
+		return 0.0f;
+	}
+
+	measuredFrequency = crossings > cycles ? cycles * 1000000.0f / (t_last - t_first) : 0.0f;
+
+	// Over whole cycles the mean is the true zero point; keep it for next time.
+	float offset = (float)Vsum / measurements_count;
+	if (crossings > cycles)
+		zeroPoint += lround(offset);
+
+	float variance = (float)Vsquares / measurements_count - offset * offset;
+	return sqrt(variance > 0 ? variance : 0) / ZMPT101B_ADC_SCALE * ZMPT101B_VREF * sensitivity;
+}
+
+/// @brief Calculate root mean square (RMS) of AC voltage from captured
+/// samples, using only the whole cycles between the first and the last
+/// rising zero crossing. Also updates getFrequency().
+/// @param samples raw ADC readings, at least two cycles for a result
+/// @param count number of samples
+/// @param sampleRate sample rate of the readings in Hz
+/// @return root mean square (RMS) of AC voltage
+float ZMPT101B::getRmsVoltageSynced(const uint16_t *samples, uint16_t count, uint16_t sampleRate)
+{
+	measuredFrequency = 0.0f;
+	if (count < 2)
+		return getRmsVoltage(samples, count);
+
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < count; i++)
+		sum += samples[i];
+	int center = sum / count;
+
+	uint16_t first = 0, last = 0, crossings = 0;
+	float position_first = 0, position_last = 0;
+	bool armed = false;
+
+	for (uint16_t i = 1; i < count; i++)
+	{
+		if (samples[i] < center - ZMPT101B_ZERO_CROSSING_HYSTERESIS)
+		{
+			armed = true;
+		}
+		else if (armed && samples[i] >= center)
+		{
+			armed = false;
+			float position = i - 1 + (float)(center - samples[i - 1]) / (samples[i] - samples[i - 1]);
+
+			if (crossings == 0)
+			{
+				first = i;
+				position_first = position;
+			}
+			last = i;
+			position_last = position;
+			crossings++;
+		}
+	}
+
+	if (crossings < 2)
+		return getRmsVoltage(samples, count);
+
+	measuredFrequency = (crossings - 1) * (float)sampleRate / (position_last - position_first);
+	return getRmsVoltage(samples + first, last - first);
+}
@@ -3,31 +3,44 @@
 
 #include <Arduino.h>
 
-#define DEFAULT_FREQUENCY 50.0f
+#define ZMPT101B_DEFAULT_FREQUENCY 50.0f
 #define DEFAULT_SENSITIVITY 500.0f
+#define ZMPT101B_SYNC_TIMEOUT 200
 
 #if defined(AVR)
-	#define ADC_SCALE 1023.0f
-	#define VREF 5.0f
+	#define ZMPT101B_ADC_SCALE 1023.0f
+	#define ZMPT101B_VREF 5.0f
 #elif defined(ESP8266)
-	#define ADC_SCALE 1023.0
-	#define VREF 3.3
+	#define ZMPT101B_ADC_SCALE 1023.0
+	#define ZMPT101B_VREF 3.3
 #elif defined(ESP32)
-	#define ADC_SCALE 4095.0
-	#define VREF 3.3
+	#define ZMPT101B_ADC_SCALE 4095.0
+	#define ZMPT101B_VREF 3.3
 #endif
 
+// Band below the zero point the signal must leave before the next rising
+// crossing counts, so noise around zero is not taken for a new cycle.
+#define ZMPT101B_ZERO_CROSSING_HYSTERESIS (ZMPT101B_ADC_SCALE / 100)
+
 class ZMPT101B
 {
 public:
-	ZMPT101B (uint8_t pin, uint16_t frequency = DEFAULT_FREQUENCY);
+	ZMPT101B (uint8_t pin, uint16_t frequency = ZMPT101B_DEFAULT_FREQUENCY);
 	void     setSensitivity(float value);
 	float 	 getRmsVoltage(uint8_t loopCount = 1);
+	float 	 getRmsVoltage(const uint16_t *samples, uint16_t count);
+	float 	 getRmsVoltageSynced(uint8_t cycles = 1, uint16_t timeout = ZMPT101B_SYNC_TIMEOUT);
+	float 	 getRmsVoltageSynced(const uint16_t *samples, uint16_t count, uint16_t sampleRate);
+	float 	 getFrequency() { return measuredFrequency; }
+	float 	 getVoltageScale();
+	uint8_t  getPin() { return pin; }
 
 private:
 	uint8_t  pin;
 	uint32_t period;
 	float 	 sensitivity = DEFAULT_SENSITIVITY;
+	int 	 zeroPoint = -1;
+	float 	 measuredFrequency = 0.0f;
 	int 	 getZeroPoint();
 };
 
@@ -5,6 +5,7 @@
 #include <NonBlockingDallas.h>
 #include <Adafruit_BMP085.h>
 #include <DHT.h>
+#include <SensorScheduler.h>
 #include <Keypad.h>
 #include <ESPComm.h>
 #include "TDSSensor.h"
@@ -66,6 +67,10 @@ OneWire oneWire3(DS18B3_PIN);
 DallasTemperature dallasTemp3(&oneWire3);
 NonBlockingDallas tempSensor3(&dallasTemp3);
 
+// Reads the DHTs and DS18B20 buses one at a time
+SensorScheduler sensors;
+int8_t dht1Sensor, dht2Sensor;
+
 TDSSensor tds1(TDS1_PIN);
 TDSSensor tds2(TDS2_PIN);
 TDSSensor tds3(TDS3_PIN);
@@ -73,8 +78,6 @@ TDSSensor tds3(TDS3_PIN);
 ESPComm esp(Serial2);
 
 // --- Timers ---
-unsigned long lastDHTRead = 0;
-unsigned long lastDS18Read = 0;
 unsigned long lastBMPRead = 0;
 unsigned long lastAnalogRead = 0;
 unsigned long lastSendUpdate = 0;
@@ -171,6 +174,15 @@ void setup() {
   tempSensor2.onTemperatureChange(handleTemperatureChange2);
   tempSensor3.onTemperatureChange(handleTemperatureChange3);
 
+  dht1Sensor = sensors.add(dht1);
+  dht2Sensor = sensors.add(dht2);
+  sensors.setInterval(dht1Sensor, DHT_INTERVAL);
+  sensors.setInterval(dht2Sensor, DHT_INTERVAL);
+  sensors.setInterval(sensors.add(tempSensor1), DS18_INTERVAL);
+  sensors.setInterval(sensors.add(tempSensor2), DS18_INTERVAL);
+  sensors.setInterval(sensors.add(tempSensor3), DS18_INTERVAL);
+  sensors.begin();
+
   // BMP
   if (!bmp.begin()) {
     lcd.clear();
@@ -211,26 +223,17 @@ void loop() {
   runAutoControl();
   updatePumpTimers(now);
   esp.loop();
-  tempSensor1.update();
-  tempSensor2.update();
-  tempSensor3.update();
+  sensors.update();
   tds1.update();
   tds2.update();
   tds3.update();
   handleKeypad();
 
-  // DHT sensors (non-blocking interval)
-  if (now - lastDHTRead >= DHT_INTERVAL) {
-    lastDHTRead = now;
-    float t1 = dht1.readTemperature();
-    float h1 = dht1.readHumidity();
-    float t2 = dht2.readTemperature();
-    float h2 = dht2.readHumidity();
-    if (!isnan(t1)) dht1Temp = t1;
-    if (!isnan(h1)) dht1Hum = h1;
-    if (!isnan(t2)) dht2Temp = t2;
-    if (!isnan(h2)) dht2Hum = h2;
-  }
+  // DHT sensors (latest good values, NAN until the first one)
+  dht1Temp = sensors.getTemperature(dht1Sensor);
+  dht1Hum = sensors.getHumidity(dht1Sensor);
+  dht2Temp = sensors.getTemperature(dht2Sensor);
+  dht2Hum = sensors.getHumidity(dht2Sensor);
 
   // BMP
   if (now - lastBMPRead >= BMP_INTERVAL) {
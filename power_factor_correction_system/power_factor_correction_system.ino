@@ -1,6 +1,7 @@
 //acs712_30a might be added
 #include <ZMPT101B.h>
-#include <ACS712XX.h>
+#include <ACS712.h>
+#include <MainsPowerMeter.h>
 #include <LiquidCrystal.h>
 //needed calibration variables
 // Calibration values
@@ -11,6 +12,15 @@
 #define TOLERANCE 1.0f
 #define MAX_TOLERANCE_VOLTAGE (ACTUAL_VOLTAGE + TOLERANCE)
 #define MIN_TOLERANCE_VOLTAGE (ACTUAL_VOLTAGE - TOLERANCE)
+//power factor correction
+#define MEASURE_CYCLES 5
+#define PHASE_CALIBRATION 1.5f  // V and I are read one after the other
+#define NO_LOAD_CURRENT 0.10f
+#define TARGET_POWER_FACTOR 0.90f
+#define PF_HYSTERESIS 0.03f     // below target by this much before a stage goes in
+#define LOAD_CHANGE 0.20f       // current change that allows a rejected stage again
+#define CAPACITOR_STAGES 2
+#define SETTLE_TIME 2000
 //others
 #define RELAY_SWITCH_ONE A2
 #define RELAY_SWITCH_TWO A3
@@ -21,14 +31,13 @@ const int rs = 2, en = 3, d4 = 4, d5 = 5, d6 = 6, d7 = 7;
 
 LiquidCrystal lcd (rs, en, d4, d5, d6, d7);
 ZMPT101B voltageSensor(VOLTAGE_PIN, 50.0);
-ACS712XX ACS712(ACS712_05B, CURRENT_PIN);
+ACS712 currentSensor(ACS712_05B, CURRENT_PIN);
+MainsPowerMeter<ZMPT101B, ACS712> powerMeter(voltageSensor, currentSensor, 50.0);
 
-const int currentAnalogIn = A0;
-int mVperAmp = 100;  // use 100 for 20A Module and 66 for 30A Module
-double AcsOffset = 2500;
-double I;
-float calibrated_voltageNow = 0;
-float calibrated_currentNow = 0;
+uint8_t capacitorStages = 0;
+// Stages beyond this made the PF worse at rejectedCurrent
+uint8_t maxUsefulStages = CAPACITOR_STAGES;
+float rejectedCurrent = 0;
 
 void setup() {
   // put your setup code here, to run once:
@@ -42,53 +51,60 @@ void setup() {
   digitalWrite(RELAY_SWITCH_ONE, LOW);
   digitalWrite(RELAY_SWITCH_TWO, LOW);
   //  caliration
+  currentSensor.calibrate();
   calibrateVoltage();
+  powerMeter.setPhaseCalibration(PHASE_CALIBRATION);
   //  user information
   userInfo();
 }
 
 void loop() {
   // put your main code here, to run repeatedly:
-  I = measureCurrent();
+  powerMeter.measure(MEASURE_CYCLES);
+  float powerFactor = fabs(powerMeter.getPowerFactor());
+  float current = powerMeter.getRmsCurrent();
 
-  if ((I >= 0.17) && (I <= 0.24)) {
-    digitalWrite(RELAY_SWITCH_ONE, LOW);
-    digitalWrite(RELAY_SWITCH_TWO, LOW);
+  // A different load may want the stage that was taken out
+  if (maxUsefulStages < CAPACITOR_STAGES && fabs(current - rejectedCurrent) > LOAD_CHANGE * rejectedCurrent) {
+    maxUsefulStages = CAPACITOR_STAGES;
+  }
+
+  if (current < NO_LOAD_CURRENT) {
+    setCapacitorStages(0);
+    maxUsefulStages = CAPACITOR_STAGES;
     lcd.setCursor(0, 0);
-    lcd.print("NO LOAD ");
+    lcd.print("NO LOAD         ");
     lcd.setCursor(0, 1);
     lcd.print("CB DISCONNECTED ");
-  } else if ((I >= 0.77) && (I <= 0.82)) {
-    digitalWrite(RELAY_SWITCH_ONE, LOW);
-    digitalWrite(RELAY_SWITCH_TWO, LOW);
-    lcd.setCursor(0, 0);
-    lcd.print("RESISTIVE LOAD ");
-    lcd.setCursor(0, 1);
-    lcd.print("PF : 0.96 ");
-  } else if ((I >= 0.60) && (I <= 0.68)) {
-    lcd.setCursor(0, 0);
-    lcd.print("R-L LOAD  ");
-    lcd.setCursor(0, 1);
-    lcd.print("PF : 0.69 ");
-    delay(5000);
-    digitalWrite(RELAY_SWITCH_ONE, HIGH);
-    delay(2000);
-    digitalWrite(RELAY_SWITCH_TWO, HIGH);
-    lcd.setCursor(0, 0);
-    lcd.print("CB CONNECTED ");
-    lcd.setCursor(0, 1);
-    lcd.print("PF : 0.98 ");
-    while (!(sensor.getCurrentAC() <= 0.24));
+  } else if (powerFactor < TARGET_POWER_FACTOR - PF_HYSTERESIS && capacitorStages < maxUsefulStages) {
+    showPowerFactor(powerFactor);
+    setCapacitorStages(capacitorStages + 1);
+    delay(SETTLE_TIME);
+
+    // A leading load gets worse with more capacitance, so step back.
+    powerMeter.measure(MEASURE_CYCLES);
+    if (fabs(powerMeter.getPowerFactor()) < powerFactor) {
+      setCapacitorStages(capacitorStages - 1);
+      maxUsefulStages = capacitorStages;
+      rejectedCurrent = current;
+    }
+  } else {
+    showPowerFactor(powerFactor);
   }
   delay(100);
 }
 
-double measureCurrent() {
-  int RawValue = analogRead(CURRENT_PIN);
-  //  double Voltage = (RawValue / 1024.0) * 5000;  // Gets you mV
-  double Voltage = voltageSensor.getRmsVoltage();
-  double Amps = ((Voltage - AcsOffset) / mVperAmp);
-  return Amps;
+void setCapacitorStages(uint8_t stages) {
+  capacitorStages = stages;
+  digitalWrite(RELAY_SWITCH_ONE, stages >= 1 ? HIGH : LOW);
+  digitalWrite(RELAY_SWITCH_TWO, stages >= 2 ? HIGH : LOW);
+}
+
+void showPowerFactor(float powerFactor) {
+  lcd.setCursor(0, 0);
+  lcd.print("P: " + String(powerMeter.getRealPower()) + "W       ");
+  lcd.setCursor(0, 1);
+  lcd.print("PF: " + String(powerFactor) + " CB: " + String(capacitorStages) + "  ");
 }
 
 float calibrateVoltage() {
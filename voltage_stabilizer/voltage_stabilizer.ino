@@ -1,5 +1,7 @@
 #include <ZMPT101B.h>
 #include <LiquidCrystal_I2C.h>
+#include <MainsSampler.h>
+#include <HarmonicAnalyzer.h>
 
 LiquidCrystal_I2C lcd(0x27, 16, 2);
 
@@ -19,6 +21,13 @@ LiquidCrystal_I2C lcd(0x27, 16, 2);
 ZMPT101B inputSensor(INPUT_SENSOR_PIN, 50.0);
 ZMPT101B outputSensor(OUTPUT_SENSOR_PIN, 50.0);
 
+// Distortion of the output voltage
+#define THD_ORDER 7
+MainsSampler sampler;
+HarmonicAnalyzer<64> analyzer;
+HarmonicSpectrum outputSpectrum;
+uint16_t thdWindow[MAINS_SAMPLER_BUFFER_SIZE];
+
 void setRelay(int level) {
   digitalWrite(RELAY1, (level >= 1) ? HIGH : LOW);
   digitalWrite(RELAY2, (level >= 2) ? HIGH : LOW);
@@ -38,6 +47,22 @@ float getAverageVoltage(ZMPT101B &sensor, int samples = 20) {
   return sum / samples;
 }
 
+// --- Function to get the total harmonic distortion in percent ---
+float getThd(ZMPT101B &sensor, HarmonicSpectrum &spectrum) {
+  // Sample in the background just long enough to fill the buffer, then
+  // hand the ADC back to analogRead().
+  if (!sampler.begin(sensor.getPin())) return 0;
+  uint32_t frames = sampler.getFrameCount();
+  while (sampler.getFrameCount() - frames < MAINS_SAMPLER_BUFFER_SIZE) {
+    sampler.update();
+  }
+  uint16_t count = sampler.read(0, thdWindow, MAINS_SAMPLER_BUFFER_SIZE);
+  sampler.end();
+
+  analyzer.analyze(thdWindow, count, sampler.getSampleRate() / 50.0f, sensor.getVoltageScale(), spectrum, THD_ORDER);
+  return 100 * spectrum.thd;
+}
+
 void setup() {
   lcd.init();
   lcd.backlight();
@@ -93,6 +118,7 @@ void loop() {
   // Use averaging for smoother readings
   float inputV = getAverageVoltage(inputSensor, 30);
   float outputV = getAverageVoltage(outputSensor, 20);
+  float outputThd = getThd(outputSensor, outputSpectrum);
 
   // Display values
   lcd.setCursor(0, 0);
@@ -104,6 +130,10 @@ void loop() {
   lcd.print("Out:");
   lcd.print(outputV, 0);
   lcd.print("V   ");
+  lcd.setCursor(9, 1);
+  lcd.print("T");
+  lcd.print(outputThd, 1);
+  lcd.print("% ");
 
   // Relay decision with cumulative logic
   if (inputV >= 80 && inputV < 107) setRelay(1);
@@ -1,6 +1,7 @@
 #include <Wire.h>
 #include <LiquidCrystal_I2C.h>
 #include <Keypad.h>
+#include <KickSort.h>
 
 const byte ROWS = 4;  //four rows
 const byte COLS = 3;  //three columns
@@ -31,6 +32,9 @@ const float tankDepth = 50.0;                  // cm (set to your tank height)
 const float lowLevelThresholdPercent = 30.0;   // below this, pump ON
 const float highLevelThresholdPercent = 70.0;  // above this, pump OFF
 
+// Median of the last readings rejects stray echoes
+KickMedianFilter<float, 5> distanceFilter;
+
 // Track pump state
 bool pumpOn = false;
 
@@ -108,7 +112,7 @@ void setup() {
 }
 
 void loop() {
-  float distance = readUltrasonic();
+  float distance = distanceFilter.filter(readUltrasonic());
 
   // Water level = tankDepth - distanceFromSensor
   float waterLevel = tankDepth - distance;
@@ -123,6 +123,13 @@ void setup() {
 
 void loop() {
   // put your main code here, to run repeatedly:
+  // The DHT is read in the background so SMS bytes are not lost
+  dht.startRead();
+  if (dht.poll() == DHT_READ_OK) {
+    dhtHumidity = dht.readHumidity();
+    dhtTemp = dht.readTemperature();
+  }
+
   char key = keypad.getKey();
   if (key == '#') {
     setPhoneNumber();
@@ -141,8 +148,6 @@ void loop() {
 
   if (millis() - displayChange > 3000) {
     // Read all sensors
-    dhtHumidity = dht.readHumidity();
-    dhtTemp = dht.readTemperature();
     pressure = bmp.readPressure();
     altitude = bmp.readAltitude();
     sensors.requestTemperatures();